@@ -42,6 +42,12 @@ android {
         }
     }
 
+    // Store model weights uncompressed so that they can be mapped straight
+    // from the APK when they are extracted.
+    androidResources {
+        noCompress += listOf("bin")
+    }
+
     defaultConfig {
         applicationId = "com.gokrack.beatriceapp"
         minSdk = 30
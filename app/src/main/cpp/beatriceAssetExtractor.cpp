@@ -0,0 +1,224 @@
+#include "beatriceAssetExtractor.h"
+
+#include <logging_macros.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <utility>
+
+#include "beatriceMappedFile.h"
+
+namespace {
+// Buffer for assets that cannot be mapped.
+constexpr size_t kChunkSize = 64 * 1024;
+constexpr int kFingerprintSamples = 16;
+constexpr size_t kFingerprintSampleSize = 4096;
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+uint64_t fnv1a(uint64_t hash, const uint8_t* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ data[i]) * kFnvPrime;
+  }
+  return hash;
+}
+
+// FNV-1a over the size and kFingerprintSamples evenly spaced pages.
+uint64_t fingerprint(const uint8_t* data, size_t size) {
+  uint64_t hash = fnv1a(kFnvOffsetBasis,
+                        reinterpret_cast<const uint8_t*>(&size), sizeof(size));
+  const size_t sampleSize = std::min(size, kFingerprintSampleSize);
+  for (int i = 0; i < kFingerprintSamples; ++i) {
+    const size_t offset =
+        (size - sampleSize) * i / (kFingerprintSamples - 1);
+    hash = fnv1a(hash, data + offset, sampleSize);
+  }
+  return hash;
+}
+
+int64_t fileSize(const std::string& path) {
+  std::error_code error;
+  const auto size = std::filesystem::file_size(path, error);
+  return error ? -1 : static_cast<int64_t>(size);
+}
+
+// Streams a compressed asset to path. Returns the bytes written.
+int64_t streamAsset(AAsset* asset, const std::string& path) {
+  auto ofs = std::ofstream(path, std::ios::binary | std::ios::trunc);
+  std::array<char, kChunkSize> buffer;
+  int64_t written = 0;
+  while (ofs) {
+    const int bytesRead = AAsset_read(asset, buffer.data(), buffer.size());
+    if (bytesRead < 0) {
+      return -1;
+    }
+    if (bytesRead == 0) {
+      break;
+    }
+    ofs.write(buffer.data(), bytesRead);
+    written += bytesRead;
+  }
+  ofs.close();
+  return ofs ? written : -1;
+}
+}  // namespace
+
+BeatriceAssetExtractor::BeatriceAssetExtractor(AAssetManager* assetManager,
+                                               std::string destinationDir)
+    : mAssetManager(assetManager),
+      mDestinationDir(std::move(destinationDir)) {}
+
+void BeatriceAssetExtractor::add(const std::string& assetPath,
+                                 const std::string& fileName) {
+  mEntries.push_back(Entry{assetPath, fileName});
+}
+
+BeatriceAssetExtractor::Report BeatriceAssetExtractor::run(int maxThreads) {
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<ManifestEntry> manifest = readManifest();
+
+  // Workers take the next entry until none are left.
+  std::atomic<size_t> next{0};
+  auto work = [&]() {
+    for (size_t i = next++; i < mEntries.size(); i = next++) {
+      extract(mEntries[i], manifest);
+    }
+  };
+  const int numThreads =
+      std::clamp(maxThreads, 1, static_cast<int>(mEntries.size()));
+  std::vector<std::thread> threads;
+  for (int i = 1; i < numThreads; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  Report report;
+  for (const auto& entry : mEntries) {
+    std::erase_if(manifest, [&entry](const ManifestEntry& m) {
+      return m.fileName == entry.fileName;
+    });
+    if (entry.isUpToDate || entry.isExtracted) {
+      manifest.push_back({entry.fileName, entry.size, entry.fingerprint});
+      report.upToDate += entry.isUpToDate ? 1 : 0;
+      report.extracted += entry.isExtracted ? 1 : 0;
+      report.bytesWritten += entry.bytesWritten;
+    } else {
+      ++report.failed;
+    }
+  }
+  writeManifest(manifest);
+  mEntries.clear();
+
+  report.milliseconds = std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+  LOGI("Assets: %d extracted (%lld bytes), %d up to date, %d failed in %.1f ms",
+       report.extracted, static_cast<long long>(report.bytesWritten),
+       report.upToDate, report.failed, report.milliseconds);
+  return report;
+}
+
+void BeatriceAssetExtractor::extract(
+    Entry& entry, const std::vector<ManifestEntry>& manifest) {
+  AAsset* asset = AAssetManager_open(mAssetManager, entry.assetPath.c_str(),
+                                     AASSET_MODE_STREAMING);
+  if (!asset) {
+    LOGE("Asset not found: %s", entry.assetPath.c_str());
+    return;
+  }
+
+  // Uncompressed assets can be mapped and fingerprinted.
+  BeatriceMappedFile source;
+  off64_t start = 0;
+  off64_t length = 0;
+  const int fd = AAsset_openFileDescriptor64(asset, &start, &length);
+  if (fd >= 0) {
+    source.map(fd, start, static_cast<size_t>(length));
+    close(fd);
+  }
+  if (source.isOpen()) {
+    entry.size = static_cast<int64_t>(source.size());
+    entry.fingerprint = fingerprint(source.data(), source.size());
+  } else {
+    entry.size = AAsset_getLength64(asset);
+  }
+
+  const std::string path = mDestinationDir + "/" + entry.fileName;
+  const bool isListed = std::any_of(
+      manifest.begin(), manifest.end(), [&entry](const ManifestEntry& m) {
+        return m.fileName == entry.fileName && m.size == entry.size &&
+               m.fingerprint == entry.fingerprint;
+      });
+  if (isListed && fileSize(path) == entry.size) {
+    entry.isUpToDate = true;
+    AAsset_close(asset);
+    return;
+  }
+
+  // Written under a temporary name, so a file with the final name is always
+  // complete.
+  const std::string partPath = path + ".part";
+  bool isVerified = false;
+  if (source.isOpen()) {
+    BeatriceMappedFile written;
+    isVerified = source.copyTo(partPath) && written.open(partPath) &&
+                 written.size() == source.size() &&
+                 fingerprint(written.data(), written.size()) ==
+                     entry.fingerprint;
+  } else {
+    isVerified = streamAsset(asset, partPath) == entry.size &&
+                 fileSize(partPath) == entry.size;
+  }
+  AAsset_close(asset);
+
+  std::error_code error;
+  if (isVerified) {
+    std::filesystem::rename(partPath, path, error);
+  }
+  if (!isVerified || error) {
+    LOGE("Failed to extract %s", entry.assetPath.c_str());
+    std::filesystem::remove(partPath, error);
+    return;
+  }
+  entry.isExtracted = true;
+  entry.bytesWritten = entry.size;
+}
+
+std::vector<BeatriceAssetExtractor::ManifestEntry>
+BeatriceAssetExtractor::readManifest() const {
+  std::vector<ManifestEntry> manifest;
+  std::ifstream ifs(mDestinationDir + "/" + kManifestName);
+  ManifestEntry entry;
+  while (ifs >> entry.fileName >> entry.size >> std::hex >>
+         entry.fingerprint >> std::dec) {
+    manifest.push_back(entry);
+  }
+  return manifest;
+}
+
+void BeatriceAssetExtractor::writeManifest(
+    const std::vector<ManifestEntry>& manifest) const {
+  const std::string path = mDestinationDir + "/" + kManifestName;
+  {
+    std::ofstream ofs(path + ".part", std::ios::trunc);
+    for (const auto& entry : manifest) {
+      ofs << entry.fileName << ' ' << entry.size << ' ' << std::hex
+          << entry.fingerprint << std::dec << '\n';
+    }
+    if (!ofs) {
+      LOGE("Failed to write the asset manifest");
+      return;
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(path + ".part", path, error);
+}
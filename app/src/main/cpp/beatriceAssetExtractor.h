@@ -0,0 +1,79 @@
+#ifndef BEATRICE_ASSET_EXTRACTOR_H
+#define BEATRICE_ASSET_EXTRACTOR_H
+
+#include <android/asset_manager.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Copies APK assets to a directory, in parallel, skipping files that
+ * are already there and current.
+ *
+ * Uncompressed assets are mapped from the APK and written from the mapping;
+ * compressed ones are streamed in fixed-size chunks. Neither is held on the
+ * heap in full.
+ *
+ * A manifest in the directory records the size and a fingerprint of every
+ * asset that was extracted and verified. An asset is skipped when the
+ * manifest still matches it and the file on disk has the recorded size. The
+ * fingerprint hashes a fixed number of pages spread over the file, so that
+ * checking a large weight file costs a few page reads rather than a full
+ * read; compressed assets are checked by size only. After a copy, the
+ * file's size and fingerprint are compared with the asset's.
+ */
+class BeatriceAssetExtractor {
+ public:
+  struct Report {
+    int extracted = 0;
+    int upToDate = 0;
+    int failed = 0;
+    int64_t bytesWritten = 0;
+    double milliseconds = 0.0;
+  };
+
+  static constexpr const char* kManifestName = ".beatrice_assets";
+
+  BeatriceAssetExtractor(AAssetManager* assetManager,
+                         std::string destinationDir);
+
+  /**
+   * @brief Queues assetPath to be extracted as fileName in the directory.
+   */
+  void add(const std::string& assetPath, const std::string& fileName);
+
+  /**
+   * @brief Extracts the queued assets on up to maxThreads threads, updates
+   * the manifest and clears the queue. Logs a summary.
+   */
+  Report run(int maxThreads);
+
+ private:
+  struct Entry {
+    std::string assetPath;
+    std::string fileName;
+    // Filled in by run().
+    int64_t size = -1;
+    uint64_t fingerprint = 0;
+    bool isUpToDate = false;
+    bool isExtracted = false;
+    int64_t bytesWritten = 0;
+  };
+
+  struct ManifestEntry {
+    std::string fileName;
+    int64_t size = 0;
+    uint64_t fingerprint = 0;
+  };
+
+  void extract(Entry& entry, const std::vector<ManifestEntry>& manifest);
+  std::vector<ManifestEntry> readManifest() const;
+  void writeManifest(const std::vector<ManifestEntry>& manifest) const;
+
+  AAssetManager* mAssetManager;
+  std::string mDestinationDir;
+  std::vector<Entry> mEntries;
+};
+
+#endif  // BEATRICE_ASSET_EXTRACTOR_H
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <exception>
+#include <iterator>
 
 void BeatriceAudioEngine::setPlaybackDeviceId(int32_t deviceId) {
   mPlaybackDeviceId = deviceId;
@@ -21,6 +22,19 @@ void BeatriceAudioEngine::setAsyncMode(bool isAsyncMode) {
   mIsAsyncMode = isAsyncMode;
 }
 
+void BeatriceAudioEngine::setBlockSize(int32_t blockSize) {
+  mRequestedBlockSize = blockSize;
+}
+
+void BeatriceAudioEngine::setBufferCount(int32_t bufferCount) {
+  mRequestedBufferCount = bufferCount;
+}
+
+void BeatriceAudioEngine::setProfiler(
+    std::shared_ptr<ProcessingProfiler> profiler) {
+  mProfiler = profiler;
+}
+
 void BeatriceAudioEngine::setVoiceCommunicationMode(
     bool isVoiceCommunicationMode) {
   mIsVoiceCommunicationMode = isVoiceCommunicationMode;
@@ -84,11 +98,11 @@ oboe::Result BeatriceAudioEngine::openStreams(
 
   if (rateP == rateR) {
     mSampleRate = rateP;
-    LOGI("Playback and Recording rates match: %d Hz", mSampleRate);
+    LOGI("Playback and Recording rates match: %d Hz", mSampleRate.load());
   } else {
     mSampleRate = std::min(rateP, rateR);
     LOGI("Sample rates differ (P:%d, R:%d). Using lower rate: %d Hz", rateP,
-         rateR, mSampleRate);
+         rateR, mSampleRate.load());
 
     closeStream(mPlayStream);
     closeStream(mRecordingStream);
@@ -118,9 +132,20 @@ oboe::Result BeatriceAudioEngine::openStreams(
     mAudioEffector->setSampleRate(mSampleRate);
   }
 
-  mLatencyTuner = std::make_shared<oboe::LatencyTuner>(*mPlayStream);
+  mBlockSize = chooseBlockSize(mPlayStream->getFramesPerBurst());
+  mBufferCount = chooseBufferCount();
+  LOGI("Processing block size: %d samples, buffer count: %d", mBlockSize,
+       mBufferCount);
+
+  // mBufferCount is the starting depth; the controller may move it between
+  // the mode's minimum and kMaxBufferCount while the streams run.
+  mLatencyController = std::make_shared<BeatriceLatencyController>(
+      *mRecordingStream, *mPlayStream, mBlockSize, mBufferCount,
+      getMinBufferCount(), kMaxBufferCount, mIsAsyncMode);
   mDuplexStream = std::make_unique<BeatriceFullDuplexPass>(
-      mAudioEffector, mLatencyTuner, mIsAsyncMode, 2);
+      mAudioEffector, mLatencyController, mIsAsyncMode, mBlockSize,
+      mBufferCount, kMaxBufferCount);
+  mDuplexStream->setProfiler(mProfiler);
   mDuplexStream->setSharedInputStream(mRecordingStream);
   mDuplexStream->setSharedOutputStream(mPlayStream);
   mDuplexStream->start();
@@ -136,7 +161,7 @@ void BeatriceAudioEngine::closeStreams() {
   closeStream(mPlayStream);
   closeStream(mRecordingStream);
   mDuplexStream.reset();
-  mLatencyTuner.reset();
+  mLatencyController.reset();
 }
 
 oboe::AudioStreamBuilder* BeatriceAudioEngine::setupRecordingStreamParameters(
@@ -200,6 +225,38 @@ void BeatriceAudioEngine::closeStream(
   }
 }
 
+int32_t BeatriceAudioEngine::chooseBlockSize(int32_t framesPerBurst) const {
+  for (auto blockSize : kSupportedBlockSizes) {
+    if (blockSize == mRequestedBlockSize) {
+      return blockSize;
+    }
+  }
+  if (mRequestedBlockSize != kAutoBlockSize) {
+    LOGW("Unsupported block size %d, choosing one automatically",
+         mRequestedBlockSize);
+  }
+  // The smallest block that holds a whole burst keeps buffering latency low
+  // without splitting every callback into several blocks.
+  for (auto blockSize : kSupportedBlockSizes) {
+    if (blockSize >= framesPerBurst) {
+      return blockSize;
+    }
+  }
+  return std::end(kSupportedBlockSizes)[-1];
+}
+
+int32_t BeatriceAudioEngine::chooseBufferCount() const {
+  int32_t bufferCount = mRequestedBufferCount == kAutoBufferCount
+                            ? kDefaultBufferCount
+                            : mRequestedBufferCount;
+  return std::clamp(bufferCount, getMinBufferCount(), kMaxBufferCount);
+}
+
+int32_t BeatriceAudioEngine::getMinBufferCount() const {
+  // The async worker needs at least one block of slack.
+  return mIsAsyncMode ? 2 : 1;
+}
+
 void BeatriceAudioEngine::warnIfNotLowLatency(
     std::shared_ptr<oboe::AudioStream>& stream) {
   if (stream &&
@@ -239,11 +296,52 @@ void BeatriceAudioEngine::onErrorAfterClose(oboe::AudioStream* oboeStream,
   }
 }
 
-int32_t BeatriceAudioEngine::getSampleRate() const { return mSampleRate; }
+bool BeatriceAudioEngine::isEffectOn() const { return mIsEffectOn.load(); }
+
+int32_t BeatriceAudioEngine::getSampleRate() const {
+  return mSampleRate.load();
+}
 
 int32_t BeatriceAudioEngine::getFramesPerBurst() const {
   if (mPlayStream) {
     return mPlayStream->getFramesPerBurst();
   }
   return 0;
-}
\ No newline at end of file
+}
+
+int32_t BeatriceAudioEngine::getBlockSize() const { return mBlockSize; }
+
+int32_t BeatriceAudioEngine::getBufferCount() const {
+  if (mLatencyController) {
+    return mLatencyController->getTargetDepth();
+  }
+  return mBufferCount;
+}
+
+int32_t BeatriceAudioEngine::getOutputBufferSize() const {
+  if (mLatencyController) {
+    return mLatencyController->getOutputBufferSize();
+  }
+  return 0;
+}
+
+int32_t BeatriceAudioEngine::getEffectorLatency() const {
+  if (mAudioEffector) {
+    return mAudioEffector->getLatencyFrames();
+  }
+  return 0;
+}
+
+uint64_t BeatriceAudioEngine::getOverrunCount() const {
+  if (mDuplexStream) {
+    return mDuplexStream->getOverrunCount();
+  }
+  return 0;
+}
+
+uint64_t BeatriceAudioEngine::getUnderrunCount() const {
+  if (mDuplexStream) {
+    return mDuplexStream->getUnderrunCount();
+  }
+  return 0;
+}
@@ -1,30 +1,52 @@
 #ifndef BEATRICE_AUDIO_ENGINE_H
 #define BEATRICE_AUDIO_ENGINE_H
 
-#include <oboe/LatencyTuner.h>
 #include <oboe/Oboe.h>
 
+#include <atomic>
 #include <functional>
 #include <memory>
 
 #include "beatriceFullDuplexPass.h"
+#include "beatriceLatencyController.h"
 #include "effectors/AudioEffector.hpp"
+#include "effectors/ProcessingProfiler.hpp"
 
 class BeatriceAudioEngine : public oboe::AudioStreamCallback {
  public:
+  // Pass to setBlockSize() / setBufferCount() to derive the value from the
+  // opened streams.
+  static constexpr int32_t kAutoBlockSize = 0;
+  static constexpr int32_t kAutoBufferCount = 0;
+  static constexpr int32_t kSupportedBlockSizes[] = {160, 240, 480, 960};
+  static constexpr int32_t kDefaultBufferCount = 2;
+  static constexpr int32_t kMaxBufferCount = 8;
+
   void setPlaybackDeviceId(int32_t deviceId);
   void setRecordingDeviceId(int32_t deviceId);
   void setVoiceCommunicationMode(bool isVoiceCommunicationMode);
   void setPerformanceMode(oboe::PerformanceMode mode);
   void setAsyncMode(bool isAsyncMode);
+  void setBlockSize(int32_t blockSize);
+  void setBufferCount(int32_t bufferCount);
+  void setProfiler(std::shared_ptr<ProcessingProfiler> profiler);
 
   bool isAAudioRecommended() const;
   bool setAudioApi(oboe::AudioApi api);
   bool setEffectOn(bool isOn,
                    std::shared_ptr<AudioEffector> audioEffector = nullptr);
 
+  // Whether the streams are meant to run; readable from any thread.
+  bool isEffectOn() const;
   int32_t getSampleRate() const;
   int32_t getFramesPerBurst() const;
+  int32_t getBlockSize() const;
+  int32_t getBufferCount() const;
+  int32_t getOutputBufferSize() const;
+  // Delay added by the effectors (e.g. limiter look-ahead), in frames.
+  int32_t getEffectorLatency() const;
+  uint64_t getOverrunCount() const;
+  uint64_t getUnderrunCount() const;
 
   oboe::DataCallbackResult onAudioReady(oboe::AudioStream* oboeStream,
                                         void* audioData,
@@ -49,24 +71,32 @@ class BeatriceAudioEngine : public oboe::AudioStreamCallback {
       int32_t sampleRate = oboe::kUnspecified);
   void closeStream(std::shared_ptr<oboe::AudioStream>& stream);
   void warnIfNotLowLatency(std::shared_ptr<oboe::AudioStream>& stream);
+  int32_t chooseBlockSize(int32_t framesPerBurst) const;
+  int32_t chooseBufferCount() const;
+  int32_t getMinBufferCount() const;
 
-  bool mIsEffectOn = false;
+  std::atomic<bool> mIsEffectOn{false};
   int32_t mRecordingDeviceId = oboe::kUnspecified;
   int32_t mPlaybackDeviceId = oboe::kUnspecified;
   const oboe::AudioFormat mFormat = oboe::AudioFormat::Float;
   oboe::AudioApi mAudioApi = oboe::AudioApi::AAudio;
-  int32_t mSampleRate = oboe::kUnspecified;
+  std::atomic<int32_t> mSampleRate{oboe::kUnspecified};
   const int32_t mInputChannelCount = oboe::ChannelCount::Mono;
   const int32_t mOutputChannelCount = oboe::ChannelCount::Mono;
   oboe::PerformanceMode mPerformanceMode = oboe::PerformanceMode::LowLatency;
   bool mIsAsyncMode = false;
+  int32_t mRequestedBlockSize = kAutoBlockSize;
+  int32_t mRequestedBufferCount = kAutoBufferCount;
+  int32_t mBlockSize = 0;
+  int32_t mBufferCount = 0;
   bool mIsVoiceCommunicationMode = false;
 
   std::unique_ptr<BeatriceFullDuplexPass> mDuplexStream;
   std::shared_ptr<oboe::AudioStream> mRecordingStream;
   std::shared_ptr<oboe::AudioStream> mPlayStream;
-  std::shared_ptr<oboe::LatencyTuner> mLatencyTuner;
+  std::shared_ptr<BeatriceLatencyController> mLatencyController;
   std::shared_ptr<AudioEffector> mAudioEffector;
+  std::shared_ptr<ProcessingProfiler> mProfiler;
 };
 
 #endif  // BEATRICE_AUDIO_ENGINE_H
\ No newline at end of file
@@ -0,0 +1,275 @@
+#ifndef BEATRICE_DUPLEX_CORE_H
+#define BEATRICE_DUPLEX_CORE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#include "beatriceFrameQueue.h"
+#include "effectors/AudioEffector.hpp"
+#include "effectors/ParameterTransport.hpp"
+
+/**
+ * @brief Block-based full-duplex processing, independent of the audio API.
+ *
+ * Re-blocks arbitrary callback sizes into fixed frames of frame_size samples,
+ * runs the effector on each frame either inline (sync) or on a worker thread
+ * (async), and returns the processed frames buffer_count frames later.
+ * BeatriceFullDuplexPass drives it from Oboe callbacks; host backends drive it
+ * directly.
+ *
+ * process() and setTargetDepth() must be called from a single thread (the
+ * audio callback). The counters may be read from any thread.
+ */
+class BeatriceDuplexCore {
+ public:
+  BeatriceDuplexCore(std::shared_ptr<AudioEffector> effector,
+                     bool useAsyncProcessing = false, size_t frame_size = 480,
+                     size_t buffer_count = 2, size_t max_buffer_count = 0)
+      : effector_(effector),
+        useAsyncProcessing_(useAsyncProcessing),
+        frame_size_(std::max<size_t>(frame_size, 1)),
+        output_depth_(std::max<size_t>(buffer_count, 1)),
+        max_depth_(std::max(output_depth_, max_buffer_count)),
+        target_depth_(output_depth_),
+        current_depth_(output_depth_),
+        inputQueue_(frame_size_, max_depth_ + kQueueHeadroom),
+        outputQueue_(frame_size_, max_depth_ + kQueueHeadroom),
+        dropFrame_(std::make_unique<float[]>(frame_size_)),
+        silentFrame_(std::make_unique<float[]>(frame_size_)) {
+    std::fill_n(silentFrame_.get(), frame_size_, 0.0f);
+    // Pre-fill the output with buffer_count frames of silence. Each input
+    // sample then reaches the output buffer_count frames later, and in async
+    // mode the worker has buffer_count - 1 frames of slack per frame.
+    for (size_t i = 0; i < output_depth_; ++i) {
+      std::fill_n(outputQueue_.beginWrite(), frame_size_, 0.0f);
+      outputQueue_.commitWrite();
+    }
+    if (useAsyncProcessing_) {
+      workerThread_ = std::make_unique<std::thread>([this]() { workerLoop(); });
+    }
+  }
+
+  BeatriceDuplexCore(const BeatriceDuplexCore&) = delete;
+  BeatriceDuplexCore& operator=(const BeatriceDuplexCore&) = delete;
+
+  ~BeatriceDuplexCore() {
+    if (workerThread_ && workerThread_->joinable()) {
+      stopRequested_.store(true, std::memory_order_release);
+      wakeWorker();
+      workerThread_->join();
+    }
+  }
+
+  /**
+   * @brief Consumes numSamples mono input samples and produces as many output
+   * samples.
+   */
+  void process(const float* input, float* output, size_t numSamples) {
+    size_t processedSamples = 0;
+    while (processedSamples < numSamples) {
+      if (!inputFrame_) {
+        acquireInputFrame();
+      }
+      if (!outputFrame_) {
+        acquireOutputFrame();
+      }
+
+      // Input and output frames advance in lock step, so one offset serves
+      // both.
+      size_t len =
+          std::min(frame_size_ - frame_offset_, numSamples - processedSamples);
+      std::memcpy(&output[processedSamples], &outputFrame_[frame_offset_],
+                  sizeof(float) * len);
+      std::memcpy(&inputFrame_[frame_offset_], &input[processedSamples],
+                  sizeof(float) * len);
+      frame_offset_ += len;
+      processedSamples += len;
+
+      if (frame_offset_ == frame_size_) {
+        releaseOutputFrame();
+        releaseInputFrame();
+        frame_offset_ = 0;
+      }
+    }
+  }
+
+  /**
+   * @brief Sets the number of frames between input and output. The core moves
+   * towards it by at most one frame per output frame.
+   */
+  void setTargetDepth(size_t depth) {
+    target_depth_ = std::clamp<size_t>(depth, 1, max_depth_);
+  }
+
+  /**
+   * @brief Returns the longest effector run since the previous call and
+   * starts a new measurement window.
+   */
+  int64_t takeMaxProcessingNanos() {
+    return maxProcessingNanos_.exchange(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Number of input frames dropped because the processing side could
+   * not keep up.
+   */
+  uint64_t getOverrunCount() const {
+    return overrunCount_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Number of output frames replaced by silence because no processed
+   * frame was ready in time.
+   */
+  uint64_t getUnderrunCount() const {
+    return underrunCount_.load(std::memory_order_relaxed);
+  }
+
+  size_t getFrameSize() const { return frame_size_; }
+  size_t getBufferCount() const { return output_depth_; }
+
+ private:
+  // Extra queue slots beyond the maximum depth, so that a late worker can
+  // catch up without dropping frames.
+  static constexpr size_t kQueueHeadroom = 2;
+
+  void acquireInputFrame() {
+    inputFrame_ = inputQueue_.beginWrite();
+    if (!inputFrame_) {
+      // The worker is behind: record into a scratch frame and drop it.
+      overrunCount_.fetch_add(1, std::memory_order_relaxed);
+      --current_depth_;
+      inputFrame_ = dropFrame_.get();
+    }
+  }
+
+  void releaseInputFrame() {
+    if (inputFrame_ != dropFrame_.get()) {
+      inputQueue_.commitWrite();
+      if (useAsyncProcessing_) {
+        wakeWorker();
+      } else {
+        processPendingFrames();
+      }
+    }
+    inputFrame_ = nullptr;
+  }
+
+  // current_depth_ counts the frames in flight between input and output.
+  // Underruns and deliberate silence add one, overruns and skips remove one.
+  // Each output frame moves it at most one step towards target_depth_, which
+  // also undoes the extra delay that late frames would otherwise add after an
+  // underrun.
+  void acquireOutputFrame() {
+    if (current_depth_ > target_depth_ && outputQueue_.size() >= 2) {
+      outputQueue_.commitRead();
+      --current_depth_;
+    } else if (current_depth_ < target_depth_) {
+      ++current_depth_;
+      outputFrame_ = silentFrame_.get();
+      return;
+    }
+    outputFrame_ = outputQueue_.beginRead();
+    if (!outputFrame_) {
+      underrunCount_.fetch_add(1, std::memory_order_relaxed);
+      ++current_depth_;
+      outputFrame_ = silentFrame_.get();
+    }
+  }
+
+  void releaseOutputFrame() {
+    if (outputFrame_ != silentFrame_.get()) {
+      outputQueue_.commitRead();
+      if (useAsyncProcessing_) {
+        wakeWorker();
+      }
+    }
+    outputFrame_ = nullptr;
+  }
+
+  // Processes every queued input frame for which an output slot is free.
+  // Called from the audio callback in sync mode and from the worker thread in
+  // async mode; either way it is the only consumer of inputQueue_ and the
+  // only producer of outputQueue_.
+  bool processPendingFrames() {
+    bool processedAny = false;
+    while (const float* input = inputQueue_.beginRead()) {
+      float* output = outputQueue_.beginWrite();
+      if (!output) {
+        break;
+      }
+      const int64_t startNanos = nowNanos();
+      if (effector_) {
+        // Each frame sees a parameter batch either whole or not at all.
+        ParameterBatch::latch();
+        effector_->process(input, output, frame_size_);
+      } else {
+        std::fill_n(output, frame_size_, 0.0f);
+      }
+      recordProcessingTime(nowNanos() - startNanos);
+      outputQueue_.commitWrite();
+      inputQueue_.commitRead();
+      processedAny = true;
+    }
+    return processedAny;
+  }
+
+  void recordProcessingTime(int64_t nanos) {
+    int64_t current = maxProcessingNanos_.load(std::memory_order_relaxed);
+    while (nanos > current &&
+           !maxProcessingNanos_.compare_exchange_weak(
+               current, nanos, std::memory_order_relaxed)) {
+    }
+  }
+
+  void workerLoop() {
+    while (!stopRequested_.load(std::memory_order_acquire)) {
+      const uint32_t sequence = wakeSequence_.load(std::memory_order_acquire);
+      if (!processPendingFrames()) {
+        wakeSequence_.wait(sequence, std::memory_order_acquire);
+      }
+    }
+  }
+
+  static int64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  void wakeWorker() {
+    wakeSequence_.fetch_add(1, std::memory_order_release);
+    wakeSequence_.notify_one();
+  }
+
+  std::shared_ptr<AudioEffector> effector_;
+
+  bool useAsyncProcessing_ = false;
+  const size_t frame_size_;
+  const size_t output_depth_;
+  const size_t max_depth_;
+  size_t target_depth_;
+  size_t current_depth_;
+  size_t frame_offset_ = 0;
+
+  BeatriceFrameQueue inputQueue_;
+  BeatriceFrameQueue outputQueue_;
+  float* inputFrame_ = nullptr;
+  const float* outputFrame_ = nullptr;
+  std::unique_ptr<float[]> dropFrame_;
+  std::unique_ptr<float[]> silentFrame_;
+
+  std::atomic<uint64_t> overrunCount_{0};
+  std::atomic<uint64_t> underrunCount_{0};
+  std::atomic<int64_t> maxProcessingNanos_{0};
+  std::atomic<uint32_t> wakeSequence_{0};
+  std::atomic<bool> stopRequested_{false};
+  std::unique_ptr<std::thread> workerThread_;
+};
+
+#endif  // BEATRICE_DUPLEX_CORE_H
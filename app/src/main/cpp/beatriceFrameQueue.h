@@ -0,0 +1,111 @@
+#ifndef BEATRICE_FRAME_QUEUE_H
+#define BEATRICE_FRAME_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * @brief Wait-free single-producer/single-consumer queue of audio frames.
+ *
+ * All slots are allocated up front, each holding frameSize floats. The
+ * producer writes directly into the slot returned by beginWrite() and
+ * publishes it with commitWrite(); the consumer reads the slot returned by
+ * beginRead() and releases it with commitRead(). No call allocates, locks or
+ * blocks, so both ends may run on a real-time audio thread.
+ *
+ * Head and tail indices live on separate cache lines to avoid false sharing
+ * between the producer and consumer cores.
+ */
+class BeatriceFrameQueue {
+ public:
+  BeatriceFrameQueue(size_t frameSize, size_t capacity)
+      : frameSize_(frameSize),
+        // One extra slot distinguishes "full" from "empty".
+        slotCount_(capacity + 1),
+        frames_(std::make_unique<float[]>(frameSize * (capacity + 1))) {}
+
+  BeatriceFrameQueue(const BeatriceFrameQueue&) = delete;
+  BeatriceFrameQueue& operator=(const BeatriceFrameQueue&) = delete;
+
+  size_t frameSize() const { return frameSize_; }
+  size_t capacity() const { return slotCount_ - 1; }
+
+  /**
+   * @brief Returns the slot to fill next, or nullptr if the queue is full.
+   *
+   * Producer side only.
+   */
+  float* beginWrite() {
+    const size_t tail = tail_.value.load(std::memory_order_relaxed);
+    const size_t next = increment(tail);
+    if (next == head_.value.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return slot(tail);
+  }
+
+  /**
+   * @brief Publishes the slot obtained from beginWrite() to the consumer.
+   *
+   * Producer side only.
+   */
+  void commitWrite() {
+    const size_t tail = tail_.value.load(std::memory_order_relaxed);
+    tail_.value.store(increment(tail), std::memory_order_release);
+  }
+
+  /**
+   * @brief Returns the oldest published slot, or nullptr if the queue is
+   * empty.
+   *
+   * Consumer side only.
+   */
+  const float* beginRead() const {
+    const size_t head = head_.value.load(std::memory_order_relaxed);
+    if (head == tail_.value.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return slot(head);
+  }
+
+  /**
+   * @brief Releases the slot obtained from beginRead() back to the producer.
+   *
+   * Consumer side only.
+   */
+  void commitRead() {
+    const size_t head = head_.value.load(std::memory_order_relaxed);
+    head_.value.store(increment(head), std::memory_order_release);
+  }
+
+  /**
+   * @brief Number of published frames. Only exact when called from one of
+   * the two endpoints while the other is idle.
+   */
+  size_t size() const {
+    const size_t head = head_.value.load(std::memory_order_acquire);
+    const size_t tail = tail_.value.load(std::memory_order_acquire);
+    return tail >= head ? tail - head : tail + slotCount_ - head;
+  }
+
+ private:
+  static constexpr size_t kCacheLineSize = 64;
+
+  struct alignas(kCacheLineSize) PaddedIndex {
+    std::atomic<size_t> value{0};
+  };
+
+  size_t increment(size_t index) const {
+    return index + 1 == slotCount_ ? 0 : index + 1;
+  }
+  float* slot(size_t index) const { return &frames_[index * frameSize_]; }
+
+  const size_t frameSize_;
+  const size_t slotCount_;
+  std::unique_ptr<float[]> frames_;
+  PaddedIndex head_;
+  PaddedIndex tail_;
+};
+
+#endif  // BEATRICE_FRAME_QUEUE_H
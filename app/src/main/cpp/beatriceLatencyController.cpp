@@ -0,0 +1,226 @@
+#include "beatriceLatencyController.h"
+
+#include <logging_macros.h>
+
+#include <algorithm>
+
+namespace {
+constexpr int64_t kNanosPerSecond = 1'000'000'000;
+// Interval and time constant of the glitch rate estimate.
+constexpr int64_t kRateUpdateNanos = kNanosPerSecond;
+constexpr int64_t kRateTimeConstantNanos = 60 * kNanosPerSecond;
+constexpr int32_t kInitialOutputBursts = 2;
+constexpr int64_t kMinSettleNanos = 100'000'000;
+}  // namespace
+
+BeatriceLatencyController::BeatriceLatencyController(
+    oboe::AudioStream& inputStream, oboe::AudioStream& outputStream,
+    int32_t blockSize, int32_t initialDepth, int32_t minDepth,
+    int32_t maxDepth, bool asyncProcessing)
+    : BeatriceLatencyController(inputStream, outputStream, blockSize,
+                                initialDepth, minDepth, maxDepth,
+                                asyncProcessing, Config()) {}
+
+BeatriceLatencyController::BeatriceLatencyController(
+    oboe::AudioStream& inputStream, oboe::AudioStream& outputStream,
+    int32_t blockSize, int32_t initialDepth, int32_t minDepth,
+    int32_t maxDepth, bool asyncProcessing, const Config& config)
+    : mInputStream(inputStream),
+      mOutputStream(outputStream),
+      mConfig(config),
+      mBlockSize(std::max(blockSize, 1)),
+      mMinDepth(std::max(minDepth, 1)),
+      mMaxDepth(std::max(maxDepth, std::max(minDepth, 1))),
+      mFramesPerBurst(std::max(outputStream.getFramesPerBurst(), 1)),
+      mSampleRate(std::max(outputStream.getSampleRate(), 1)),
+      mAsyncProcessing(asyncProcessing),
+      mHoldNanos(config.initialHoldNanos),
+      mTargetDepth(std::clamp(initialDepth, mMinDepth, mMaxDepth)) {
+  mLastInputXRuns = readXRunCount(mInputStream);
+  mLastOutputXRuns = readXRunCount(mOutputStream);
+  setOutputBufferSize(mFramesPerBurst *
+                      std::max(kInitialOutputBursts, mConfig.minOutputBursts));
+}
+
+int32_t BeatriceLatencyController::onCallback(int32_t numFrames,
+                                              int64_t nowNanos,
+                                              uint64_t queueGlitches) {
+  if (mLastCallbackNanos != 0) {
+    const int64_t expectedNanos = framesToNanos(numFrames);
+    const int64_t latenessNanos =
+        nowNanos - mLastCallbackNanos - expectedNanos;
+    mMaxLatenessNanos = std::max(mMaxLatenessNanos, latenessNanos);
+  } else {
+    mLastGlitchNanos = nowNanos;
+    mLastShrinkNanos = nowNanos;
+    mLastRateUpdateNanos = nowNanos;
+  }
+  mLastCallbackNanos = nowNanos;
+
+  const int32_t inputXRuns = readXRunCount(mInputStream);
+  const int32_t outputXRuns = readXRunCount(mOutputStream);
+  const bool streamGlitch =
+      inputXRuns > mLastInputXRuns || outputXRuns > mLastOutputXRuns;
+  const bool queueGlitch = queueGlitches > mLastQueueGlitches;
+  mLastInputXRuns = inputXRuns;
+  mLastOutputXRuns = outputXRuns;
+  mLastQueueGlitches = queueGlitches;
+
+  if (streamGlitch || queueGlitch) {
+    onGlitch(streamGlitch, queueGlitch, nowNanos);
+  } else {
+    tryShrink(nowNanos);
+  }
+
+  const int64_t sinceRateUpdate = nowNanos - mLastRateUpdateNanos;
+  if (sinceRateUpdate >= kRateUpdateNanos) {
+    // Exponential moving average in glitches per minute.
+    const double alpha =
+        std::min(1.0, static_cast<double>(sinceRateUpdate) /
+                          static_cast<double>(kRateTimeConstantNanos));
+    mGlitchesPerMinute += static_cast<double>(mGlitchesSinceRateUpdate) -
+                          mGlitchesPerMinute * alpha;
+    mGlitchesSinceRateUpdate = 0;
+    mLastRateUpdateNanos = nowNanos;
+  }
+
+  return mTargetDepth.load(std::memory_order_relaxed);
+}
+
+void BeatriceLatencyController::reportProcessingTime(int64_t nanos) {
+  int64_t current = mMaxProcessingNanos.load(std::memory_order_relaxed);
+  while (nanos > current &&
+         !mMaxProcessingNanos.compare_exchange_weak(
+             current, nanos, std::memory_order_relaxed)) {
+  }
+}
+
+int32_t BeatriceLatencyController::readXRunCount(
+    oboe::AudioStream& stream) const {
+  // Not every backend reports XRuns; treat that as "no XRuns".
+  auto result = stream.getXRunCount();
+  return result ? result.value() : 0;
+}
+
+bool BeatriceLatencyController::setOutputBufferSize(int32_t frames) {
+  const int32_t current = mOutputBufferSize.load(std::memory_order_relaxed);
+  const int32_t capacity = mOutputStream.getBufferCapacityInFrames();
+  if (capacity > 0) {
+    frames = std::min(frames, capacity);
+  }
+  auto result = mOutputStream.setBufferSizeInFrames(frames);
+  if (!result) {
+    return false;
+  }
+  mOutputBufferSize.store(result.value(), std::memory_order_relaxed);
+  return result.value() != current;
+}
+
+void BeatriceLatencyController::onGlitch(bool streamGlitch, bool queueGlitch,
+                                         int64_t nowNanos) {
+  mGlitchCount.fetch_add(1, std::memory_order_relaxed);
+  ++mGlitchesSinceRateUpdate;
+
+  // A glitch soon after a shrink means that step was one too many: back off
+  // so the next attempt waits longer.
+  if (mLastShrink != Adjustment::None &&
+      nowNanos - mLastShrinkNanos < mHoldNanos) {
+    mHoldNanos = std::min(mHoldNanos * 2, mConfig.maxHoldNanos);
+  }
+  mLastShrink = Adjustment::None;
+  mLastGlitchNanos = nowNanos;
+
+  // One stall usually shows up as glitches in several consecutive callbacks.
+  // Wait until the previous step had a chance to take effect, otherwise a
+  // single hiccup would grow everything to the maximum.
+  if (nowNanos - mLastGrowNanos < settleNanos()) {
+    return;
+  }
+  mLastGrowNanos = nowNanos;
+
+  const int32_t depth = mTargetDepth.load(std::memory_order_relaxed);
+  bool grown = false;
+  if (streamGlitch) {
+    grown = setOutputBufferSize(
+        mOutputBufferSize.load(std::memory_order_relaxed) + mFramesPerBurst);
+  }
+  // Queue glitches mean the processing side missed its deadline; a full
+  // output buffer cannot help there, so add a block of slack instead.
+  if ((queueGlitch || !grown) && depth < mMaxDepth) {
+    mTargetDepth.store(depth + 1, std::memory_order_relaxed);
+    grown = true;
+  }
+  if (grown) {
+    LOGI("Latency controller grew to buffer size %d frames, depth %d blocks",
+         mOutputBufferSize.load(std::memory_order_relaxed),
+         mTargetDepth.load(std::memory_order_relaxed));
+  }
+  resetWindow();
+}
+
+void BeatriceLatencyController::tryShrink(int64_t nowNanos) {
+  if (nowNanos - mLastGlitchNanos < mHoldNanos ||
+      nowNanos - mLastShrinkNanos < mHoldNanos ||
+      mGlitchesPerMinute > mConfig.targetGlitchesPerMinute) {
+    return;
+  }
+
+  // Try the ring depth first: one block is worth several bursts of latency.
+  const int32_t depth = mTargetDepth.load(std::memory_order_relaxed);
+  if (depth > mMinDepth) {
+    // In async mode a depth of d leaves the worker d - 1 blocks to finish a
+    // block. In sync mode processing happens inside the callback, where the
+    // output buffer absorbs it, so the ring depth adds latency only.
+    const int64_t slackNanos = framesToNanos(mBlockSize) * (depth - 2);
+    const int64_t processingNanos =
+        mMaxProcessingNanos.load(std::memory_order_relaxed);
+    if (!mAsyncProcessing ||
+        processingNanos < slackNanos * mConfig.headroomMargin) {
+      mTargetDepth.store(depth - 1, std::memory_order_relaxed);
+      mLastShrink = Adjustment::Depth;
+      mLastShrinkNanos = nowNanos;
+      LOGI("Latency controller shrank depth to %d blocks", depth - 1);
+      resetWindow();
+      return;
+    }
+  }
+
+  const int32_t bufferSize = mOutputBufferSize.load(std::memory_order_relaxed);
+  const int32_t smallerSize = bufferSize - mFramesPerBurst;
+  if (smallerSize >= mFramesPerBurst * mConfig.minOutputBursts) {
+    // Callbacks may be late by at most what is buffered beyond one burst.
+    const int64_t headroomNanos = framesToNanos(smallerSize - mFramesPerBurst);
+    if (mMaxLatenessNanos < headroomNanos * mConfig.headroomMargin &&
+        setOutputBufferSize(smallerSize)) {
+      mLastShrink = Adjustment::OutputBuffer;
+      mLastShrinkNanos = nowNanos;
+      LOGI("Latency controller shrank buffer size to %d frames",
+           mOutputBufferSize.load(std::memory_order_relaxed));
+      resetWindow();
+      return;
+    }
+  }
+
+  // Nothing can shrink yet; look again after another hold period with fresh
+  // measurements.
+  mLastShrink = Adjustment::None;
+  mLastShrinkNanos = nowNanos;
+  resetWindow();
+}
+
+void BeatriceLatencyController::resetWindow() {
+  mMaxLatenessNanos = 0;
+  mMaxProcessingNanos.store(0, std::memory_order_relaxed);
+}
+
+int64_t BeatriceLatencyController::settleNanos() const {
+  // Roughly the time for a frame to travel from input to output.
+  const int64_t latencyNanos =
+      framesToNanos(mOutputBufferSize.load(std::memory_order_relaxed) +
+                    mBlockSize * mTargetDepth.load(std::memory_order_relaxed));
+  return std::max(latencyNanos, kMinSettleNanos);
+}
+
+int64_t BeatriceLatencyController::framesToNanos(int32_t frames) const {
+  return static_cast<int64_t>(frames) * kNanosPerSecond / mSampleRate;
+}
@@ -0,0 +1,125 @@
+#ifndef BEATRICE_LATENCY_CONTROLLER_H
+#define BEATRICE_LATENCY_CONTROLLER_H
+
+#include <oboe/Oboe.h>
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Adaptive latency controller for the full-duplex pass.
+ *
+ * Replaces oboe::LatencyTuner, which only ever grows the output buffer. The
+ * controller runs on the audio callback thread and watches:
+ * - input and output stream XRun counts,
+ * - internal underruns/overruns of the duplex frame queues,
+ * - callback lateness relative to the nominal burst period,
+ * - processing time per block.
+ *
+ * On a glitch it grows the output buffer (stream XRuns) or the internal ring
+ * depth (queue glitches). After a glitch-free hold period, if the measured
+ * lateness and processing time leave enough headroom, it shrinks one of them
+ * by one step. Shrinks that are followed by a glitch double the hold period,
+ * so the controller settles at the lowest latency that stays below the target
+ * glitch rate instead of oscillating.
+ *
+ * onCallback() must only be called from the audio thread. The getters may be
+ * called from any thread.
+ */
+class BeatriceLatencyController {
+ public:
+  struct Config {
+    // Acceptable long-term glitch rate. Shrinking is suspended while the
+    // measured rate is above it.
+    double targetGlitchesPerMinute = 0.5;
+    // Minimum glitch-free time before the first shrink attempt.
+    int64_t initialHoldNanos = 2'000'000'000;
+    // Upper bound for the hold period after repeated failed shrinks.
+    int64_t maxHoldNanos = 60'000'000'000;
+    // Fraction of the smaller configuration's headroom that the observed
+    // worst case may use before a shrink is refused.
+    double headroomMargin = 0.5;
+    int32_t minOutputBursts = 1;
+  };
+
+  BeatriceLatencyController(oboe::AudioStream& inputStream,
+                            oboe::AudioStream& outputStream,
+                            int32_t blockSize, int32_t initialDepth,
+                            int32_t minDepth, int32_t maxDepth,
+                            bool asyncProcessing);
+  BeatriceLatencyController(oboe::AudioStream& inputStream,
+                            oboe::AudioStream& outputStream,
+                            int32_t blockSize, int32_t initialDepth,
+                            int32_t minDepth, int32_t maxDepth,
+                            bool asyncProcessing, const Config& config);
+
+  /**
+   * @brief Updates the controller once per data callback.
+   *
+   * @param numFrames Frames requested by this callback.
+   * @param nowNanos Monotonic timestamp taken at the start of the callback.
+   * @param queueGlitches Total underruns + overruns of the frame queues so far.
+   * @return Ring depth (in blocks) the duplex pass should run at.
+   */
+  int32_t onCallback(int32_t numFrames, int64_t nowNanos,
+                     uint64_t queueGlitches);
+
+  /**
+   * @brief Records the time spent processing one block. Safe to call from
+   * the worker thread.
+   */
+  void reportProcessingTime(int64_t nanos);
+
+  int32_t getTargetDepth() const {
+    return mTargetDepth.load(std::memory_order_relaxed);
+  }
+  int32_t getOutputBufferSize() const {
+    return mOutputBufferSize.load(std::memory_order_relaxed);
+  }
+  uint64_t getGlitchCount() const {
+    return mGlitchCount.load(std::memory_order_relaxed);
+  }
+
+ private:
+  enum class Adjustment { None, OutputBuffer, Depth };
+
+  int32_t readXRunCount(oboe::AudioStream& stream) const;
+  bool setOutputBufferSize(int32_t frames);
+  void onGlitch(bool streamGlitch, bool queueGlitch, int64_t nowNanos);
+  void tryShrink(int64_t nowNanos);
+  void resetWindow();
+  int64_t settleNanos() const;
+  int64_t framesToNanos(int32_t frames) const;
+
+  oboe::AudioStream& mInputStream;
+  oboe::AudioStream& mOutputStream;
+  const Config mConfig;
+  const int32_t mBlockSize;
+  const int32_t mMinDepth;
+  const int32_t mMaxDepth;
+  const int32_t mFramesPerBurst;
+  const int32_t mSampleRate;
+  const bool mAsyncProcessing;
+
+  // Callback-thread state.
+  int32_t mLastInputXRuns = 0;
+  int32_t mLastOutputXRuns = 0;
+  uint64_t mLastQueueGlitches = 0;
+  int64_t mLastCallbackNanos = 0;
+  int64_t mLastGlitchNanos = 0;
+  int64_t mLastShrinkNanos = 0;
+  int64_t mLastGrowNanos = 0;
+  int64_t mLastRateUpdateNanos = 0;
+  int64_t mHoldNanos;
+  int64_t mMaxLatenessNanos = 0;
+  Adjustment mLastShrink = Adjustment::None;
+  double mGlitchesPerMinute = 0.0;
+  uint64_t mGlitchesSinceRateUpdate = 0;
+
+  std::atomic<int64_t> mMaxProcessingNanos{0};
+  std::atomic<int32_t> mTargetDepth;
+  std::atomic<int32_t> mOutputBufferSize{0};
+  std::atomic<uint64_t> mGlitchCount{0};
+};
+
+#endif  // BEATRICE_LATENCY_CONTROLLER_H
@@ -0,0 +1,89 @@
+#include "beatriceMappedFile.h"
+
+#include <fcntl.h>
+#include <logging_macros.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+BeatriceMappedFile::~BeatriceMappedFile() { close(); }
+
+bool BeatriceMappedFile::open(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    LOGE("Failed to open %s: %s", path.c_str(), std::strerror(errno));
+    return false;
+  }
+  struct stat status {};
+  bool success = false;
+  if (fstat(fd, &status) != 0) {
+    LOGE("Failed to stat %s: %s", path.c_str(), std::strerror(errno));
+  } else {
+    success = map(fd, 0, static_cast<size_t>(status.st_size));
+  }
+  ::close(fd);
+  return success;
+}
+
+bool BeatriceMappedFile::map(int fd, off_t offset, size_t length) {
+  close();
+  if (length == 0) {
+    LOGE("Refusing to map an empty region");
+    return false;
+  }
+  const off_t pageSize = sysconf(_SC_PAGESIZE);
+  const off_t alignedOffset = offset - offset % pageSize;
+  const size_t padding = static_cast<size_t>(offset - alignedOffset);
+  void* base = mmap(nullptr, length + padding, PROT_READ, MAP_PRIVATE, fd,
+                    alignedOffset);
+  if (base == MAP_FAILED) {
+    LOGE("Failed to map %zu bytes: %s", length, std::strerror(errno));
+    return false;
+  }
+  mBase = base;
+  mMappedLength = length + padding;
+  mData = static_cast<const uint8_t*>(base) + padding;
+  mSize = length;
+  return true;
+}
+
+void BeatriceMappedFile::close() {
+  if (mBase != nullptr) {
+    munmap(mBase, mMappedLength);
+  }
+  mBase = nullptr;
+  mMappedLength = 0;
+  mData = nullptr;
+  mSize = 0;
+}
+
+void BeatriceMappedFile::prefetch() const {
+  if (mBase != nullptr) {
+    madvise(mBase, mMappedLength, MADV_WILLNEED);
+  }
+}
+
+bool BeatriceMappedFile::copyTo(const std::string& path) const {
+  if (!isOpen()) {
+    return false;
+  }
+  // Read ahead aggressively; pages behind the copy may be dropped early.
+  madvise(mBase, mMappedLength, MADV_SEQUENTIAL);
+  std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+  if (!ofs) {
+    LOGE("Failed to create %s", path.c_str());
+    return false;
+  }
+  ofs.write(reinterpret_cast<const char*>(mData),
+            static_cast<std::streamsize>(mSize));
+  ofs.close();
+  if (!ofs) {
+    LOGE("Failed to write %s", path.c_str());
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,65 @@
+#ifndef BEATRICE_MAPPED_FILE_H
+#define BEATRICE_MAPPED_FILE_H
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief A read-only memory mapping of a file or of a region of one.
+ *
+ * Used for model weights: the pages are file-backed, so they are read on
+ * demand, shared with the page cache and can be dropped again under memory
+ * pressure, where a heap copy would be read in full up front and stay
+ * resident as anonymous memory. A region need not be page-aligned, so an
+ * uncompressed asset inside the APK can be mapped through the descriptor
+ * and offset that AAsset_openFileDescriptor64() returns.
+ *
+ * Errors are logged and reported through the bool results.
+ */
+class BeatriceMappedFile {
+ public:
+  BeatriceMappedFile() = default;
+  ~BeatriceMappedFile();
+  BeatriceMappedFile(const BeatriceMappedFile&) = delete;
+  BeatriceMappedFile& operator=(const BeatriceMappedFile&) = delete;
+
+  /**
+   * @brief Maps a whole file.
+   */
+  bool open(const std::string& path);
+
+  /**
+   * @brief Maps length bytes of fd starting at offset. The mapping stays
+   * valid after fd is closed.
+   */
+  bool map(int fd, off_t offset, size_t length);
+
+  void close();
+
+  /**
+   * @brief Asks the kernel to start reading the pages in (MADV_WILLNEED).
+   */
+  void prefetch() const;
+
+  /**
+   * @brief Writes the mapped bytes to path, replacing it, without an
+   * intermediate heap buffer.
+   */
+  bool copyTo(const std::string& path) const;
+
+  bool isOpen() const { return mData != nullptr; }
+  const uint8_t* data() const { return mData; }
+  size_t size() const { return mSize; }
+
+ private:
+  // The page-aligned mapping around the requested region.
+  void* mBase = nullptr;
+  size_t mMappedLength = 0;
+  const uint8_t* mData = nullptr;
+  size_t mSize = 0;
+};
+
+#endif  // BEATRICE_MAPPED_FILE_H
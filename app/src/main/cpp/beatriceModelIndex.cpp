@@ -0,0 +1,321 @@
+#include "beatriceModelIndex.h"
+
+#include <logging_macros.h>
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+#include "beatriceProcessor.h"
+
+namespace {
+constexpr char kMagic[4] = {'B', 'M', 'I', 'X'};
+// Bump whenever the layout or the indexed metadata changes.
+constexpr uint32_t kFormatVersion = 1;
+
+struct FileStamp {
+  int64_t mtime = 0;
+  int64_t size = -1;
+};
+
+FileStamp stampOf(const std::filesystem::path& path) {
+  std::error_code error;
+  FileStamp stamp;
+  const auto time = std::filesystem::last_write_time(path, error);
+  if (error) {
+    return stamp;
+  }
+  stamp.mtime = time.time_since_epoch().count();
+  if (std::filesystem::is_regular_file(path, error)) {
+    stamp.size = static_cast<int64_t>(std::filesystem::file_size(path, error));
+  } else {
+    stamp.size = 0;
+  }
+  return error ? FileStamp{} : stamp;
+}
+
+BeatriceModelIndex::Model makeModel(const std::string& path,
+                                    const FileStamp& stamp,
+                                    const BeatriceProcessor& processor) {
+  BeatriceModelIndex::Model model;
+  model.path = path;
+  model.mtime = stamp.mtime;
+  model.size = stamp.size;
+  model.version = processor.getModelVersion();
+  model.name = processor.getModelName();
+  model.description = processor.getModelDescription();
+  const auto voiceCount = static_cast<int32_t>(processor.getVoiceCount());
+  for (int32_t i = 0; i < voiceCount; ++i) {
+    model.voices.push_back({processor.getVoiceName(i),
+                            processor.getVoiceDescription(i),
+                            processor.getVoicePortraitPath(i),
+                            processor.getVoicePortraitDescription(i)});
+  }
+  return model;
+}
+
+// Length-prefixed, in native byte order: the index never leaves the
+// device.
+class Writer {
+ public:
+  explicit Writer(std::ofstream& stream) : mStream(stream) {}
+  template <typename T>
+  void write(T value) {
+    mStream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+  template <typename String>
+  void writeString(const String& value) {
+    write(static_cast<uint32_t>(value.size()));
+    mStream.write(reinterpret_cast<const char*>(value.data()),
+                  static_cast<std::streamsize>(value.size()));
+  }
+
+ private:
+  std::ofstream& mStream;
+};
+
+class Reader {
+ public:
+  explicit Reader(std::ifstream& stream) : mStream(stream) {}
+  template <typename T>
+  T read() {
+    T value{};
+    mStream.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return value;
+  }
+  template <typename String>
+  String readString() {
+    const auto size = read<uint32_t>();
+    // Bounds a corrupt length to what the file can still hold.
+    if (!mStream || size > kMaxStringSize) {
+      mStream.setstate(std::ios::failbit);
+      return {};
+    }
+    String value(size, typename String::value_type{});
+    mStream.read(reinterpret_cast<char*>(value.data()), size);
+    return value;
+  }
+  bool isGood() const { return static_cast<bool>(mStream); }
+
+ private:
+  static constexpr uint32_t kMaxStringSize = 1 << 20;
+  std::ifstream& mStream;
+};
+}  // namespace
+
+BeatriceModelIndex::BeatriceModelIndex(std::string rootDir,
+                                       std::string indexPath)
+    : mRootDir(std::move(rootDir)), mIndexPath(std::move(indexPath)) {}
+
+bool BeatriceModelIndex::refresh() {
+  if (!mIsLoaded) {
+    mIsLoaded = true;
+    if (!load()) {
+      mDirectories.clear();
+      mModels.clear();
+    }
+  }
+
+  std::map<std::string, Directory> dirs;
+  std::vector<Model> models;
+  bool changed = false;
+  scan(mRootDir, dirs, models, changed);
+  std::sort(models.begin(), models.end(),
+            [](const Model& a, const Model& b) { return a.path < b.path; });
+  changed = changed || dirs.size() != mDirectories.size() ||
+            models.size() != mModels.size();
+
+  mDirectories = std::move(dirs);
+  mModels = std::move(models);
+  if (changed) {
+    save();
+  }
+  return changed;
+}
+
+void BeatriceModelIndex::update(const std::string& path,
+                                const BeatriceProcessor& processor) {
+  // Models whose TOML is gone, such as one this model replaced, would
+  // otherwise stay listed until the next refresh().
+  const size_t removed = std::erase_if(mModels, [](const Model& model) {
+    return stampOf(model.path).size < 0;
+  });
+  const FileStamp stamp = stampOf(path);
+  if (const Model* model = findModel(path);
+      model && model->mtime == stamp.mtime && model->size == stamp.size) {
+    if (removed > 0) {
+      save();
+    }
+    return;
+  }
+  std::erase_if(mModels,
+                [&path](const Model& model) { return model.path == path; });
+  mModels.push_back(makeModel(path, stamp, processor));
+  std::sort(mModels.begin(), mModels.end(),
+            [](const Model& a, const Model& b) { return a.path < b.path; });
+  save();
+}
+
+void BeatriceModelIndex::scan(const std::string& dir,
+                              std::map<std::string, Directory>& dirs,
+                              std::vector<Model>& models,
+                              bool& changed) const {
+  const FileStamp dirStamp = stampOf(dir);
+  if (dirStamp.size < 0) {
+    return;
+  }
+  Directory directory;
+  if (const auto it = mDirectories.find(dir);
+      it != mDirectories.end() && it->second.mtime == dirStamp.mtime) {
+    directory = it->second;
+  } else {
+    changed = true;
+    directory.mtime = dirStamp.mtime;
+    std::error_code error;
+    for (const auto& entry :
+         std::filesystem::directory_iterator(dir, error)) {
+      if (entry.is_directory(error)) {
+        directory.subdirectories.push_back(entry.path().string());
+      } else if (entry.is_regular_file(error) &&
+                 entry.path().extension() == ".toml") {
+        directory.modelFiles.push_back(entry.path().string());
+      }
+    }
+  }
+
+  for (const auto& path : directory.modelFiles) {
+    const FileStamp stamp = stampOf(path);
+    if (const Model* model = findModel(path);
+        model && model->mtime == stamp.mtime && model->size == stamp.size) {
+      models.push_back(*model);
+      continue;
+    }
+    changed = true;
+    try {
+      // Only parses the TOML; no weights are loaded.
+      const BeatriceProcessor processor(path);
+      models.push_back(makeModel(path, stamp, processor));
+    } catch (const std::exception& e) {
+      LOGW("Skipping model %s: %s", path.c_str(), e.what());
+    }
+  }
+  dirs[dir] = directory;
+  for (const auto& subdirectory : directory.subdirectories) {
+    scan(subdirectory, dirs, models, changed);
+  }
+}
+
+const BeatriceModelIndex::Model* BeatriceModelIndex::findModel(
+    const std::string& path) const {
+  const auto it =
+      std::find_if(mModels.begin(), mModels.end(),
+                   [&path](const Model& model) { return model.path == path; });
+  return it != mModels.end() ? &*it : nullptr;
+}
+
+bool BeatriceModelIndex::load() {
+  std::ifstream stream(mIndexPath, std::ios::binary);
+  if (!stream) {
+    return false;
+  }
+  Reader reader(stream);
+  char magic[sizeof(kMagic)] = {};
+  stream.read(magic, sizeof(magic));
+  if (!std::equal(std::begin(magic), std::end(magic), std::begin(kMagic)) ||
+      reader.read<uint32_t>() != kFormatVersion ||
+      reader.readString<std::string>() != mRootDir) {
+    return false;
+  }
+
+  const auto dirCount = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < dirCount && reader.isGood(); ++i) {
+    auto path = reader.readString<std::string>();
+    Directory& directory = mDirectories[path];
+    directory.mtime = reader.read<int64_t>();
+    const auto subdirectoryCount = reader.read<uint32_t>();
+    for (uint32_t j = 0; j < subdirectoryCount && reader.isGood(); ++j) {
+      directory.subdirectories.push_back(reader.readString<std::string>());
+    }
+    const auto modelFileCount = reader.read<uint32_t>();
+    for (uint32_t j = 0; j < modelFileCount && reader.isGood(); ++j) {
+      directory.modelFiles.push_back(reader.readString<std::string>());
+    }
+  }
+
+  const auto modelCount = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < modelCount && reader.isGood(); ++i) {
+    Model model;
+    model.path = reader.readString<std::string>();
+    model.mtime = reader.read<int64_t>();
+    model.size = reader.read<int64_t>();
+    model.version = reader.read<int32_t>();
+    model.name = reader.readString<std::u8string>();
+    model.description = reader.readString<std::u8string>();
+    const auto voiceCount = reader.read<uint32_t>();
+    for (uint32_t j = 0; j < voiceCount && reader.isGood(); ++j) {
+      Voice voice;
+      voice.name = reader.readString<std::u8string>();
+      voice.description = reader.readString<std::u8string>();
+      voice.portraitPath = reader.readString<std::u8string>();
+      voice.portraitDescription = reader.readString<std::u8string>();
+      model.voices.push_back(std::move(voice));
+    }
+    mModels.push_back(std::move(model));
+  }
+  if (!reader.isGood()) {
+    LOGW("Model index %s is corrupt; rescanning", mIndexPath.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool BeatriceModelIndex::save() const {
+  const std::string partPath = mIndexPath + ".part";
+  {
+    std::ofstream stream(partPath, std::ios::binary | std::ios::trunc);
+    Writer writer(stream);
+    stream.write(kMagic, sizeof(kMagic));
+    writer.write(kFormatVersion);
+    writer.writeString(mRootDir);
+
+    writer.write(static_cast<uint32_t>(mDirectories.size()));
+    for (const auto& [path, directory] : mDirectories) {
+      writer.writeString(path);
+      writer.write(directory.mtime);
+      writer.write(static_cast<uint32_t>(directory.subdirectories.size()));
+      for (const auto& subdirectory : directory.subdirectories) {
+        writer.writeString(subdirectory);
+      }
+      writer.write(static_cast<uint32_t>(directory.modelFiles.size()));
+      for (const auto& modelFile : directory.modelFiles) {
+        writer.writeString(modelFile);
+      }
+    }
+
+    writer.write(static_cast<uint32_t>(mModels.size()));
+    for (const auto& model : mModels) {
+      writer.writeString(model.path);
+      writer.write(model.mtime);
+      writer.write(model.size);
+      writer.write(model.version);
+      writer.writeString(model.name);
+      writer.writeString(model.description);
+      writer.write(static_cast<uint32_t>(model.voices.size()));
+      for (const auto& voice : model.voices) {
+        writer.writeString(voice.name);
+        writer.writeString(voice.description);
+        writer.writeString(voice.portraitPath);
+        writer.writeString(voice.portraitDescription);
+      }
+    }
+    if (!stream) {
+      LOGE("Failed to write the model index %s", mIndexPath.c_str());
+      return false;
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(partPath, mIndexPath, error);
+  return !error;
+}
@@ -0,0 +1,87 @@
+#ifndef BEATRICE_MODEL_INDEX_H
+#define BEATRICE_MODEL_INDEX_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+class BeatriceProcessor;
+
+/**
+ * @brief Persistent index of the models under a directory, with the
+ * metadata the UI shows, so that startup neither walks the whole tree nor
+ * parses every TOML.
+ *
+ * refresh() updates the index incrementally. A directory whose mtime is
+ * unchanged is not listed again, because adding, removing or renaming an
+ * entry changes the mtime of the directory that holds it. A TOML file whose
+ * mtime and size are unchanged is not parsed again. Only the stat() calls
+ * remain. The index is saved whenever it changes; a missing or unreadable
+ * index file only costs a full scan.
+ *
+ * Keep the index file outside the indexed directory, or every save would
+ * change a directory mtime.
+ */
+class BeatriceModelIndex {
+ public:
+  struct Voice {
+    std::u8string name;
+    std::u8string description;
+    // Relative to the model's directory, as in the TOML.
+    std::u8string portraitPath;
+    std::u8string portraitDescription;
+  };
+
+  struct Model {
+    std::string path;
+    int64_t mtime = 0;
+    int64_t size = 0;
+    int32_t version = 0;
+    std::u8string name;
+    std::u8string description;
+    std::vector<Voice> voices;
+  };
+
+  BeatriceModelIndex(std::string rootDir, std::string indexPath);
+
+  /**
+   * @brief Loads the saved index on first use and brings it up to date.
+   *
+   * @return Whether anything changed.
+   */
+  bool refresh();
+
+  /**
+   * @brief Records a model that was just parsed anyway, e.g. to load it,
+   * so that the next refresh() need not parse it again. Also drops the
+   * models whose TOML no longer exists.
+   */
+  void update(const std::string& path, const BeatriceProcessor& processor);
+
+  /**
+   * @brief The indexed models, sorted by path.
+   */
+  const std::vector<Model>& getModels() const { return mModels; }
+
+ private:
+  struct Directory {
+    int64_t mtime = 0;
+    std::vector<std::string> subdirectories;
+    std::vector<std::string> modelFiles;
+  };
+
+  void scan(const std::string& dir, std::map<std::string, Directory>& dirs,
+            std::vector<Model>& models, bool& changed) const;
+  const Model* findModel(const std::string& path) const;
+  bool load();
+  bool save() const;
+
+  const std::string mRootDir;
+  const std::string mIndexPath;
+  bool mIsLoaded = false;
+  std::map<std::string, Directory> mDirectories;
+  std::vector<Model> mModels;
+};
+
+#endif  // BEATRICE_MODEL_INDEX_H
@@ -0,0 +1,135 @@
+#include "beatricePreset.h"
+
+#include <logging_macros.h>
+
+#include <bit>
+
+namespace {
+constexpr uint32_t kMagic = 0x54535042;  // "BPST" read as little-endian
+constexpr int32_t kMaxFilterType = 6;    // FilterType::ALLPASS
+
+class Reader {
+ public:
+  Reader(const uint8_t* data, size_t size) : mData(data), mSize(size) {}
+
+  uint32_t readU32() {
+    if (mSize - mOffset < 4) {
+      mIsGood = false;
+      return 0;
+    }
+    const uint8_t* p = mData + mOffset;
+    mOffset += 4;
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+           static_cast<uint32_t>(p[2]) << 16 |
+           static_cast<uint32_t>(p[3]) << 24;
+  }
+  int32_t readI32() { return static_cast<int32_t>(readU32()); }
+  float readF32() {
+    const uint32_t bits = readU32();
+    // On the bits: -Ofast implies -ffinite-math-only, under which
+    // std::isfinite() is folded to true.
+    if ((bits & 0x7f800000u) == 0x7f800000u) {
+      mIsGood = false;
+      return 0.0f;
+    }
+    return std::bit_cast<float>(bits);
+  }
+
+  bool isGood() const { return mIsGood; }
+  bool isAtEnd() const { return mOffset == mSize; }
+
+ private:
+  const uint8_t* mData;
+  size_t mSize;
+  size_t mOffset = 0;
+  bool mIsGood = true;
+};
+
+bool readBands(Reader& reader,
+               std::vector<BeatricePreset::EqualizerBand>& bands) {
+  const uint32_t count = reader.readU32();
+  if (count > BeatricePreset::kMaxEqualizerBands) {
+    LOGW("Preset has %u equalizer bands", count);
+    return false;
+  }
+  bands.resize(count);
+  for (auto& band : bands) {
+    band.type = reader.readI32();
+    band.frequency = reader.readF32();
+    band.q = reader.readF32();
+    band.gainDb = reader.readF32();
+    if (band.type < 0 || band.type > kMaxFilterType) {
+      LOGW("Preset has equalizer type %d", band.type);
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+bool BeatricePreset::decode(const uint8_t* data, size_t size,
+                            BeatricePreset& preset) {
+  Reader reader(data, size);
+  if (reader.readU32() != kMagic) {
+    LOGW("Preset has no valid header");
+    return false;
+  }
+  if (const uint32_t version = reader.readU32(); version != kVersion) {
+    LOGW("Preset version %u is not supported", version);
+    return false;
+  }
+
+  preset.voiceId = reader.readI32();
+  preset.inputGain = reader.readF32();
+  preset.outputGain = reader.readF32();
+  preset.pitchShift = reader.readF32();
+  preset.formantShift = reader.readF32();
+  preset.vqNumNeighbors = reader.readI32();
+  preset.intonationIntensity = reader.readF32();
+  preset.pitchCorrection = reader.readF32();
+  preset.pitchCorrectionMode = reader.readI32();
+  preset.minSourcePitch = reader.readF32();
+  preset.maxSourcePitch = reader.readF32();
+  // The morphing voice is the one after the last model voice.
+  if (preset.voiceId < 0 ||
+      preset.voiceId > static_cast<int32_t>(kMaxMorphingWeights) ||
+      preset.vqNumNeighbors < 0 || preset.pitchCorrectionMode < 0) {
+    LOGW("Preset has an invalid voice setting");
+    return false;
+  }
+  const uint32_t weightCount = reader.readU32();
+  if (weightCount > kMaxMorphingWeights) {
+    LOGW("Preset has %u morphing weights", weightCount);
+    return false;
+  }
+  preset.morphingWeights.resize(weightCount);
+  for (auto& weight : preset.morphingWeights) {
+    weight = reader.readF32();
+  }
+
+  preset.flags = reader.readU32();
+  preset.amplifierGain = reader.readF32();
+  preset.noiseGateThreshold = reader.readF32();
+  preset.noiseGateRange = reader.readF32();
+  preset.noiseGateAttack = reader.readF32();
+  preset.noiseGateRelease = reader.readF32();
+  preset.compressorThreshold = reader.readF32();
+  preset.compressorRatio = reader.readF32();
+  preset.compressorAttack = reader.readF32();
+  preset.compressorRelease = reader.readF32();
+  preset.compressorMakeupGain = reader.readF32();
+  preset.limiterThreshold = reader.readF32();
+  preset.limiterAttack = reader.readF32();
+  preset.limiterRelease = reader.readF32();
+  preset.limiterLookAhead = reader.readF32();
+  if (!readBands(reader, preset.preEqualizerBands) ||
+      !readBands(reader, preset.postEqualizerBands)) {
+    return false;
+  }
+
+  if (!reader.isGood() || !reader.isAtEnd()) {
+    LOGW("Preset is truncated, oversized or has a non-finite value");
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,101 @@
+#ifndef BEATRICE_PRESET_H
+#define BEATRICE_PRESET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Every user setting of the engine, decoded from the binary preset
+ * format that the app sends in one JNI call.
+ *
+ * The format is little-endian, with 32-bit fields throughout:
+ *
+ *   u32  magic 'BPST', u32 version (kVersion)
+ *   i32  voice ID
+ *   f32  input gain, output gain, pitch shift, formant shift (dB/semitones)
+ *   i32  VQ neighbors
+ *   f32  intonation intensity, pitch correction
+ *   i32  pitch correction mode
+ *   f32  source pitch min, source pitch max
+ *   u32  n, then n x f32 morphing weights (n <= kMaxMorphingWeights)
+ *   u32  enabled flags (Flag)
+ *   f32  amplifier gain
+ *   f32  noise gate threshold, range, attack, release
+ *   f32  compressor threshold, ratio, attack, release, makeup gain
+ *   f32  limiter threshold, attack, release, look-ahead
+ *   u32  n, then n x (i32 type, f32 frequency, f32 Q, f32 gain): pre-EQ
+ *   u32  n, then n x (i32 type, f32 frequency, f32 Q, f32 gain): post-EQ
+ *
+ * EQ types follow FilterType; at most kMaxEqualizerBands bands each. The
+ * layout must match PresetManager.encode() on the Kotlin side.
+ */
+struct BeatricePreset {
+  static constexpr uint32_t kVersion = 1;
+  static constexpr uint32_t kMaxMorphingWeights = 256;
+  static constexpr uint32_t kMaxEqualizerBands = 8;
+
+  enum Flag : uint32_t {
+    kAmplifierEnabled = 1u << 0,
+    kRNNoiseEnabled = 1u << 1,
+    kNoiseGateEnabled = 1u << 2,
+    kCompressorEnabled = 1u << 3,
+    kLimiterEnabled = 1u << 4,
+    kPreEqualizerEnabled = 1u << 5,
+    kPostEqualizerEnabled = 1u << 6,
+  };
+
+  struct EqualizerBand {
+    int32_t type = 0;
+    float frequency = 1000.0f;
+    float q = 1.0f;
+    float gainDb = 0.0f;
+  };
+
+  int32_t voiceId = 0;
+  float inputGain = 0.0f;
+  float outputGain = 0.0f;
+  float pitchShift = 0.0f;
+  float formantShift = 0.0f;
+  int32_t vqNumNeighbors = 0;
+  float intonationIntensity = 1.0f;
+  float pitchCorrection = 0.0f;
+  int32_t pitchCorrectionMode = 0;
+  float minSourcePitch = 0.0f;
+  float maxSourcePitch = 0.0f;
+  std::vector<float> morphingWeights;
+
+  uint32_t flags = 0;
+  float amplifierGain = 0.0f;
+  float noiseGateThreshold = 0.0f;
+  float noiseGateRange = 0.0f;
+  float noiseGateAttack = 0.0f;
+  float noiseGateRelease = 0.0f;
+  float compressorThreshold = 0.0f;
+  float compressorRatio = 1.0f;
+  float compressorAttack = 0.0f;
+  float compressorRelease = 0.0f;
+  float compressorMakeupGain = 0.0f;
+  float limiterThreshold = 0.0f;
+  float limiterAttack = 0.0f;
+  float limiterRelease = 0.0f;
+  float limiterLookAhead = 0.0f;
+  std::vector<EqualizerBand> preEqualizerBands;
+  std::vector<EqualizerBand> postEqualizerBands;
+
+  bool isEnabled(Flag flag) const { return (flags & flag) != 0; }
+
+  /**
+   * @brief Decodes and validates a preset.
+   *
+   * Rejects, with a warning, a wrong magic or version, a size that does not
+   * match the layout exactly, non-finite values and out-of-range counts,
+   * IDs and types. Values are otherwise left for the setters to clamp.
+   *
+   * @return False if the data is not a valid preset; preset is then
+   * unspecified.
+   */
+  static bool decode(const uint8_t* data, size_t size, BeatricePreset& preset);
+};
+
+#endif  // BEATRICE_PRESET_H
@@ -5,7 +5,11 @@
 #include <common/processor_core_2.h>
 #include <logging_macros.h>
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <stdexcept>
+#include <utility>
 
 #include "toml11/single_include/toml.hpp"
 
@@ -20,6 +24,13 @@ std::array<float, kMaxNSpeakers> zeroUnusedWeights(
   }
   return result;
 }
+
+// Format version 2 mixes at most this many voices.
+constexpr size_t kMaxMorphedVoices = 8;
+
+float dbToLinear(double db) {
+  return static_cast<float>(std::pow(10.0, db / 20.0));
+}
 }  // namespace
 
 BeatriceProcessor::BeatriceProcessor(const std::string& toml_path_str) {
@@ -77,12 +88,18 @@ BeatriceProcessor::createProcessorCore(int32_t sampleRate) {
     throw std::runtime_error("Failed to load model");
   }
 
+  mInputGain.setSampleRate(static_cast<float>(sampleRate));
+  mOutputGain.setSampleRate(static_cast<float>(sampleRate));
   applyParametersToCore();
   return mBeatriceProcessorCore;
 }
 
 void BeatriceProcessor::resetProcessorCore() { mBeatriceProcessorCore.reset(); }
 
+std::string BeatriceProcessor::getModelPath() const {
+  return mBeatriceModelPath.string();
+}
+
 std::u8string BeatriceProcessor::getModelName() const {
   return mBeatriceModelConfig.model.name;
 }
@@ -101,14 +118,7 @@ void BeatriceProcessor::setVoiceID(int32_t voiceID) {
     return;
   }
   mBeatriceParameters.targetSpeaker = voiceID;
-
-  if (mBeatriceProcessorCore) {
-    mBeatriceProcessorCore->SetTargetSpeaker(mBeatriceParameters.targetSpeaker);
-    mBeatriceProcessorCore->SetAverageSourcePitch(
-        mBeatriceParameters
-            .averageTargetPitchBase[mBeatriceParameters.targetSpeaker] -
-        mBeatriceParameters.pitchShift);
-  }
+  publishParameters();
 }
 
 std::u8string BeatriceProcessor::getVoiceName(int32_t voiceID) const {
@@ -184,103 +194,59 @@ std::u8string BeatriceProcessor::getVoicePortraitDescription(
 
 void BeatriceProcessor::setPitchShift(double pitchShift) {
   mBeatriceParameters.pitchShift = pitchShift;
-
-  if (mBeatriceProcessorCore) {
-    mBeatriceProcessorCore->SetPitchShift(mBeatriceParameters.pitchShift);
-    mBeatriceProcessorCore->SetAverageSourcePitch(
-        mBeatriceParameters
-            .averageTargetPitchBase[mBeatriceParameters.targetSpeaker] -
-        mBeatriceParameters.pitchShift);
-  }
+  publishParameters();
 }
 
 void BeatriceProcessor::setFormantShift(double formantShift) {
   mBeatriceParameters.formantShift = formantShift;
-
-  if (mBeatriceProcessorCore) {
-    mBeatriceProcessorCore->SetFormantShift(mBeatriceParameters.formantShift);
-  }
+  publishParameters();
 }
 
 void BeatriceProcessor::setInputGain(double gain) {
   mBeatriceParameters.inputGain = gain;
-
-  if (mBeatriceProcessorCore) {
-    mBeatriceProcessorCore->SetInputGain(mBeatriceParameters.inputGain);
-  }
+  publishParameters();
 }
 
 void BeatriceProcessor::setOutputGain(double gain) {
   mBeatriceParameters.outputGain = gain;
-
-  if (mBeatriceProcessorCore) {
-    mBeatriceProcessorCore->SetOutputGain(mBeatriceParameters.outputGain);
-  }
+  publishParameters();
 }
 
 void BeatriceProcessor::setIntonationIntensity(double intensity) {
   mBeatriceParameters.intonationIntensity = intensity;
-
-  if (mBeatriceProcessorCore) {
-    mBeatriceProcessorCore->SetIntonationIntensity(
-        mBeatriceParameters.intonationIntensity);
-  }
+  publishParameters();
 }
 
 void BeatriceProcessor::setPitchCorrection(double correction) {
   mBeatriceParameters.pitchCorrection = correction;
-
-  if (mBeatriceProcessorCore) {
-    mBeatriceProcessorCore->SetPitchCorrection(
-        mBeatriceParameters.pitchCorrection);
-  }
+  publishParameters();
 }
 
 void BeatriceProcessor::setPitchCorrectionMode(int32_t mode) {
   mBeatriceParameters.pitchCorrectionMode = mode;
-
-  if (mBeatriceProcessorCore) {
-    mBeatriceProcessorCore->SetPitchCorrectionType(
-        mBeatriceParameters.pitchCorrectionMode);
-  }
+  publishParameters();
 }
 
 void BeatriceProcessor::setSourcePitchRange(double minPitch, double maxPitch) {
   mBeatriceParameters.minSourcePitch = minPitch;
   mBeatriceParameters.maxSourcePitch = maxPitch;
-
-  if (mBeatriceProcessorCore) {
-    mBeatriceProcessorCore->SetMinSourcePitch(
-        mBeatriceParameters.minSourcePitch);
-    mBeatriceProcessorCore->SetMaxSourcePitch(
-        mBeatriceParameters.maxSourcePitch);
-  }
+  publishParameters();
 }
 
 void BeatriceProcessor::setVQNumNeighbors(int32_t numNeighbors) {
   mBeatriceParameters.vqNumNeighbors = numNeighbors;
-
-  if (mBeatriceProcessorCore) {
-    mBeatriceProcessorCore->SetVQNumNeighbors(
-        mBeatriceParameters.vqNumNeighbors);
-  }
+  publishParameters();
 }
 
 bool BeatriceProcessor::setSpeakerMorphingWeights(
     const std::array<float, beatrice::common::kMaxNSpeakers>& weights) {
   const auto cleanWeights =
       zeroUnusedWeights(weights, static_cast<size_t>(mBeatriceVoiceCount));
-  mBeatriceParameters.speakerMorphingWeights = cleanWeights;
-
-  if (mBeatriceProcessorCore) {
-    auto error_code =
-        mBeatriceProcessorCore->SetSpeakerMorphingWeights(cleanWeights);
-    if (error_code != ErrorCode::kSuccess) {
-      LOGW("Failed to set speaker morphing weights: %d",
-           static_cast<int>(error_code));
-      return false;
-    }
+  if (!areValidMorphingWeights(cleanWeights)) {
+    return false;
   }
+  mBeatriceParameters.speakerMorphingWeights = cleanWeights;
+  publishParameters();
   return true;
 }
 
@@ -289,26 +255,39 @@ BeatriceParameters BeatriceProcessor::getParameters() const {
 }
 
 void BeatriceProcessor::setParameters(const BeatriceParameters& params) {
+  // Published once, so the audio thread never runs with half a preset.
   if (params.targetSpeaker >= 0 &&
       params.targetSpeaker <= static_cast<int32_t>(mBeatriceVoiceCount)) {
-    setVoiceID(params.targetSpeaker);
+    mBeatriceParameters.targetSpeaker = params.targetSpeaker;
   } else {
-    setVoiceID(0);
+    mBeatriceParameters.targetSpeaker = 0;
+  }
+  mBeatriceParameters.formantShift = params.formantShift;
+  mBeatriceParameters.pitchShift = params.pitchShift;
+  mBeatriceParameters.inputGain = params.inputGain;
+  mBeatriceParameters.outputGain = params.outputGain;
+  mBeatriceParameters.intonationIntensity = params.intonationIntensity;
+  mBeatriceParameters.pitchCorrection = params.pitchCorrection;
+  mBeatriceParameters.pitchCorrectionMode = params.pitchCorrectionMode;
+  mBeatriceParameters.minSourcePitch = params.minSourcePitch;
+  mBeatriceParameters.maxSourcePitch = params.maxSourcePitch;
+  mBeatriceParameters.vqNumNeighbors = params.vqNumNeighbors;
+  // Invalid weights keep the current ones, like a rejected setter call.
+  if (const auto cleanWeights =
+          zeroUnusedWeights(params.speakerMorphingWeights,
+                            static_cast<size_t>(mBeatriceVoiceCount));
+      areValidMorphingWeights(cleanWeights)) {
+    mBeatriceParameters.speakerMorphingWeights = cleanWeights;
   }
-  setFormantShift(params.formantShift);
-  setPitchShift(params.pitchShift);
-  setInputGain(params.inputGain);
-  setOutputGain(params.outputGain);
-  setIntonationIntensity(params.intonationIntensity);
-  setPitchCorrection(params.pitchCorrection);
-  setPitchCorrectionMode(params.pitchCorrectionMode);
-  setSourcePitchRange(params.minSourcePitch, params.maxSourcePitch);
-  setVQNumNeighbors(params.vqNumNeighbors);
-  setSpeakerMorphingWeights(params.speakerMorphingWeights);
+  publishParameters();
 }
 
 size_t BeatriceProcessor::getVoiceCount() const { return mBeatriceVoiceCount; }
 
+void BeatriceProcessor::publishParameters() {
+  mParameterTransport.publish(mBeatriceParameters);
+}
+
 void BeatriceProcessor::applyParametersToCore() {
   if (!mBeatriceProcessorCore) {
     return;
@@ -317,8 +296,11 @@ void BeatriceProcessor::applyParametersToCore() {
   mBeatriceProcessorCore->SetTargetSpeaker(mBeatriceParameters.targetSpeaker);
   mBeatriceProcessorCore->SetFormantShift(mBeatriceParameters.formantShift);
   mBeatriceProcessorCore->SetPitchShift(mBeatriceParameters.pitchShift);
-  mBeatriceProcessorCore->SetInputGain(mBeatriceParameters.inputGain);
-  mBeatriceProcessorCore->SetOutputGain(mBeatriceParameters.outputGain);
+  // Gains are applied by process(), see mInputGain.
+  mBeatriceProcessorCore->SetInputGain(0.0);
+  mBeatriceProcessorCore->SetOutputGain(0.0);
+  mInputGain.reset(dbToLinear(mBeatriceParameters.inputGain));
+  mOutputGain.reset(dbToLinear(mBeatriceParameters.outputGain));
   mBeatriceProcessorCore->SetAverageSourcePitch(
       mBeatriceParameters
           .averageTargetPitchBase[mBeatriceParameters.targetSpeaker] -
@@ -334,25 +316,150 @@ void BeatriceProcessor::applyParametersToCore() {
   mBeatriceProcessorCore->SetVQNumNeighbors(mBeatriceParameters.vqNumNeighbors);
   mBeatriceProcessorCore->SetSpeakerMorphingWeights(
       mBeatriceParameters.speakerMorphingWeights);
+  mAppliedParameters = mBeatriceParameters;
+}
+
+void BeatriceProcessor::applyParameterChanges(
+    const BeatriceParameters& params) {
+  if (!mBeatriceProcessorCore) {
+    return;
+  }
+  auto& core = *mBeatriceProcessorCore;
+  const BeatriceParameters& applied = mAppliedParameters;
+
+  if (params.targetSpeaker != applied.targetSpeaker) {
+    core.SetTargetSpeaker(params.targetSpeaker);
+  }
+  if (params.formantShift != applied.formantShift) {
+    core.SetFormantShift(params.formantShift);
+  }
+  if (params.pitchShift != applied.pitchShift) {
+    core.SetPitchShift(params.pitchShift);
+  }
+  if (params.targetSpeaker != applied.targetSpeaker ||
+      params.pitchShift != applied.pitchShift) {
+    core.SetAverageSourcePitch(
+        params.averageTargetPitchBase[params.targetSpeaker] -
+        params.pitchShift);
+  }
+  if (params.inputGain != applied.inputGain) {
+    mInputGain.setTarget(dbToLinear(params.inputGain));
+  }
+  if (params.outputGain != applied.outputGain) {
+    mOutputGain.setTarget(dbToLinear(params.outputGain));
+  }
+  if (params.intonationIntensity != applied.intonationIntensity) {
+    core.SetIntonationIntensity(params.intonationIntensity);
+  }
+  if (params.pitchCorrection != applied.pitchCorrection) {
+    core.SetPitchCorrection(params.pitchCorrection);
+  }
+  if (params.pitchCorrectionMode != applied.pitchCorrectionMode) {
+    core.SetPitchCorrectionType(params.pitchCorrectionMode);
+  }
+  if (params.minSourcePitch != applied.minSourcePitch) {
+    core.SetMinSourcePitch(params.minSourcePitch);
+  }
+  if (params.maxSourcePitch != applied.maxSourcePitch) {
+    core.SetMaxSourcePitch(params.maxSourcePitch);
+  }
+  if (params.vqNumNeighbors != applied.vqNumNeighbors) {
+    core.SetVQNumNeighbors(params.vqNumNeighbors);
+  }
+  if (params.speakerMorphingWeights != applied.speakerMorphingWeights) {
+    if (auto error_code =
+            core.SetSpeakerMorphingWeights(params.speakerMorphingWeights);
+        error_code != ErrorCode::kSuccess) {
+      LOGW("Failed to set speaker morphing weights: %d",
+           static_cast<int>(error_code));
+    }
+  }
+  mAppliedParameters = params;
 }
 
 bool BeatriceProcessor::isValidVoiceId(int32_t voiceID) const {
   return voiceID >= 0 && voiceID <= beatrice::common::kMaxNSpeakers;
 }
 
+bool BeatriceProcessor::areValidMorphingWeights(
+    const std::array<float, kMaxNSpeakers>& weights) const {
+  size_t nonZeroCount = 0;
+  for (const float weight : weights) {
+    // On the bits: this file is built with -Ofast, under which
+    // std::isfinite() is always true.
+    if ((std::bit_cast<uint32_t>(weight) & 0x7f800000u) == 0x7f800000u) {
+      LOGW("Speaker morphing weights must be finite");
+      return false;
+    }
+    if (weight != 0.0f) {
+      ++nonZeroCount;
+    }
+  }
+  if (getModelVersion() >= 2 && nonZeroCount > kMaxMorphedVoices) {
+    LOGW("Speaker morphing mixes %zu voices; the model allows %zu",
+         nonZeroCount, kMaxMorphedVoices);
+    return false;
+  }
+  return true;
+}
+
+void BeatriceProcessor::setVoiceActivityDetector(
+    std::shared_ptr<VoiceActivityDetector> detector) {
+  mVoiceGate.setDetector(std::move(detector));
+}
+
+void BeatriceProcessor::runCore(const float* input, float* output,
+                                int numSamples) {
+  for (int offset = 0; offset < numSamples; offset += kGainBlockSize) {
+    const int count = std::min(numSamples - offset, kGainBlockSize);
+    mInputGain.process(input + offset, mGainBuffer.data(), count);
+    mBeatriceProcessorCore->Process(mGainBuffer.data(), output + offset,
+                                    count);
+  }
+}
+
 void BeatriceProcessor::process(const float* inputBuffer, float* outputBuffer,
                                 int numSamples) {
-  if (mBeatriceProcessorCore && mIsEnabled) {
-    mBeatriceProcessorCore->Process(inputBuffer, outputBuffer, numSamples);
-  } else {
+  if (mParameterTransport.acquire()) {
+    applyParameterChanges(mParameterTransport.current());
+  }
+  if (!mBeatriceProcessorCore || !mIsEnabled.load()) {
+    std::fill_n(outputBuffer, numSamples, 0.0f);
+    return;
+  }
+
+  const VoiceGate::Action action = mVoiceGate.update(inputBuffer, numSamples);
+  if (action == VoiceGate::Action::kSkip) {
     std::fill_n(outputBuffer, numSamples, 0.0f);
+    return;
+  }
+
+  // Speech began in the pause, before the detector noticed: let the core
+  // hear it, so that its delay brings the onset out in this block.
+  const float* replay = mVoiceGate.getReplay();
+  const int replaySize = mVoiceGate.getReplaySize();
+  for (int offset = 0; offset < replaySize; offset += kGainBlockSize) {
+    const int count = std::min(replaySize - offset, kGainBlockSize);
+    runCore(replay + offset, mReplayBuffer.data(), count);
+  }
+  runCore(inputBuffer, outputBuffer, numSamples);
+  mOutputGain.process(outputBuffer, outputBuffer, numSamples);
+
+  if (action == VoiceGate::Action::kRunAndFade) {
+    // Last converted block before the pause: fade out whatever the core
+    // still had to say, so the switch to silence does not click.
+    const float step = 1.0f / static_cast<float>(numSamples);
+    for (int i = 0; i < numSamples; ++i) {
+      outputBuffer[i] *= 1.0f - step * static_cast<float>(i + 1);
+    }
   }
 }
 
 void BeatriceProcessor::setSampleRate(float sampleRate) {
   createProcessorCore(static_cast<int32_t>(sampleRate));
+  mVoiceGate.setSampleRate(sampleRate);
 }
 
-void BeatriceProcessor::setEnabled(bool enabled) { mIsEnabled = enabled; }
+void BeatriceProcessor::setEnabled(bool enabled) { mIsEnabled.store(enabled); }
 
-bool BeatriceProcessor::isEnabled() const { return mIsEnabled; }
+bool BeatriceProcessor::isEnabled() const { return mIsEnabled.load(); }
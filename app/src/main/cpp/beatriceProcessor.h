@@ -4,13 +4,37 @@
 #include <common/model_config.h>
 #include <common/processor_core.h>
 
+#include <array>
+#include <atomic>
 #include <filesystem>
 #include <memory>
 #include <string>
 
 #include "beatriceParameters.h"
 #include "effectors/AudioEffector.hpp"
+#include "effectors/GainSmoother.hpp"
+#include "effectors/ParameterTransport.hpp"
+#include "effectors/VoiceActivityDetector.hpp"
+#include "effectors/VoiceGate.hpp"
 
+/**
+ * @brief Runs the Beatrice voice conversion core as an effector.
+ *
+ * Parameter setters update the control-side BeatriceParameters and publish
+ * them as a snapshot; process() hands the changed values to the core at the
+ * start of the next block, on the audio thread, as a VST host would.
+ *
+ * Input and output gain are applied here rather than by the core, through
+ * GainSmoothers, so that moving the gain sliders ramps instead of stepping.
+ *
+ * With a VoiceActivityDetector attached and enabled, the core stops running
+ * once the detector reports silence: the first silent block is still
+ * converted and faded out, later ones are output as silence without calling
+ * the core. Parameter changes keep being applied meanwhile. The hangover
+ * lets the core's own buffers drain to silence first, so it resumes from
+ * silence when speech returns; it then first catches up on the input the
+ * detector was too late for (see VoiceGate).
+ */
 class BeatriceProcessor : public AudioEffector {
  public:
   explicit BeatriceProcessor(const std::string& toml_path);
@@ -19,6 +43,8 @@ class BeatriceProcessor : public AudioEffector {
       int32_t sampleRate);
   void resetProcessorCore();
 
+  // The TOML file; voice portrait paths are relative to its directory.
+  std::string getModelPath() const;
   std::u8string getModelName() const;
   std::u8string getModelDescription() const;
   int32_t getModelVersion() const;
@@ -38,9 +64,26 @@ class BeatriceProcessor : public AudioEffector {
   void setPitchCorrectionMode(int32_t mode);
   void setSourcePitchRange(double minPitch, double maxPitch);
   void setVQNumNeighbors(int32_t numNeighbors);
+  /**
+   * @return False, leaving the weights unchanged, if the core would reject
+   * them: a non-finite weight, or too many voices for the model's format.
+   * Weights past the model's voices are ignored.
+   */
   bool setSpeakerMorphingWeights(
       const std::array<float, beatrice::common::kMaxNSpeakers>& weights);
 
+  /**
+   * @brief Attaches the detector that decides when the core may pause, or
+   * detaches it with nullptr. Control thread, while not streaming.
+   */
+  void setVoiceActivityDetector(
+      std::shared_ptr<VoiceActivityDetector> detector);
+
+  /**
+   * @brief True while the core is paused for silence.
+   */
+  bool isCoreSkipping() const { return mVoiceGate.isSkipping(); }
+
   BeatriceParameters getParameters() const;
   void setParameters(const BeatriceParameters& params);
   size_t getVoiceCount() const;
@@ -53,15 +96,37 @@ class BeatriceProcessor : public AudioEffector {
   bool isEnabled() const override;
 
  private:
+  void publishParameters();
   void applyParametersToCore();
+  void applyParameterChanges(const BeatriceParameters& params);
+  // Runs the core over numSamples of input, through the input gain.
+  void runCore(const float* input, float* output, int numSamples);
   bool isValidVoiceId(int32_t voiceID) const;
+  // The core's checks, made here so that the control side learns the result
+  // rather than the audio thread.
+  bool areValidMorphingWeights(
+      const std::array<float, beatrice::common::kMaxNSpeakers>& weights)
+      const;
+
+  // Input gain is applied into mGainBuffer, so the core runs on chunks of at
+  // most this many samples.
+  static constexpr int kGainBlockSize = 256;
 
   std::shared_ptr<beatrice::common::ProcessorCoreBase> mBeatriceProcessorCore;
   beatrice::common::ModelConfig mBeatriceModelConfig;
   std::filesystem::path mBeatriceModelPath;
   BeatriceParameters mBeatriceParameters;
+  ParameterTransport<BeatriceParameters> mParameterTransport;
+  // What the core currently runs with; audio thread only while streaming.
+  BeatriceParameters mAppliedParameters;
+  GainSmoother mInputGain;
+  GainSmoother mOutputGain;
+  std::array<float, kGainBlockSize> mGainBuffer{};
+  // Receives the core's output while it catches up; not played.
+  std::array<float, kGainBlockSize> mReplayBuffer{};
   size_t mBeatriceVoiceCount = 0;
-  bool mIsEnabled = true;
+  std::atomic<bool> mIsEnabled{true};
+  VoiceGate mVoiceGate;
 };
 
 #endif  // BEATRICE_PROCESSOR_H
\ No newline at end of file
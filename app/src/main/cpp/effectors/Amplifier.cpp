@@ -4,23 +4,43 @@
 #include <cmath>
 
 Amplifier::Amplifier(float gainDb)
-    : m_gainLinear(dbToLinear(gainDb)), m_gainDb(gainDb) {}
+    : m_settings{dbToLinear(gainDb)},
+      m_parameters(m_settings),
+      m_gain(m_settings.gainLinear),
+      m_gainDb(gainDb) {}
 
 void Amplifier::process(const float* inputBuffer, float* outputBuffer,
                         int numSamples) {
-  if (m_isEnabled) {
-    float gainLinear = dbToLinear(m_gainDb);
-    for (int i = 0; i < numSamples; ++i) {
-      outputBuffer[i] = inputBuffer[i] * gainLinear;
+  if (m_parameters.acquire()) {
+    const Parameters& params = m_parameters.current();
+    m_gain.setSampleRate(params.sampleRate);
+    if (params.resetCount != m_appliedResetCount) {
+      m_appliedResetCount = params.resetCount;
+      m_gain.reset(params.gainLinear);
+    } else {
+      m_gain.setTarget(params.gainLinear);
     }
-  } else if (inputBuffer != outputBuffer) {
-    std::copy(inputBuffer, inputBuffer + numSamples, outputBuffer);
   }
+  if (m_isEnabled.load()) {
+    m_gain.process(inputBuffer, outputBuffer, numSamples);
+  } else {
+    m_gain.reset(m_gain.getTarget());
+    if (inputBuffer != outputBuffer) {
+      std::copy(inputBuffer, inputBuffer + numSamples, outputBuffer);
+    }
+  }
+}
+
+void Amplifier::setSampleRate(float sampleRate) {
+  m_settings.sampleRate = sampleRate;
+  ++m_settings.resetCount;
+  m_parameters.publish(m_settings);
 }
 
 void Amplifier::setGain(float gainDb) {
   m_gainDb = gainDb;
-  m_gainLinear = dbToLinear(gainDb);
+  m_settings.gainLinear = dbToLinear(gainDb);
+  m_parameters.publish(m_settings);
 }
 
 float Amplifier::dbToLinear(float db) { return std::pow(10.0f, db / 20.0f); }
\ No newline at end of file
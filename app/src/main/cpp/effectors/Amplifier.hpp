@@ -1,13 +1,19 @@
 #ifndef EFFECT_AMPLIFIER_HPP
 #define EFFECT_AMPLIFIER_HPP
 
+#include <atomic>
+#include <cstdint>
+
 #include "AudioEffector.hpp"
+#include "GainSmoother.hpp"
+#include "ParameterTransport.hpp"
 
 /**
  * @brief A simple audio amplifier class.
  *
  * This class applies a gain factor to the input audio signal, effectively
  * amplifying or attenuating it. The gain is specified in decibels (dB).
+ * Gain changes are ramped over GainSmoother::kDefaultRampTimeMs.
  */
 class Amplifier : public AudioEffector {
  public:
@@ -19,18 +25,27 @@ class Amplifier : public AudioEffector {
   void setGain(float gainDb);
   float getGain() const { return m_gainDb; }
 
-  void setSampleRate(float sampleRate) override {
-    (void)sampleRate;  // Sample rate is not used in this effector
-  }
+  void setSampleRate(float sampleRate) override;
 
-  void setEnabled(bool enabled) override { m_isEnabled = enabled; }
+  void setEnabled(bool enabled) override { m_isEnabled.store(enabled); }
 
-  bool isEnabled() const override { return m_isEnabled; }
+  bool isEnabled() const override { return m_isEnabled.load(); }
+  bool isBypassedWhenDisabled() const override { return true; }
 
  private:
-  float m_gainLinear = 1.0f;  // Linear gain factor
-  float m_gainDb;             // Gain in decibels
-  bool m_isEnabled = false;   // Whether the amplifier is enabled
+  struct Parameters {
+    float gainLinear = 1.0f;
+    float sampleRate = 44100.0f;
+    // Bumped by setSampleRate(); the gain jumps instead of ramping.
+    uint32_t resetCount = 0;
+  };
+
+  Parameters m_settings;                  // Control-side copy
+  ParameterTransport<Parameters> m_parameters;
+  GainSmoother m_gain;                    // Audio thread only
+  uint32_t m_appliedResetCount = 0;       // Audio thread only
+  float m_gainDb;                         // Gain in decibels
+  std::atomic<bool> m_isEnabled{false};   // Whether the amplifier is enabled
   float dbToLinear(float db);
 };
 
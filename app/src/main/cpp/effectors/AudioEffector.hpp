@@ -44,6 +44,28 @@ class AudioEffector {
    * @return True if enabled, false otherwise.
    */
   virtual bool isEnabled() const = 0;
+
+  /**
+   * @brief Delay the effector adds to the signal, in frames.
+   *
+   * Read on the control thread, e.g. to account for the total latency of
+   * the pipeline. The default implementation reports none.
+   */
+  virtual int getLatencyFrames() const { return 0; }
+
+  /**
+   * @brief Whether the effector passes its input through unchanged while
+   * disabled, so that a chain may skip calling it then.
+   *
+   * A skipped effector is called once more when it stops running, so that
+   * its disabled path can drop any state that would be stale when it is
+   * enabled again. The default implementation reports false, e.g. for an
+   * effector that outputs silence while disabled.
+   *
+   * An effector that reports true must answer isEnabled() without blocking,
+   * since a chain asks it on the audio thread every block.
+   */
+  virtual bool isBypassedWhenDisabled() const { return false; }
 };
 
 #endif  // AUDIO_EFFECTOR_HPP
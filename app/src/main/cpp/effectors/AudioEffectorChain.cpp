@@ -1,37 +1,259 @@
 #include "AudioEffectorChain.hpp"
 
+#include <logging_macros.h>
+
+#include <algorithm>
+
 void AudioEffectorChain::process(const float* inputBuffer, float* outputBuffer,
                                  int numSamples) {
+  mPlan.acquire();
+  const Plan& plan = mPlan.current();
   const float* currentInput = inputBuffer;
-  float* currentOutput = outputBuffer;
-  for (auto& effector : mEffectors) {
-    effector->process(currentInput, currentOutput, numSamples);
+  if (mProfiler && mProfiler->isEnabled()) {
+    const int64_t deadlineNanos =
+        static_cast<int64_t>(numSamples * 1e9 / mSampleRate);
+    const int64_t chainStart = ProcessingProfiler::now();
+    int64_t stageStart = chainStart;
+    for (const Step& step : plan.steps) {
+      if (!shouldRun(step)) {
+        continue;
+      }
+      runStep(step, currentInput, outputBuffer, numSamples);
+      currentInput = outputBuffer;
+      const int64_t stageEnd = ProcessingProfiler::now();
+      mProfiler->recordStage(step.node, stageEnd - stageStart, deadlineNanos);
+      stageStart = stageEnd;
+    }
+    if (currentInput != outputBuffer) {
+      std::copy(inputBuffer, inputBuffer + numSamples, outputBuffer);
+    }
+    mProfiler->recordChain(ProcessingProfiler::now() - chainStart,
+                           deadlineNanos);
+    return;
+  }
+  for (const Step& step : plan.steps) {
+    if (!shouldRun(step)) {
+      continue;
+    }
+    runStep(step, currentInput, outputBuffer, numSamples);
     currentInput =
-        currentOutput;  // Output of this effector becomes input for the next
+        outputBuffer;  // Output of this effector becomes input for the next
+  }
+  if (currentInput != outputBuffer) {
+    std::copy(inputBuffer, inputBuffer + numSamples, outputBuffer);
+  }
+}
+
+bool AudioEffectorChain::shouldRun(const Step& step) {
+  if (!step.isSkippable || step.effector->isEnabled()) {
+    mIsRunning[step.node] = 1;
+    return true;
+  }
+  if (!mIsRunning[step.node]) {
+    return false;
+  }
+  // Just disabled: one last call, which passes the block through unchanged
+  // and lets the effector reset whatever its disabled path resets.
+  mIsRunning[step.node] = 0;
+  return true;
+}
+
+void AudioEffectorChain::runStep(const Step& step, const float* inputBuffer,
+                                 float* outputBuffer, int numSamples) {
+  if (step.wetMix >= 1.0f) {
+    step.effector->process(inputBuffer, outputBuffer, numSamples);
+    return;
+  }
+  const float wet = step.wetMix;
+  const float dry = 1.0f - wet;
+  for (int offset = 0; offset < numSamples; offset += kChunkSize) {
+    const int len = std::min(kChunkSize, numSamples - offset);
+    // Keep the dry signal before the effector may overwrite it in place.
+    std::copy(inputBuffer + offset, inputBuffer + offset + len,
+              mDryBuffer.begin());
+    step.effector->process(inputBuffer + offset, outputBuffer + offset, len);
+    for (int i = 0; i < len; ++i) {
+      outputBuffer[offset + i] =
+          outputBuffer[offset + i] * wet + mDryBuffer[i] * dry;
+    }
   }
 }
 
 void AudioEffectorChain::setSampleRate(float sampleRate) {
-  for (auto& effector : mEffectors) {
-    effector->setSampleRate(sampleRate);
+  std::lock_guard<std::mutex> lock(mMutex);
+  mSampleRate = sampleRate;
+  for (auto& node : mNodes) {
+    node.effector->setSampleRate(sampleRate);
+  }
+}
+
+void AudioEffectorChain::addEffector(std::shared_ptr<AudioEffector> effector,
+                                     const std::string& name) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  // Before the effector kept last, if any.
+  mOrder.insert(mLastNode >= 0 ? mOrder.end() - 1 : mOrder.end(),
+                static_cast<int>(mNodes.size()));
+  mNodes.push_back({std::move(effector), name});
+  mIsRunning.assign(mNodes.size(), 0);
+  if (mProfiler) {
+    mProfiler->addStage(name);
+  }
+  publishPlan();
+}
+
+void AudioEffectorChain::clearEffectors() {
+  std::lock_guard<std::mutex> lock(mMutex);
+  mNodes.clear();
+  mOrder.clear();
+  mLastNode = -1;
+  mIsRunning.clear();
+  if (mProfiler) {
+    mProfiler->clearStages();
+  }
+  publishPlan();
+}
+
+void AudioEffectorChain::rebuildPlan() {
+  std::lock_guard<std::mutex> lock(mMutex);
+  publishPlan();
+}
+
+bool AudioEffectorChain::setOrder(const std::vector<std::string>& names) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  std::vector<int> order;
+  order.reserve(names.size());
+  for (const auto& name : names) {
+    const int node = findNode(name);
+    if (node < 0 ||
+        std::find(order.begin(), order.end(), node) != order.end()) {
+      LOGW("Effector order names \"%s\" twice or has no such effector",
+           name.c_str());
+      return false;
+    }
+    order.push_back(node);
+  }
+  if (order.size() != mNodes.size()) {
+    LOGW("Effector order lists %zu of %zu effectors", order.size(),
+         mNodes.size());
+    return false;
   }
+  if (mLastNode >= 0 && order.back() != mLastNode) {
+    LOGW("Effector order must end with \"%s\"",
+         mNodes[mLastNode].name.c_str());
+    return false;
+  }
+  mOrder = std::move(order);
+  publishPlan();
+  return true;
+}
+
+bool AudioEffectorChain::keepLast(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  const int node = findNode(name);
+  if (node < 0) {
+    LOGW("No effector named \"%s\" in the chain", name.c_str());
+    return false;
+  }
+  mLastNode = node;
+  std::erase(mOrder, node);
+  mOrder.push_back(node);
+  publishPlan();
+  return true;
+}
+
+std::vector<std::string> AudioEffectorChain::getOrder() const {
+  std::lock_guard<std::mutex> lock(mMutex);
+  std::vector<std::string> names;
+  names.reserve(mOrder.size());
+  for (const int node : mOrder) {
+    names.push_back(mNodes[node].name);
+  }
+  return names;
+}
+
+bool AudioEffectorChain::setWetMix(const std::string& name, float wetMix) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  const int node = findNode(name);
+  if (node < 0) {
+    LOGW("No effector named \"%s\" in the chain", name.c_str());
+    return false;
+  }
+  wetMix = std::clamp(wetMix, 0.0f, 1.0f);
+  const AudioEffector& effector = *mNodes[node].effector;
+  // The dry path is not delayed, so the mix would comb filter. A disabled
+  // effector may report no latency until it is enabled.
+  if (wetMix < 1.0f &&
+      (!effector.isEnabled() || effector.getLatencyFrames() > 0)) {
+    LOGW("Effector \"%s\" is disabled or has latency; it cannot run in "
+         "parallel",
+         name.c_str());
+    return false;
+  }
+  mNodes[node].wetMix = wetMix;
+  publishPlan();
+  return true;
+}
+
+void AudioEffectorChain::publishPlan() {
+  Plan plan;
+  for (const int node : mOrder) {
+    const Node& entry = mNodes[node];
+    // Latency can come with a later change, e.g. a longer look-ahead.
+    const float wetMix =
+        entry.effector->getLatencyFrames() > 0 ? 1.0f : entry.wetMix;
+    plan.steps.push_back({entry.effector.get(), node, wetMix,
+                          entry.effector->isBypassedWhenDisabled()});
+  }
+  mPlan.publish(plan);
+}
+
+int AudioEffectorChain::findNode(const std::string& name) const {
+  for (size_t i = 0; i < mNodes.size(); ++i) {
+    if (mNodes[i].name == name) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
 }
 
-void AudioEffectorChain::addEffector(std::shared_ptr<AudioEffector> effector) {
-  mEffectors.push_back(effector);
+void AudioEffectorChain::setProfiler(
+    std::shared_ptr<ProcessingProfiler> profiler) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  mProfiler = profiler;
+  registerProfilerStages();
 }
 
-void AudioEffectorChain::clearEffectors() { mEffectors.clear(); }
+void AudioEffectorChain::registerProfilerStages() {
+  if (!mProfiler) {
+    return;
+  }
+  mProfiler->clearStages();
+  for (const auto& node : mNodes) {
+    mProfiler->addStage(node.name);
+  }
+}
 
 void AudioEffectorChain::setEnabled(bool enabled) {
-  for (auto& effector : mEffectors) {
-    effector->setEnabled(enabled);
+  std::lock_guard<std::mutex> lock(mMutex);
+  for (auto& node : mNodes) {
+    node.effector->setEnabled(enabled);
   }
+  publishPlan();
 }
 
 bool AudioEffectorChain::isEnabled() const {
-  for (auto& effector : mEffectors) {
-    if (effector->isEnabled()) return true;
+  std::lock_guard<std::mutex> lock(mMutex);
+  for (const auto& node : mNodes) {
+    if (node.effector->isEnabled()) return true;
   }
   return false;
-}
\ No newline at end of file
+}
+
+int AudioEffectorChain::getLatencyFrames() const {
+  std::lock_guard<std::mutex> lock(mMutex);
+  int latency = 0;
+  for (const auto& node : mNodes) {
+    latency += node.effector->getLatencyFrames();
+  }
+  return latency;
+}
@@ -1,30 +1,166 @@
 #ifndef AUDIO_EFFECTOR_CHAIN_HPP
 #define AUDIO_EFFECTOR_CHAIN_HPP
 
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include "AudioEffector.hpp"
+#include "ParameterTransport.hpp"
+#include "ProcessingProfiler.hpp"
 
 /**
  * @brief A chain of audio effectors that processes audio in sequence.
  *
  * This class allows multiple AudioEffector instances to be applied in order,
  * where the output of one effector becomes the input to the next.
+ *
+ * The control side compiles the effectors into a flat plan, which the audio
+ * thread picks up atomically at a block boundary. The plan lists the
+ * effectors in the user's order, each with its mix. A disabled effector that
+ * merely passes audio through (see AudioEffector::isBypassedWhenDisabled())
+ * is skipped, apart from one last call when it stops running; its enabled
+ * flag is read every block, so enabling or disabling one needs no new plan.
+ * The first step that runs reads the chain's input and every later one works
+ * in place, so a block with nothing to run costs one copy at most. An
+ * effector can also run as a parallel branch, mixed with its own dry input.
+ *
+ * Changes made through the chain recompile the plan themselves. Call
+ * rebuildPlan() after changing an effector's latency.
  */
 class AudioEffectorChain : public AudioEffector {
  public:
+  static constexpr int kChunkSize = 256;
+
   void process(const float* inputBuffer, float* outputBuffer,
                int numSamples) override;
   void setSampleRate(float sampleRate) override;
   void setEnabled(bool enabled) override;
   bool isEnabled() const override;
-  void addEffector(std::shared_ptr<AudioEffector> effector);
 
+  /**
+   * @brief Sum of the latencies of all effectors in the chain.
+   */
+  int getLatencyFrames() const override;
+
+  /**
+   * @brief Appends an effector to the end of the chain. Only while the audio
+   * thread is stopped.
+   *
+   * @param effector Effector to append.
+   * @param name Stage name reported by the profiler; also names the effector
+   * for setOrder() and setWetMix().
+   */
+  void addEffector(std::shared_ptr<AudioEffector> effector,
+                   const std::string& name = "effector");
+
+  /**
+   * @brief Removes every effector. Only while the audio thread is stopped.
+   */
   void clearEffectors();
 
+  /**
+   * @brief Recompiles the plan from the effectors' latency. Control thread;
+   * call after changing the latency of an effector in the chain.
+   */
+  void rebuildPlan();
+
+  /**
+   * @brief Runs the effectors in the given order from the next block on.
+   * Control thread.
+   *
+   * @param names Every effector's name, each exactly once, ending with the
+   * one kept last if there is one.
+   * @return False, leaving the order unchanged, if names is not such a list.
+   */
+  bool setOrder(const std::vector<std::string>& names);
+
+  /**
+   * @brief Moves an effector to the end and keeps it there: effectors added
+   * later go before it, and setOrder() rejects an order that moves it.
+   * Control thread.
+   *
+   * @return False if no effector has that name.
+   */
+  bool keepLast(const std::string& name);
+
+  /**
+   * @brief The effectors' names in the order they run.
+   */
+  std::vector<std::string> getOrder() const;
+
+  /**
+   * @brief Mixes an effector's output with its own input, as a parallel
+   * wet/dry branch. Control thread.
+   *
+   * The dry path is not delayed, so only enabled effectors without latency
+   * can run in parallel. One that has latency by the time the plan is
+   * compiled runs in series, whatever its mix.
+   *
+   * @param wetMix Share of the effector's output, clamped to 0 to 1; 1, the
+   * default, runs it in series.
+   * @return False, leaving the mix unchanged, if no effector has that name,
+   * or wetMix is below 1 and the effector is disabled or has latency.
+   */
+  bool setWetMix(const std::string& name, float wetMix);
+
+  /**
+   * @brief Attaches a profiler that times every stage of process() while it
+   * is enabled. Pass nullptr to detach. Call only while audio is stopped.
+   */
+  void setProfiler(std::shared_ptr<ProcessingProfiler> profiler);
+
  private:
-  std::vector<std::shared_ptr<AudioEffector>> mEffectors;
+  struct Node {
+    std::shared_ptr<AudioEffector> effector;
+    std::string name;
+    float wetMix = 1.0f;
+  };
+
+  struct Step {
+    AudioEffector* effector = nullptr;
+    // Index into mNodes, which is also the node's profiler stage.
+    int node = 0;
+    float wetMix = 1.0f;
+    // Not run while disabled; see AudioEffector::isBypassedWhenDisabled().
+    bool isSkippable = false;
+  };
+
+  struct Plan {
+    std::vector<Step> steps;
+  };
+
+  // Under mMutex.
+  void publishPlan();
+  int findNode(const std::string& name) const;
+  void registerProfilerStages();
+
+  // Audio thread.
+  void runStep(const Step& step, const float* inputBuffer,
+               float* outputBuffer, int numSamples);
+  // Whether the step runs this block; a skippable effector runs once more
+  // right after it has been disabled.
+  bool shouldRun(const Step& step);
+
+  // Control side, under mMutex.
+  mutable std::mutex mMutex;
+  std::vector<Node> mNodes;
+  // Indices into mNodes, in the order they run.
+  std::vector<int> mOrder;
+  // Node kept at the end of mOrder, or -1.
+  int mLastNode = -1;
+
+  ParameterTransport<Plan> mPlan;
+
+  // Audio thread. Sized by addEffector(), while the audio thread is stopped.
+  std::vector<uint8_t> mIsRunning;
+  std::array<float, kChunkSize> mDryBuffer{};
+
+  std::shared_ptr<ProcessingProfiler> mProfiler;
+  float mSampleRate = 48000.0f;
 };
 
-#endif  // AUDIO_EFFECTOR_CHAIN_HPP
\ No newline at end of file
+#endif  // AUDIO_EFFECTOR_CHAIN_HPP
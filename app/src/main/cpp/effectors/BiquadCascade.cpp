@@ -0,0 +1,237 @@
+#include "BiquadCascade.hpp"
+
+#include <algorithm>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+#if defined(__ARM_NEON)
+using Float4 = float32x4_t;
+
+inline Float4 load4(const float* p) { return vld1q_f32(p); }
+inline void store4(float* p, Float4 v) { vst1q_f32(p, v); }
+inline Float4 mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+// acc + a * b and acc - a * b.
+#if defined(__aarch64__)
+inline Float4 mulAdd(Float4 acc, Float4 a, Float4 b) {
+  return vfmaq_f32(acc, a, b);
+}
+inline Float4 mulSub(Float4 acc, Float4 a, Float4 b) {
+  return vfmsq_f32(acc, a, b);
+}
+#else
+inline Float4 mulAdd(Float4 acc, Float4 a, Float4 b) {
+  return vmlaq_f32(acc, a, b);
+}
+inline Float4 mulSub(Float4 acc, Float4 a, Float4 b) {
+  return vmlsq_f32(acc, a, b);
+}
+#endif
+// {x, v0, v1, v2}
+inline Float4 shiftIn(float x, Float4 v) {
+  return vextq_f32(vdupq_n_f32(x), v, 3);
+}
+// {lo3, hi0, hi1, hi2}
+inline Float4 shiftAcross(Float4 lo, Float4 hi) {
+  return vextq_f32(lo, hi, 3);
+}
+template <int kLane>
+inline float lane(Float4 v) {
+  return vgetq_lane_f32(v, kLane);
+}
+#elif defined(__SSE2__)
+using Float4 = __m128;
+
+inline Float4 load4(const float* p) { return _mm_load_ps(p); }
+inline void store4(float* p, Float4 v) { _mm_store_ps(p, v); }
+inline Float4 mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 mulAdd(Float4 acc, Float4 a, Float4 b) {
+  return _mm_add_ps(acc, _mm_mul_ps(a, b));
+}
+inline Float4 mulSub(Float4 acc, Float4 a, Float4 b) {
+  return _mm_sub_ps(acc, _mm_mul_ps(a, b));
+}
+inline Float4 shiftIn(float x, Float4 v) {
+  const Float4 shifted =
+      _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4));
+  return _mm_move_ss(shifted, _mm_set_ss(x));
+}
+inline Float4 shiftAcross(Float4 lo, Float4 hi) {
+  const Float4 t = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(0, 0, 3, 3));
+  return _mm_shuffle_ps(t, hi, _MM_SHUFFLE(2, 1, 2, 0));
+}
+template <int kLane>
+inline float lane(Float4 v) {
+  return _mm_cvtss_f32(
+      _mm_shuffle_ps(v, v, _MM_SHUFFLE(kLane, kLane, kLane, kLane)));
+}
+#else
+struct Float4 {
+  float v[4];
+};
+
+inline Float4 load4(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store4(float* p, Float4 v) { std::copy_n(v.v, 4, p); }
+inline Float4 mul(Float4 a, Float4 b) {
+  return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2],
+           a.v[3] * b.v[3]}};
+}
+inline Float4 mulAdd(Float4 acc, Float4 a, Float4 b) {
+  for (int i = 0; i < 4; ++i) acc.v[i] += a.v[i] * b.v[i];
+  return acc;
+}
+inline Float4 mulSub(Float4 acc, Float4 a, Float4 b) {
+  for (int i = 0; i < 4; ++i) acc.v[i] -= a.v[i] * b.v[i];
+  return acc;
+}
+inline Float4 shiftIn(float x, Float4 v) {
+  return {{x, v.v[0], v.v[1], v.v[2]}};
+}
+inline Float4 shiftAcross(Float4 lo, Float4 hi) {
+  return {{lo.v[3], hi.v[0], hi.v[1], hi.v[2]}};
+}
+template <int kLane>
+inline float lane(Float4 v) {
+  return v.v[kLane];
+}
+#endif
+
+// One step of four TDF-II biquads, one per lane.
+struct Biquad4 {
+  Float4 b0, b1, b2, a1, a2;
+  Float4 z1, z2;
+
+  inline Float4 step(Float4 x) {
+    const Float4 y = mulAdd(z1, b0, x);
+    z1 = mulSub(mulAdd(z2, b1, x), a1, y);
+    z2 = mulSub(mul(b2, x), a2, y);
+    return y;
+  }
+};
+}  // namespace
+
+BiquadCascade::BiquadCascade(int numStages) { setNumStages(numStages); }
+
+void BiquadCascade::setNumStages(int numStages) {
+  m_numStages = std::clamp(numStages, 1, kMaxStages);
+  for (int i = 0; i < kMaxStages; ++i) {
+    setStage(i, BiquadCoeffs{1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f});
+  }
+  reset();
+}
+
+void BiquadCascade::setStage(int stageIndex, const BiquadCoeffs& coeffs) {
+  if (stageIndex < 0 || stageIndex >= kMaxStages) return;
+  m_b0[stageIndex] = coeffs.b0;
+  m_b1[stageIndex] = coeffs.b1;
+  m_b2[stageIndex] = coeffs.b2;
+  m_a1[stageIndex] = coeffs.a1;
+  m_a2[stageIndex] = coeffs.a2;
+}
+
+void BiquadCascade::reset() {
+  std::fill_n(m_z1, kMaxStages, 0.0f);
+  std::fill_n(m_z2, kMaxStages, 0.0f);
+  std::fill_n(m_y, kMaxStages, 0.0f);
+}
+
+void BiquadCascade::process(const float* inputBuffer, float* outputBuffer,
+                            int numSamples) {
+  if (numSamples <= 0) return;
+  switch (m_numStages) {
+    case 1:
+      processStages<1>(inputBuffer, outputBuffer, numSamples);
+      break;
+    case 2:
+      processStages<2>(inputBuffer, outputBuffer, numSamples);
+      break;
+    case 3:
+      processStages<3>(inputBuffer, outputBuffer, numSamples);
+      break;
+    case 4:
+      processStages<4>(inputBuffer, outputBuffer, numSamples);
+      break;
+    case 5:
+      processStages<5>(inputBuffer, outputBuffer, numSamples);
+      break;
+    case 6:
+      processStages<6>(inputBuffer, outputBuffer, numSamples);
+      break;
+    case 7:
+      processStages<7>(inputBuffer, outputBuffer, numSamples);
+      break;
+    default:
+      processStages<8>(inputBuffer, outputBuffer, numSamples);
+      break;
+  }
+}
+
+void BiquadCascade::stepLanes(float input, int firstLane, int endLane) {
+  // Downwards, so that each lane reads its predecessor's previous output.
+  for (int k = endLane - 1; k >= firstLane; --k) {
+    const float x = k == 0 ? input : m_y[k - 1];
+    const float y = m_b0[k] * x + m_z1[k];
+    m_z1[k] = (m_z2[k] + m_b1[k] * x) - m_a1[k] * y;
+    m_z2[k] = m_b2[k] * x - m_a2[k] * y;
+    m_y[k] = y;
+  }
+}
+
+template <int kStages>
+void BiquadCascade::processStages(const float* inputBuffer,
+                                  float* outputBuffer, int numSamples) {
+  constexpr int kLast = kStages - 1;
+  // Wavefront t feeds input sample t to lane 0 and produces output sample
+  // t - kLast from lane kLast; only [kLast, numSamples) has every lane busy.
+  const int numWavefronts = numSamples + kLast;
+  auto scalarWavefront = [&](int t) {
+    const int firstLane = std::max(0, t - numSamples + 1);
+    const int lastLane = std::min(t, kLast);
+    stepLanes(t < numSamples ? inputBuffer[t] : 0.0f, firstLane, lastLane + 1);
+    if (lastLane == kLast) {
+      outputBuffer[t - kLast] = m_y[kLast];
+    }
+  };
+
+  int t = 0;
+  for (; t < std::min(kLast, numWavefronts); ++t) {
+    scalarWavefront(t);
+  }
+
+  if (t < numSamples) {
+    Biquad4 lo{load4(m_b0), load4(m_b1), load4(m_b2), load4(m_a1),
+               load4(m_a2), load4(m_z1), load4(m_z2)};
+    Float4 yLo = load4(m_y);
+    if constexpr (kStages <= 4) {
+      for (; t < numSamples; ++t) {
+        yLo = lo.step(shiftIn(inputBuffer[t], yLo));
+        outputBuffer[t - kLast] = lane<kLast>(yLo);
+      }
+    } else {
+      Biquad4 hi{load4(m_b0 + 4), load4(m_b1 + 4), load4(m_b2 + 4),
+                 load4(m_a1 + 4), load4(m_a2 + 4), load4(m_z1 + 4),
+                 load4(m_z2 + 4)};
+      Float4 yHi = load4(m_y + 4);
+      for (; t < numSamples; ++t) {
+        const Float4 xHi = shiftAcross(yLo, yHi);
+        yLo = lo.step(shiftIn(inputBuffer[t], yLo));
+        yHi = hi.step(xHi);
+        outputBuffer[t - kLast] = lane<kLast - 4>(yHi);
+      }
+      store4(m_z1 + 4, hi.z1);
+      store4(m_z2 + 4, hi.z2);
+      store4(m_y + 4, yHi);
+    }
+    store4(m_z1, lo.z1);
+    store4(m_z2, lo.z2);
+    store4(m_y, yLo);
+  }
+
+  for (; t < numWavefronts; ++t) {
+    scalarWavefront(t);
+  }
+}
@@ -0,0 +1,75 @@
+#ifndef EFFECT_BIQUAD_CASCADE_HPP
+#define EFFECT_BIQUAD_CASCADE_HPP
+
+/**
+ * @brief Biquad filter coefficient structure.
+ */
+struct BiquadCoeffs {
+  float b0, b1, b2;
+  float a0, a1, a2;
+};
+
+/**
+ * @brief A cascade of up to kMaxStages transposed direct form II biquads,
+ * evaluated with 4-wide SIMD (NEON on arm64, SSE on x86).
+ *
+ * Stage k of the cascade sits in SIMD lane k. Each step of the inner loop
+ * advances every stage by one sample on a skewed wavefront: lane k filters
+ * sample t - k while lane 0 takes the new input sample t, and the outputs are
+ * shifted one lane up to become the next step's inputs. A five-stage cascade
+ * therefore costs one vector biquad per sample instead of five scalar ones.
+ * The partial wavefronts at the start and end of each block run on scalar
+ * code, so the pipeline is empty between calls and the output is not delayed.
+ *
+ * Coefficients and state live in flat, 16-byte aligned arrays; unused lanes
+ * hold identity stages.
+ */
+class BiquadCascade {
+ public:
+  static constexpr int kMaxStages = 8;
+
+  explicit BiquadCascade(int numStages = 1);
+
+  /**
+   * @brief Sets the number of stages (1-8) and clears the filter state.
+   */
+  void setNumStages(int numStages);
+  int getNumStages() const { return m_numStages; }
+
+  /**
+   * @brief Sets the coefficients of one stage. They must be normalized so
+   * that a0 == 1; a0 is ignored.
+   */
+  void setStage(int stageIndex, const BiquadCoeffs& coeffs);
+
+  /**
+   * @brief Clears the filter state.
+   */
+  void reset();
+
+  /**
+   * @brief Filters numSamples samples through all stages. inputBuffer and
+   * outputBuffer may be the same buffer.
+   */
+  void process(const float* inputBuffer, float* outputBuffer, int numSamples);
+
+ private:
+  template <int kStages>
+  void processStages(const float* inputBuffer, float* outputBuffer,
+                     int numSamples);
+  // Advances lanes [firstLane, endLane) by one wavefront on scalar code.
+  void stepLanes(float input, int firstLane, int endLane);
+
+  alignas(16) float m_b0[kMaxStages];
+  alignas(16) float m_b1[kMaxStages];
+  alignas(16) float m_b2[kMaxStages];
+  alignas(16) float m_a1[kMaxStages];
+  alignas(16) float m_a2[kMaxStages];
+  alignas(16) float m_z1[kMaxStages];
+  alignas(16) float m_z2[kMaxStages];
+  // Output of each lane on the latest wavefront.
+  alignas(16) float m_y[kMaxStages];
+  int m_numStages = 1;
+};
+
+#endif  // EFFECT_BIQUAD_CASCADE_HPP
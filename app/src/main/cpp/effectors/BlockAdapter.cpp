@@ -0,0 +1,70 @@
+#include "BlockAdapter.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+BlockAdapter::BlockAdapter(std::shared_ptr<AudioEffector> effector,
+                           int frameSize)
+    : m_effector(std::move(effector)), m_frameSize(frameSize) {
+  if (m_frameSize > 0) {
+    m_fifoInput.assign(static_cast<size_t>(m_frameSize), 0.0f);
+    m_fifoOutput.assign(static_cast<size_t>(m_frameSize), 0.0f);
+  }
+}
+
+void BlockAdapter::setSampleRate(float sampleRate) {
+  m_effector->setSampleRate(sampleRate);
+  resetFifo();
+}
+
+void BlockAdapter::process(const float* inputBuffer, float* outputBuffer,
+                           int numSamples) {
+  if (m_frameSize <= 0) {
+    m_effector->process(inputBuffer, outputBuffer, numSamples);
+    return;
+  }
+  if (!m_effector->isEnabled()) {
+    if (inputBuffer != outputBuffer) {
+      std::copy(inputBuffer, inputBuffer + numSamples, outputBuffer);
+    }
+    m_wasEnabled = false;
+    return;
+  }
+  if (!m_wasEnabled) {
+    // Start from silence rather than from a stale frame.
+    resetFifo();
+    m_wasEnabled = true;
+  }
+
+  int processed = 0;
+  while (processed < numSamples) {
+    const int len =
+        std::min(m_frameSize - m_fifoPosition, numSamples - processed);
+    // Stash the input before overwriting the (possibly aliased) output.
+    std::memcpy(&m_fifoInput[m_fifoPosition], &inputBuffer[processed],
+                sizeof(float) * len);
+    std::memcpy(&outputBuffer[processed], &m_fifoOutput[m_fifoPosition],
+                sizeof(float) * len);
+    m_fifoPosition += len;
+    processed += len;
+
+    if (m_fifoPosition == m_frameSize) {
+      m_effector->process(m_fifoInput.data(), m_fifoOutput.data(),
+                          m_frameSize);
+      m_fifoPosition = 0;
+    }
+  }
+}
+
+int BlockAdapter::getLatencyFrames() const {
+  if (!m_effector->isEnabled()) {
+    return 0;
+  }
+  return std::max(m_frameSize, 0) + m_effector->getLatencyFrames();
+}
+
+void BlockAdapter::resetFifo() {
+  std::fill(m_fifoOutput.begin(), m_fifoOutput.end(), 0.0f);
+  m_fifoPosition = 0;
+}
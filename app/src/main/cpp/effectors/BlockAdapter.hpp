@@ -0,0 +1,66 @@
+#ifndef EFFECT_BLOCK_ADAPTER_HPP
+#define EFFECT_BLOCK_ADAPTER_HPP
+
+#include <memory>
+#include <vector>
+
+#include "AudioEffector.hpp"
+
+/**
+ * @brief Feeds an effector that only accepts fixed-size frames from blocks
+ * of any size.
+ *
+ * Input is collected in a one-frame FIFO; every time it fills, the wrapped
+ * effector processes the whole frame and the result is returned over the
+ * following blocks. The delay is therefore always exactly one frame,
+ * whatever the block size, and is reported by getLatencyFrames(). While the
+ * wrapped effector is disabled, blocks pass straight through and the FIFO
+ * starts over from silence on the next enable.
+ *
+ * The FIFO is allocated by the constructor; process() neither allocates nor
+ * locks.
+ */
+class BlockAdapter : public AudioEffector {
+ public:
+  /**
+   * @param effector The effector to feed; it always receives frameSize
+   * samples per call.
+   * @param frameSize Frame length in samples. Zero or less forwards blocks
+   * unchanged, e.g. for a model that failed to load.
+   */
+  BlockAdapter(std::shared_ptr<AudioEffector> effector, int frameSize);
+
+  void process(const float* inputBuffer, float* outputBuffer,
+               int numSamples) override;
+
+  /**
+   * @brief Forwards the rate and clears the FIFO.
+   */
+  void setSampleRate(float sampleRate) override;
+
+  void setEnabled(bool enabled) override { m_effector->setEnabled(enabled); }
+  bool isEnabled() const override { return m_effector->isEnabled(); }
+  bool isBypassedWhenDisabled() const override {
+    return m_frameSize > 0 || m_effector->isBypassedWhenDisabled();
+  }
+
+  /**
+   * @brief One frame plus the wrapped effector's latency while enabled.
+   */
+  int getLatencyFrames() const override;
+
+  int getFrameSize() const { return m_frameSize; }
+
+ private:
+  void resetFifo();
+
+  std::shared_ptr<AudioEffector> m_effector;
+  const int m_frameSize;
+  std::vector<float> m_fifoInput;
+  std::vector<float> m_fifoOutput;
+  int m_fifoPosition = 0;
+  // Whether the previous block went through the FIFO (audio thread).
+  bool m_wasEnabled = false;
+};
+
+#endif  // EFFECT_BLOCK_ADAPTER_HPP
@@ -1,59 +1,84 @@
 #include "Compressor.hpp"
 
 #include <algorithm>
+#include <array>
 
 Compressor::Compressor(float threshold, float ratio, float attack,
                        float release, float makeupGain, float sampleRate)
     : DynamicProcessor(threshold, attack, release, sampleRate),
-      m_ratio(ratio),
-      m_makeupGainDb(makeupGain),
-      m_makeupGainLinear(dbToLinear(makeupGain)) {}
+      m_makeupGain(dbToLinear(makeupGain)) {
+  m_settings.ratio = ratio;
+  m_settings.makeupGainDb = makeupGain;
+  publishParameters();
+}
 
 void Compressor::process(const float* inputBuffer, float* outputBuffer,
                          int numSamples) {
-  if (m_isEnabled) {
-    // Call base class process, which handles envelope follower and gain
-    // calculation
-    DynamicProcessor::process(inputBuffer, outputBuffer, numSamples);
-
-    // Apply makeup gain to the already-compressed buffer
+  BlockState state = beginBlock();
+  if (state.enabled) {
+    std::array<float, kChunkSize> envelope;
+    std::array<float, kChunkSize> gain;
+    for (int offset = 0; offset < numSamples; offset += kChunkSize) {
+      const int n = std::min(kChunkSize, numSamples - offset);
+      const float* input = inputBuffer + offset;
+      for (int i = 0; i < n; ++i) {
+        envelope[i] = state.followEnvelope(std::abs(input[i]));
+      }
+      computeGain(state.params, envelope.data(), gain.data(), n);
+      applyGain(state, input, gain.data(), outputBuffer + offset, n);
+    }
+  } else {
     for (int i = 0; i < numSamples; ++i) {
-      outputBuffer[i] *= m_makeupGainLinear;
+      state.bypass(inputBuffer[i]);
+    }
+    if (inputBuffer != outputBuffer) {
+      // Bypass: copy input to output
+      std::copy(inputBuffer, inputBuffer + numSamples, outputBuffer);
     }
-    m_outputPeakDb.store(m_outputPeakDb.load() +
-                         m_makeupGainDb);  // Adjust output peak for makeup gain
+  }
+  finishBlock(state, outputBuffer, numSamples);
+}
 
-  } else if (inputBuffer != outputBuffer) {
-    // Bypass: copy input to output
-    std::copy(inputBuffer, inputBuffer + numSamples, outputBuffer);
+void Compressor::computeGain(const Parameters& params, const float* envelope,
+                             float* gain, int numSamples) {
+  fastmath::log2Block(envelope, gain, numSamples);
+  // dbToLinear((thresholdDb - envelopeDb) * (1 - 1 / ratio)) above the
+  // threshold, unity below. Envelopes at or near zero give meaningless
+  // logarithms here, but they are below the threshold.
+  for (int i = 0; i < numSamples; ++i) {
+    gain[i] = envelope[i] > params.thresholdLinear
+                  ? (params.thresholdLog2 - gain[i]) * params.compressionSlope
+                  : 0.0f;
   }
+  fastmath::exp2Block(gain, gain, numSamples);
+}
 
-  if (!m_isEnabled) {
-    publishBypassMeterState(inputBuffer, numSamples);
+void Compressor::finishBlock(BlockState& state, float* outputBuffer,
+                             int numSamples) {
+  const Parameters& params = state.params;
+  m_makeupGain.setSampleRate(params.sampleRate);
+  if (params.resetCount != m_appliedResetCount) {
+    m_appliedResetCount = params.resetCount;
+    m_makeupGain.reset(params.makeupGainLinear);
   }
+  if (state.enabled) {
+    m_makeupGain.setTarget(params.makeupGainLinear);
+    m_makeupGain.process(outputBuffer, outputBuffer, numSamples);
+    // Adjust output peak for makeup gain
+    state.outputPeak *= params.makeupGainLinear;
+  } else {
+    m_makeupGain.reset(params.makeupGainLinear);
+  }
+  endBlock(state);
 }
 
 void Compressor::setRatio(float ratio) {
   if (ratio > 0.0f) {
-    m_ratio = ratio;
+    m_settings.ratio = ratio;
+    publishParameters();
   }
 }
 void Compressor::setMakeupGain(float makeupGain) {
-  m_makeupGainDb = makeupGain;
-  m_makeupGainLinear = dbToLinear(makeupGain);
-}
-
-float Compressor::computeGain(float envDb, float input, float attackCoef,
-                              float releaseCoef) {
-  (void)input;  // Not used directly in gain calculation
-  (void)attackCoef;
-  (void)releaseCoef;
-
-  float gainDb = 0.0f;
-
-  if (envDb > m_thresholdDb) {
-    gainDb = (m_thresholdDb - envDb) * (1.0f - 1.0f / m_ratio);
-  }
-
-  return gainDb;
+  m_settings.makeupGainDb = makeupGain;
+  publishParameters();
 }
@@ -2,12 +2,20 @@
 #define EFFECT_COMPRESSOR_HPP
 
 #include "DynamicProcessor.hpp"
+#include "FastMath.hpp"
+#include "GainSmoother.hpp"
 
 /**
  * @brief A simple audio compressor class.
  *
  * Extends DynamicProcessor to implement compression with a configurable ratio
- * and makeup gain.
+ * and makeup gain. Makeup gain changes are ramped by a GainSmoother.
+ *
+ * Blocks are processed in chunks of kChunkSize samples and three passes:
+ * the envelope follower (serial), the gain computer (log2/exp2, vectorized
+ * with fastmath's block functions) and applying the gain with the meters.
+ * The transcendental math thus runs four samples at a time instead of
+ * sitting in the envelope follower's dependency chain.
  */
 class Compressor : public DynamicProcessor {
  public:
@@ -40,22 +48,46 @@ class Compressor : public DynamicProcessor {
   // Setters for parameters
   void setRatio(float ratio);
   void setMakeupGain(float makeupGain);
-  float getRatio() const { return m_ratio; }
-  float getMakeupGain() const { return m_makeupGainDb; }
+  float getRatio() const { return m_settings.ratio; }
+  float getMakeupGain() const { return m_settings.makeupGainDb; }
+
+  // Samples per pass of the gain computer.
+  static constexpr int kChunkSize = 64;
+
+  /**
+   * @brief Gain computer: turns a chunk of envelope values from
+   * BlockState::followEnvelope() into linear gains.
+   */
+  static void computeGain(const Parameters& params, const float* envelope,
+                          float* gain, int numSamples);
+
+  /**
+   * @brief Applies a chunk of gains from computeGain() and meters it.
+   * Makeup gain is not included, finishBlock() applies it to the whole
+   * block. The input and output may be the same buffer.
+   */
+  static void applyGain(BlockState& state, const float* inputBuffer,
+                        const float* gain, float* outputBuffer,
+                        int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+      const float output = inputBuffer[i] * gain[i];
+      state.meter(std::abs(inputBuffer[i]), output, gain[i]);
+      outputBuffer[i] = output;
+    }
+  }
+
+  /**
+   * @brief Applies makeup gain to the block's output and ends the block.
+   */
+  void finishBlock(BlockState& state, float* outputBuffer, int numSamples);
 
  protected:
   // DynamicProcessor base handles threshold, attack, release, sampleRate,
   // envelope
 
  private:
-  // Parameters
-  float m_ratio;
-  float m_makeupGainDb;
-  float m_makeupGainLinear;
-
-  // Override from DynamicProcessor
-  float computeGain(float envDb, float input, float attackCoef,
-                    float releaseCoef) override;
+  GainSmoother m_makeupGain;  // Audio thread only
+  uint32_t m_appliedResetCount = 0;
 };
 
 #endif  // EFFECT_COMPRESSOR_HPP
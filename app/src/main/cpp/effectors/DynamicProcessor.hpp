@@ -1,19 +1,32 @@
 #ifndef EFFECT_DYNAMIC_PROCESSOR_HPP
 #define EFFECT_DYNAMIC_PROCESSOR_HPP
 
+#include <algorithm>
 #include <atomic>
+#include <cmath>
+#include <cstdint>
 
 #include "AudioEffector.hpp"
+#include "ParameterTransport.hpp"
 
 /**
  * @brief Abstract base class for dynamic range processors.
  *
  * Provides common functionality shared by Compressor, Limiter, and NoiseGate:
  * - Envelope follower (peak detection with attack/release smoothing)
+ * - Block bookkeeping for the meters
  * - dB <-> linear conversion helpers
  *
- * Derived classes implement computeGain() to define their specific gain
- * reduction behavior.
+ * Every processor runs as beginBlock(), then its static per-sample or
+ * per-chunk kernels (or BlockState::bypass() when disabled), then endBlock().
+ * process() does exactly that; DynamicsEngine makes the same calls for
+ * several processors inside one loop. The per-sample state lives in a local
+ * BlockState for the duration of the block, so the compiler can keep it in
+ * registers instead of reloading members after every store to the output.
+ *
+ * Setters run on the control thread and publish a complete Parameters
+ * snapshot, including the derived coefficients; beginBlock() picks up the
+ * newest one, so the audio thread never sees a half-updated set.
  */
 class DynamicProcessor : public AudioEffector {
  public:
@@ -33,81 +46,137 @@ class DynamicProcessor : public AudioEffector {
    */
   ~DynamicProcessor() override = default;
 
-  /**
-   * @brief Processes a buffer of audio samples.
-   *
-   * Derived classes must implement computeGain() to define their specific
-   * gain reduction behavior.
-   *
-   * @param inputBuffer Pointer to the input audio buffer.
-   * @param outputBuffer Pointer to the output audio buffer.
-   * @param numSamples Number of samples in the buffer.
-   */
-  void process(const float* inputBuffer, float* outputBuffer,
-               int numSamples) override;
-
   void setSampleRate(float sampleRate) override;
 
-  void setEnabled(bool enabled) override { m_isEnabled = enabled; }
-  bool isEnabled() const override { return m_isEnabled; }
+  void setEnabled(bool enabled) override { m_isEnabled.store(enabled); }
+  bool isEnabled() const override { return m_isEnabled.load(); }
+  bool isBypassedWhenDisabled() const override { return true; }
 
   // Setters for common parameters
   void setThreshold(float threshold);
   void setAttack(float attack);
   void setRelease(float release);
 
-  float getThreshold() const { return m_thresholdDb; }
-  float getAttack() const { return m_attackMs; }
-  float getRelease() const { return m_releaseMs; }
-  float getSampleRateHz() const { return m_sampleRate; }
+  float getThreshold() const { return m_settings.thresholdDb; }
+  float getAttack() const { return m_settings.attackMs; }
+  float getRelease() const { return m_settings.releaseMs; }
+  float getSampleRateHz() const { return m_settings.sampleRate; }
   float getDetectorLevelDb() const { return m_detectorLevelDb.load(); }
   float getGainReductionDb() const { return m_gainReductionDb.load(); }
   float getInputPeakDb() const { return m_inputPeakDb.load(); }
   float getOutputPeakDb() const { return m_outputPeakDb.load(); }
   bool isActive() const { return m_isActive.load(); }
+  // Whether the envelope ended the last block at or above the threshold.
+  bool isAboveThreshold() const { return m_isAboveThreshold.load(); }
 
- protected:
-  // Common parameters
-  float m_thresholdDb;
-  float m_attackMs;
-  float m_releaseMs;
-  float m_sampleRate;
-  float m_attackCoef;
-  float m_releaseCoef;
+  /**
+   * @brief Every parameter of the processor family, with the derived
+   * coefficients, as one snapshot.
+   */
+  struct Parameters {
+    float thresholdDb = 0.0f;
+    float attackMs = 5.0f;
+    float releaseMs = 50.0f;
+    float sampleRate = 44100.0f;
+    // Compressor only.
+    float ratio = 1.0f;
+    float makeupGainDb = 0.0f;
+    // NoiseGate only.
+    float rangeDb = -80.0f;
+    // Limiter only; 0 turns look-ahead off.
+    float lookAheadMs = 0.0f;
+    // Bumped by setSampleRate(); smoothed parameters jump to their values.
+    uint32_t resetCount = 0;
+
+    // Derived by publishParameters().
+    float attackCoef = 0.0f;
+    float releaseCoef = 0.0f;
+    float thresholdLinear = 1.0f;
+    float thresholdLog2 = 0.0f;
+    float compressionSlope = 0.0f;  // 1 - 1 / ratio
+    float makeupGainLinear = 1.0f;
+    float rangeLinear = 0.0f;
+  };
 
-  // Internal state
-  float m_envelope;
+  /**
+   * @brief Parameters and running state of one block.
+   */
+  struct BlockState {
+    Parameters params;
+    bool enabled = false;
+    float envelope = 0.0f;
+    float gain = 1.0f;  // NoiseGate's smoothed gain
+    // Meters, in linear units.
+    float inputPeak = 0.0f;
+    float outputPeak = 0.0f;
+    float minGain = 1.0f;
+
+    /**
+     * @brief Advances the envelope follower by one sample.
+     */
+    float followEnvelope(float level) {
+      const float coef =
+          level > envelope ? params.attackCoef : params.releaseCoef;
+      envelope = coef * envelope + (1.0f - coef) * level;
+      return envelope;
+    }
+
+    /**
+     * @brief Accounts for one processed sample in the meters.
+     */
+    void meter(float inputLevel, float output, float gainLinear) {
+      inputPeak = std::max(inputPeak, inputLevel);
+      outputPeak = std::max(outputPeak, std::abs(output));
+      minGain = std::min(minGain, gainLinear);
+    }
+
+    /**
+     * @brief Accounts for a sample passed through unchanged while bypassed.
+     */
+    void bypass(float input) {
+      inputPeak = std::max(inputPeak, std::abs(input));
+    }
+  };
 
-  bool m_isEnabled = false;
+  /**
+   * @brief Starts a block: picks up the newest parameters and returns them
+   * with the running state. Audio thread only.
+   */
+  BlockState beginBlock();
 
   /**
-   * @brief Compute the gain reduction for the current envelope level.
-   *
-   * @param envDb Current envelope level in dB.
-   * @param input Current input sample absolute value.
-   * @param attackCoef Attack coefficient for smoothing.
-   * @param releaseCoef Release coefficient for smoothing.
-   * @return Gain reduction in dB (typically <= 0.0f).
+   * @brief Stores the running state of a block and publishes its meters.
    */
-  virtual float computeGain(float envDb, float input, float attackCoef,
-                            float releaseCoef) = 0;
+  void endBlock(const BlockState& state);
 
-  virtual void publishMeterState(float detectorLevelLinear,
-                                 float inputPeakLinear, float outputPeakLinear,
-                                 float gainReductionDb, bool isActive);
-  void publishBypassMeterState(const float* inputBuffer, int numSamples);
+ protected:
+  /**
+   * @brief Derives the coefficients of m_settings and publishes it to the
+   * audio thread. Call after every change.
+   */
+  void publishParameters();
+
+  // Control-side copy of the parameters; the getters read it.
+  Parameters m_settings;
+
+  // Internal state
+  float m_envelope;
+  float m_gain = 1.0f;  // NoiseGate only
+
+  std::atomic<bool> m_isEnabled{false};
 
   // Helper functions
   float dbToLinear(float db);
   float linearToDb(float linear);
 
-  std::atomic<float> m_outputPeakDb;
-
  private:
+  ParameterTransport<Parameters> m_parameters;
   std::atomic<float> m_detectorLevelDb;
   std::atomic<float> m_gainReductionDb;
   std::atomic<float> m_inputPeakDb;
+  std::atomic<float> m_outputPeakDb;
   std::atomic<bool> m_isActive;
+  std::atomic<bool> m_isAboveThreshold{false};
 };
 
 #endif  // EFFECT_DYNAMIC_PROCESSOR_HPP
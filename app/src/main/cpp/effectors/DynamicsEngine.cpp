@@ -0,0 +1,86 @@
+#include "DynamicsEngine.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+DynamicsEngine::DynamicsEngine(std::shared_ptr<NoiseGate> noiseGate,
+                               std::shared_ptr<Compressor> compressor)
+    : m_noiseGate(std::move(noiseGate)), m_compressor(std::move(compressor)) {}
+
+void DynamicsEngine::process(const float* inputBuffer, float* outputBuffer,
+                             int numSamples) {
+  DynamicProcessor::BlockState gate = m_noiseGate->beginBlock();
+  DynamicProcessor::BlockState compressor = m_compressor->beginBlock();
+  if (gate.enabled && compressor.enabled) {
+    processFused<true, true>(gate, compressor, inputBuffer, outputBuffer,
+                             numSamples);
+  } else if (gate.enabled) {
+    processFused<true, false>(gate, compressor, inputBuffer, outputBuffer,
+                              numSamples);
+  } else if (compressor.enabled) {
+    processFused<false, true>(gate, compressor, inputBuffer, outputBuffer,
+                              numSamples);
+  } else {
+    processFused<false, false>(gate, compressor, inputBuffer, outputBuffer,
+                               numSamples);
+  }
+  m_noiseGate->endBlock(gate);
+  m_compressor->finishBlock(compressor, outputBuffer, numSamples);
+}
+
+template <bool kGate, bool kCompressor>
+void DynamicsEngine::processFused(DynamicProcessor::BlockState& gate,
+                                  DynamicProcessor::BlockState& compressor,
+                                  const float* inputBuffer,
+                                  float* outputBuffer, int numSamples) {
+  auto gateSample = [&gate](float sample) {
+    if constexpr (kGate) {
+      return NoiseGate::processSample(gate, sample);
+    } else {
+      gate.bypass(sample);
+      return sample;
+    }
+  };
+
+  if constexpr (!kCompressor) {
+    for (int i = 0; i < numSamples; ++i) {
+      const float sample = gateSample(inputBuffer[i]);
+      compressor.bypass(sample);
+      outputBuffer[i] = sample;
+    }
+    return;
+  }
+
+  // Both detectors in the serial pass, then the compressor's vectorized
+  // gain computer over the gated chunk.
+  std::array<float, Compressor::kChunkSize> envelope;
+  std::array<float, Compressor::kChunkSize> gain;
+  for (int offset = 0; offset < numSamples; offset += Compressor::kChunkSize) {
+    const int n = std::min(Compressor::kChunkSize, numSamples - offset);
+    float* output = outputBuffer + offset;
+    for (int i = 0; i < n; ++i) {
+      const float sample = gateSample(inputBuffer[offset + i]);
+      envelope[i] = compressor.followEnvelope(std::abs(sample));
+      output[i] = sample;
+    }
+    Compressor::computeGain(compressor.params, envelope.data(), gain.data(),
+                            n);
+    Compressor::applyGain(compressor, output, gain.data(), output, n);
+  }
+}
+
+void DynamicsEngine::setSampleRate(float sampleRate) {
+  m_noiseGate->setSampleRate(sampleRate);
+  m_compressor->setSampleRate(sampleRate);
+}
+
+void DynamicsEngine::setEnabled(bool enabled) {
+  m_noiseGate->setEnabled(enabled);
+  m_compressor->setEnabled(enabled);
+}
+
+bool DynamicsEngine::isEnabled() const {
+  return m_noiseGate->isEnabled() || m_compressor->isEnabled();
+}
@@ -0,0 +1,52 @@
+#ifndef EFFECT_DYNAMICS_ENGINE_HPP
+#define EFFECT_DYNAMICS_ENGINE_HPP
+
+#include <memory>
+
+#include "AudioEffector.hpp"
+#include "Compressor.hpp"
+#include "NoiseGate.hpp"
+
+/**
+ * @brief Runs a NoiseGate followed by a Compressor in a single pass.
+ *
+ * Replaces the two separate chain stages: each sample goes through the
+ * gate's and then the compressor's detector and gain in one loop, so the
+ * block is read and written once instead of twice. The gate and the
+ * compressor stay separate objects that own their parameters, enabled flags
+ * and meters, so the JNI setters and getters keep addressing them directly;
+ * the output is the same as running them one after the other.
+ */
+class DynamicsEngine : public AudioEffector {
+ public:
+  DynamicsEngine(std::shared_ptr<NoiseGate> noiseGate,
+                 std::shared_ptr<Compressor> compressor);
+
+  void process(const float* inputBuffer, float* outputBuffer,
+               int numSamples) override;
+
+  void setSampleRate(float sampleRate) override;
+
+  /**
+   * @brief Enables or disables both processors, as AudioEffectorChain does.
+   */
+  void setEnabled(bool enabled) override;
+
+  /**
+   * @brief True if either processor is enabled.
+   */
+  bool isEnabled() const override;
+  bool isBypassedWhenDisabled() const override { return true; }
+
+ private:
+  template <bool kGate, bool kCompressor>
+  static void processFused(DynamicProcessor::BlockState& gate,
+                           DynamicProcessor::BlockState& compressor,
+                           const float* inputBuffer, float* outputBuffer,
+                           int numSamples);
+
+  std::shared_ptr<NoiseGate> m_noiseGate;
+  std::shared_ptr<Compressor> m_compressor;
+};
+
+#endif  // EFFECT_DYNAMICS_ENGINE_HPP
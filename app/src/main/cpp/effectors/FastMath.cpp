@@ -0,0 +1,173 @@
+#include "FastMath.hpp"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace fastmath {
+namespace {
+#if defined(__ARM_NEON)
+using Float4 = float32x4_t;
+using Int4 = int32x4_t;
+
+inline Float4 load4(const float* p) { return vld1q_f32(p); }
+inline void store4(float* p, Float4 v) { vst1q_f32(p, v); }
+inline Float4 splat(float x) { return vdupq_n_f32(x); }
+inline Float4 add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+inline Float4 mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+// acc + a * b.
+#if defined(__aarch64__)
+inline Float4 mulAdd(Float4 acc, Float4 a, Float4 b) {
+  return vfmaq_f32(acc, a, b);
+}
+#else
+inline Float4 mulAdd(Float4 acc, Float4 a, Float4 b) {
+  return vmlaq_f32(acc, a, b);
+}
+#endif
+inline Float4 clamp(Float4 x, float lo, float hi) {
+  return vminq_f32(vmaxq_f32(x, splat(lo)), splat(hi));
+}
+inline Int4 bitsOf(Float4 v) { return vreinterpretq_s32_f32(v); }
+inline Float4 floatOf(Int4 v) { return vreinterpretq_f32_s32(v); }
+inline Int4 splatInt(int32_t x) { return vdupq_n_s32(x); }
+inline Int4 addInt(Int4 a, Int4 b) { return vaddq_s32(a, b); }
+inline Int4 subInt(Int4 a, Int4 b) { return vsubq_s32(a, b); }
+inline Int4 andInt(Int4 a, Int4 b) { return vandq_s32(a, b); }
+inline Int4 orInt(Int4 a, Int4 b) { return vorrq_s32(a, b); }
+template <int kShift>
+inline Int4 shiftRightArithmetic(Int4 v) {
+  return vshrq_n_s32(v, kShift);
+}
+template <int kShift>
+inline Int4 shiftLeft(Int4 v) {
+  return vshlq_n_s32(v, kShift);
+}
+inline Float4 toFloat(Int4 v) { return vcvtq_f32_s32(v); }
+inline Int4 truncate(Float4 v) { return vcvtq_s32_f32(v); }
+#elif defined(__SSE2__)
+using Float4 = __m128;
+using Int4 = __m128i;
+
+inline Float4 load4(const float* p) { return _mm_loadu_ps(p); }
+inline void store4(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+inline Float4 splat(float x) { return _mm_set1_ps(x); }
+inline Float4 add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 mulAdd(Float4 acc, Float4 a, Float4 b) {
+  return _mm_add_ps(acc, _mm_mul_ps(a, b));
+}
+inline Float4 clamp(Float4 x, float lo, float hi) {
+  return _mm_min_ps(_mm_max_ps(x, splat(lo)), splat(hi));
+}
+inline Int4 bitsOf(Float4 v) { return _mm_castps_si128(v); }
+inline Float4 floatOf(Int4 v) { return _mm_castsi128_ps(v); }
+inline Int4 splatInt(int32_t x) { return _mm_set1_epi32(x); }
+inline Int4 addInt(Int4 a, Int4 b) { return _mm_add_epi32(a, b); }
+inline Int4 subInt(Int4 a, Int4 b) { return _mm_sub_epi32(a, b); }
+inline Int4 andInt(Int4 a, Int4 b) { return _mm_and_si128(a, b); }
+inline Int4 orInt(Int4 a, Int4 b) { return _mm_or_si128(a, b); }
+template <int kShift>
+inline Int4 shiftRightArithmetic(Int4 v) {
+  return _mm_srai_epi32(v, kShift);
+}
+template <int kShift>
+inline Int4 shiftLeft(Int4 v) {
+  return _mm_slli_epi32(v, kShift);
+}
+inline Float4 toFloat(Int4 v) { return _mm_cvtepi32_ps(v); }
+inline Int4 truncate(Float4 v) { return _mm_cvttps_epi32(v); }
+#endif
+
+#if defined(__ARM_NEON) || defined(__SSE2__)
+constexpr int kVectorSize = 4;
+
+// Four lanes of fastLog2(), operation for operation.
+inline Float4 log2x4(Float4 x) {
+  const Int4 offset = subInt(bitsOf(x), splatInt(0x3f3504f3));
+  const Float4 exponent = toFloat(shiftRightArithmetic<23>(offset));
+  const Float4 t =
+      sub(floatOf(addInt(andInt(offset, splatInt(0x007fffff)),
+                         splatInt(0x3f3504f3))),
+          splat(1.0f));
+  Float4 p = splat(-0.206591638f);
+  p = mulAdd(splat(0.322154775f), p, t);
+  p = mulAdd(splat(-0.367489994f), p, t);
+  p = mulAdd(splat(0.479348021f), p, t);
+  p = mulAdd(splat(-0.721131858f), p, t);
+  p = mulAdd(splat(1.44271348f), p, t);
+  return mulAdd(exponent, p, t);
+}
+
+// Four lanes of fastExp2(), operation for operation.
+inline Float4 exp2x4(Float4 x) {
+  x = clamp(x, -126.0f, 126.0f);
+  // +-0.5 with the sign of x, then truncate: round half away from zero.
+  const Int4 half = orInt(bitsOf(splat(0.5f)),
+                          andInt(bitsOf(x), splatInt(INT32_MIN)));
+  const Int4 exponent = truncate(add(x, floatOf(half)));
+  const Float4 f = sub(x, toFloat(exponent));
+  Float4 p = splat(0.0013410005f);
+  p = mulAdd(splat(0.00967603636f), p, f);
+  p = mulAdd(splat(0.055502973f), p, f);
+  p = mulAdd(splat(0.240221074f), p, f);
+  p = mulAdd(splat(0.693147225f), p, f);
+  p = mulAdd(splat(1.0f), p, f);
+  return mul(p, floatOf(shiftLeft<23>(addInt(exponent, splatInt(127)))));
+}
+#endif
+}  // namespace
+
+void log2Block(const float* input, float* output, int numSamples) {
+  int i = 0;
+#if defined(__ARM_NEON) || defined(__SSE2__)
+  for (; i + kVectorSize <= numSamples; i += kVectorSize) {
+    store4(output + i, log2x4(load4(input + i)));
+  }
+#endif
+  for (; i < numSamples; ++i) {
+    output[i] = fastLog2(input[i]);
+  }
+}
+
+void exp2Block(const float* input, float* output, int numSamples) {
+  int i = 0;
+#if defined(__ARM_NEON) || defined(__SSE2__)
+  for (; i + kVectorSize <= numSamples; i += kVectorSize) {
+    store4(output + i, exp2x4(load4(input + i)));
+  }
+#endif
+  for (; i < numSamples; ++i) {
+    output[i] = fastExp2(input[i]);
+  }
+}
+
+void dbToLinearBlock(const float* input, float* output, int numSamples) {
+  int i = 0;
+#if defined(__ARM_NEON) || defined(__SSE2__)
+  for (; i + kVectorSize <= numSamples; i += kVectorSize) {
+    store4(output + i, exp2x4(mul(load4(input + i), splat(kDbToLog2))));
+  }
+#endif
+  for (; i < numSamples; ++i) {
+    output[i] = fastDbToLinear(input[i]);
+  }
+}
+
+void linearToDbBlock(const float* input, float* output, int numSamples) {
+  int i = 0;
+#if defined(__ARM_NEON) || defined(__SSE2__)
+  for (; i + kVectorSize <= numSamples; i += kVectorSize) {
+    store4(output + i, mul(log2x4(load4(input + i)), splat(kLog2ToDb)));
+  }
+#endif
+  for (; i < numSamples; ++i) {
+    output[i] = fastLinearToDb(input[i]);
+  }
+}
+
+}  // namespace fastmath
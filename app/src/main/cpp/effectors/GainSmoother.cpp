@@ -0,0 +1,51 @@
+#include "GainSmoother.hpp"
+
+#include <algorithm>
+
+GainSmoother::GainSmoother(float initialGain, float rampTimeMs)
+    : m_rampTimeMs(rampTimeMs), m_current(initialGain), m_target(initialGain) {
+  setSampleRate(44100.0f);
+}
+
+void GainSmoother::setSampleRate(float sampleRate) {
+  if (sampleRate == m_sampleRate) return;
+  m_sampleRate = sampleRate;
+  m_rampLength =
+      std::max(1, static_cast<int>(sampleRate * m_rampTimeMs / 1000.0f));
+}
+
+void GainSmoother::setTarget(float gain) {
+  if (gain == m_target) return;
+  m_target = gain;
+  m_remaining = m_rampLength;
+  m_step = (m_target - m_current) / static_cast<float>(m_rampLength);
+}
+
+void GainSmoother::reset(float gain) {
+  m_current = gain;
+  m_target = gain;
+  m_remaining = 0;
+}
+
+void GainSmoother::process(const float* inputBuffer, float* outputBuffer,
+                           int numSamples) {
+  int i = 0;
+  if (m_remaining > 0) {
+    const int rampSamples = std::min(numSamples, m_remaining);
+    const float start = m_current;
+    const float step = m_step;
+    for (; i < rampSamples; ++i) {
+      outputBuffer[i] =
+          inputBuffer[i] * (start + step * static_cast<float>(i + 1));
+    }
+    m_remaining -= rampSamples;
+    // Land exactly on the target rather than on the accumulated steps.
+    m_current = m_remaining == 0
+                    ? m_target
+                    : start + step * static_cast<float>(rampSamples);
+  }
+  const float gain = m_current;
+  for (; i < numSamples; ++i) {
+    outputBuffer[i] = inputBuffer[i] * gain;
+  }
+}
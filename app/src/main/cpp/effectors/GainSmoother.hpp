@@ -0,0 +1,57 @@
+#ifndef EFFECT_GAIN_SMOOTHER_HPP
+#define EFFECT_GAIN_SMOOTHER_HPP
+
+/**
+ * @brief Applies a linear gain that ramps to new targets instead of jumping.
+ *
+ * setTarget() starts a linear ramp, in the linear-amplitude domain, from the
+ * gain currently applied to the new target over the ramp time, so slider
+ * moves do not produce zipper noise. process() runs the ramp and the steady
+ * state as two branch-free loops the compiler vectorizes; once the ramp has
+ * finished the cost is that of a plain gain.
+ *
+ * Audio thread only; pass new targets over a ParameterTransport.
+ */
+class GainSmoother {
+ public:
+  static constexpr float kDefaultRampTimeMs = 20.0f;
+
+  explicit GainSmoother(float initialGain = 1.0f,
+                        float rampTimeMs = kDefaultRampTimeMs);
+
+  /**
+   * @brief Sets the sample rate the ramp time refers to. A ramp in progress
+   * keeps its length.
+   */
+  void setSampleRate(float sampleRate);
+
+  /**
+   * @brief Ramps from the current gain to gain.
+   */
+  void setTarget(float gain);
+
+  /**
+   * @brief Jumps to gain, cancelling any ramp.
+   */
+  void reset(float gain);
+
+  float getTarget() const { return m_target; }
+  bool isSmoothing() const { return m_remaining > 0; }
+
+  /**
+   * @brief outputBuffer = inputBuffer * gain, advancing the ramp. The buffers
+   * may be the same.
+   */
+  void process(const float* inputBuffer, float* outputBuffer, int numSamples);
+
+ private:
+  float m_rampTimeMs;
+  float m_sampleRate = 0.0f;
+  int m_rampLength = 1;
+  float m_current;
+  float m_target;
+  float m_step = 0.0f;
+  int m_remaining = 0;
+};
+
+#endif  // EFFECT_GAIN_SMOOTHER_HPP
@@ -0,0 +1,151 @@
+#include "HotSwapEffector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <thread>
+#include <utility>
+
+HotSwapEffector::HotSwapEffector(std::shared_ptr<AudioEffector> effector,
+                                 float crossfadeMs)
+    : m_crossfadeMs(crossfadeMs),
+      m_current(std::move(effector)),
+      m_owned{m_current},
+      m_active(m_current.get()) {}
+
+void HotSwapEffector::process(const float* inputBuffer, float* outputBuffer,
+                              int numSamples) {
+  // Take a new effector only once the previous crossfade has been collected,
+  // so at most two effectors are ever live here.
+  if (m_fadingOut == nullptr && m_retired.load() == nullptr) {
+    AudioEffector* next = m_pending.exchange(nullptr);
+    if (next != nullptr) {
+      m_fadingOut = m_active;
+      m_active = next;
+      m_fadePosition = 0;
+    }
+  }
+  if (m_fadingOut == nullptr) {
+    m_active->process(inputBuffer, outputBuffer, numSamples);
+    return;
+  }
+
+  int processed = 0;
+  while (processed < numSamples && m_fadingOut != nullptr) {
+    const int len = std::min(kChunkSize, numSamples - processed);
+    // The old effector reads the input before the new one may overwrite it.
+    m_fadingOut->process(&inputBuffer[processed], m_fadeBuffer.data(), len);
+    m_active->process(&inputBuffer[processed], &outputBuffer[processed], len);
+    for (int i = 0; i < len; ++i) {
+      // Equal-power: the two models' outputs are largely uncorrelated.
+      const float t =
+          std::min(static_cast<float>(m_fadePosition + i) / m_fadeLength,
+                   1.0f) *
+          (std::numbers::pi_v<float> * 0.5f);
+      outputBuffer[processed + i] = outputBuffer[processed + i] * std::sin(t) +
+                                    m_fadeBuffer[i] * std::cos(t);
+    }
+    m_fadePosition += len;
+    processed += len;
+    if (m_fadePosition >= m_fadeLength) {
+      m_retired.store(m_fadingOut);
+      m_fadingOut = nullptr;
+    }
+  }
+  if (processed < numSamples) {
+    m_active->process(&inputBuffer[processed], &outputBuffer[processed],
+                      numSamples - processed);
+  }
+}
+
+void HotSwapEffector::setSampleRate(float sampleRate) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_fadeLength =
+      std::max(static_cast<int>(m_crossfadeMs * sampleRate / 1000.0f), 1);
+  adopt(m_current);
+  m_current->setSampleRate(sampleRate);
+}
+
+void HotSwapEffector::setEnabled(bool enabled) {
+  getEffector()->setEnabled(enabled);
+}
+
+bool HotSwapEffector::isEnabled() const {
+  return getEffector()->isEnabled();
+}
+
+bool HotSwapEffector::isBypassedWhenDisabled() const {
+  // isEnabled() takes m_mutex, which the audio thread must not.
+  return false;
+}
+
+int HotSwapEffector::getLatencyFrames() const {
+  return getEffector()->getLatencyFrames();
+}
+
+void HotSwapEffector::setEffector(std::shared_ptr<AudioEffector> effector) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_current = std::move(effector);
+  adopt(m_current);
+}
+
+void HotSwapEffector::swap(std::shared_ptr<AudioEffector> effector) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  collectRetired();
+  m_owned.push_back(effector);
+  // A swap the audio thread never picked up is simply superseded.
+  AudioEffector* superseded = m_pending.exchange(effector.get());
+  if (superseded != nullptr) {
+    release(superseded);
+  }
+  m_current = std::move(effector);
+}
+
+bool HotSwapEffector::waitForSwap(int timeoutMs) {
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      collectRetired();
+      // Only the newest effector is left once nothing is pending or fading.
+      if (m_owned.size() <= 1) {
+        return true;
+      }
+    }
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+}
+
+std::shared_ptr<AudioEffector> HotSwapEffector::getEffector() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_current;
+}
+
+void HotSwapEffector::adopt(const std::shared_ptr<AudioEffector>& effector) {
+  m_pending.store(nullptr);
+  m_retired.store(nullptr);
+  m_active = effector.get();
+  m_fadingOut = nullptr;
+  m_owned.assign(1, effector);
+}
+
+void HotSwapEffector::collectRetired() {
+  AudioEffector* retired = m_retired.exchange(nullptr);
+  if (retired != nullptr) {
+    release(retired);
+  }
+}
+
+void HotSwapEffector::release(const AudioEffector* effector) {
+  const auto it = std::find_if(
+      m_owned.begin(), m_owned.end(),
+      [effector](const auto& owned) { return owned.get() == effector; });
+  if (it != m_owned.end()) {
+    m_owned.erase(it);
+  }
+}
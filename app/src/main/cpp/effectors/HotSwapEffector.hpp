@@ -0,0 +1,110 @@
+#ifndef EFFECT_HOT_SWAP_EFFECTOR_HPP
+#define EFFECT_HOT_SWAP_EFFECTOR_HPP
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "AudioEffector.hpp"
+
+/**
+ * @brief A chain slot whose effector can be replaced while audio runs.
+ *
+ * swap() hands a new, fully prepared effector to the audio thread, which
+ * picks it up at the next block boundary and crossfades from the old one to
+ * the new one over the crossfade time. Both run during the crossfade; after
+ * it the old one is retired and released on a control thread, never on the
+ * audio thread. The audio thread only exchanges raw pointers with the
+ * control side; the control side keeps every effector it may still touch
+ * alive.
+ *
+ * The slot forwards setEnabled(), isEnabled() and getLatencyFrames() to the
+ * newest effector. It is never skipped while disabled, as isEnabled() takes
+ * a lock.
+ */
+class HotSwapEffector : public AudioEffector {
+ public:
+  static constexpr int kChunkSize = 256;
+  static constexpr float kDefaultCrossfadeMs = 20.0f;
+
+  explicit HotSwapEffector(std::shared_ptr<AudioEffector> effector,
+                           float crossfadeMs = kDefaultCrossfadeMs);
+
+  void process(const float* inputBuffer, float* outputBuffer,
+               int numSamples) override;
+
+  /**
+   * @brief Forwards the rate to the newest effector; a swap that the audio
+   * thread has not picked up yet completes without a crossfade. Only while
+   * the audio thread is stopped.
+   */
+  void setSampleRate(float sampleRate) override;
+
+  void setEnabled(bool enabled) override;
+  bool isEnabled() const override;
+  bool isBypassedWhenDisabled() const override;
+  int getLatencyFrames() const override;
+
+  /**
+   * @brief Replaces the effector at once. Only while the audio thread is
+   * stopped.
+   */
+  void setEffector(std::shared_ptr<AudioEffector> effector);
+
+  /**
+   * @brief Replaces the effector at the next block boundary, with a
+   * crossfade. Control thread.
+   *
+   * @param effector Must already be prepared for the running sample rate;
+   * process() is called on it right away.
+   */
+  void swap(std::shared_ptr<AudioEffector> effector);
+
+  /**
+   * @brief Waits until the audio thread has finished the last swap and
+   * releases the effector it replaced. Control thread.
+   *
+   * @return False on timeout, e.g. when the audio thread is not running;
+   * the old effector is then released by a later call.
+   */
+  bool waitForSwap(int timeoutMs);
+
+  /**
+   * @brief The newest effector, swapped in or not yet picked up.
+   */
+  std::shared_ptr<AudioEffector> getEffector() const;
+
+ private:
+  // The following run under m_mutex.
+  // Makes effector the only one, dropping any swap in flight. Only while
+  // the audio thread is stopped.
+  void adopt(const std::shared_ptr<AudioEffector>& effector);
+  // Releases the effector the audio thread has retired, if any.
+  void collectRetired();
+  void release(const AudioEffector* effector);
+
+  const float m_crossfadeMs;
+
+  // Control side, under m_mutex.
+  mutable std::mutex m_mutex;
+  std::shared_ptr<AudioEffector> m_current;
+  // Everything the audio thread may still touch.
+  std::vector<std::shared_ptr<AudioEffector>> m_owned;
+
+  // Handed from the control side to the audio thread.
+  std::atomic<AudioEffector*> m_pending{nullptr};
+  // Handed back once the crossfade has ended; the audio thread takes no new
+  // effector until the control side has collected it.
+  std::atomic<AudioEffector*> m_retired{nullptr};
+
+  // Audio thread.
+  AudioEffector* m_active;
+  AudioEffector* m_fadingOut = nullptr;
+  int m_fadePosition = 0;
+  int m_fadeLength = 1;
+  std::array<float, kChunkSize> m_fadeBuffer{};
+};
+
+#endif  // EFFECT_HOT_SWAP_EFFECTOR_HPP
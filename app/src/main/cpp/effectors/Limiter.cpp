@@ -1,51 +1,196 @@
 #include "Limiter.hpp"
 
 #include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr int kOversampling = 4;
+// Taps per phase of the true-peak interpolator.
+constexpr int kTruePeakTaps = 8;
+// The interpolator needs kTruePeakTaps / 2 samples after the point it
+// interpolates, so true peaks are detected this many frames late.
+constexpr int kTruePeakDelay = kTruePeakTaps / 2;
+using TruePeakPhases =
+    std::array<std::array<float, kTruePeakTaps>, kOversampling - 1>;
+
+// Hann-windowed sinc interpolators for the three points between two
+// samples, each normalized to unity gain at DC. Phase j interpolates
+// x[n - 4 + j / 4] from x[n - 7] .. x[n].
+TruePeakPhases makeTruePeakPhases() {
+  constexpr double kHalfWidth = kTruePeakTaps / 2 + 0.5;
+  TruePeakPhases phases{};
+  for (int j = 1; j < kOversampling; ++j) {
+    double sum = 0.0;
+    std::array<double, kTruePeakTaps> taps{};
+    for (int k = 0; k < kTruePeakTaps; ++k) {
+      const double distance =
+          kTruePeakTaps / 2 - 1 + static_cast<double>(j) / kOversampling - k;
+      const double sinc = std::sin(M_PI * distance) / (M_PI * distance);
+      const double window =
+          0.5 * (1.0 + std::cos(M_PI * distance / kHalfWidth));
+      taps[k] = sinc * window;
+      sum += taps[k];
+    }
+    for (int k = 0; k < kTruePeakTaps; ++k) {
+      phases[j - 1][k] = static_cast<float>(taps[k] / sum);
+    }
+  }
+  return phases;
+}
+
+const TruePeakPhases kTruePeakPhases = makeTruePeakPhases();
+}  // namespace
 
 Limiter::Limiter(float threshold, float attack, float release, float sampleRate)
     : DynamicProcessor(threshold, attack, release, sampleRate) {}
 
 void Limiter::process(const float* inputBuffer, float* outputBuffer,
                       int numSamples) {
-  if (m_isEnabled) {
-    // Delegate all processing to base class (envelope follower + gain)
-    DynamicProcessor::process(inputBuffer, outputBuffer, numSamples);
+  BlockState state = beginBlock();
+  bool hardClip = false;
+  const int frames = state.enabled ? lookAheadFrames(state.params) : 0;
+  if (frames != m_lookAheadFrames ||
+      state.params.resetCount != m_appliedResetCount) {
+    // Starts from silence: a new delay cannot continue the old one.
+    m_appliedResetCount = state.params.resetCount;
+    resetLookAhead(frames);
+  }
 
-    // Enforce hard output ceiling so peaks do not exceed the limiter threshold.
-    const float thresholdLinear = dbToLinear(m_thresholdDb);
-    bool hardClipActive = false;
+  if (frames > 0) {
+    processLookAhead(state, hardClip, inputBuffer, outputBuffer, numSamples);
+  } else if (state.enabled) {
+    // Envelope follower, gain and hard ceiling in one pass
     for (int i = 0; i < numSamples; ++i) {
-      const float clampedOutput =
-          std::clamp(outputBuffer[i], -thresholdLinear, thresholdLinear);
-      hardClipActive = hardClipActive || (clampedOutput != outputBuffer[i]);
-      outputBuffer[i] = clampedOutput;
+      outputBuffer[i] = processSample(state, hardClip, inputBuffer[i]);
+    }
+  } else {
+    for (int i = 0; i < numSamples; ++i) {
+      state.bypass(inputBuffer[i]);
+    }
+    if (inputBuffer != outputBuffer) {
+      // Bypass: copy input to output
+      std::copy(inputBuffer, inputBuffer + numSamples, outputBuffer);
     }
-
-    m_hardClipActive.store(hardClipActive);
-  } else if (inputBuffer != outputBuffer) {
-    // Bypass: copy input to output
-    std::copy(inputBuffer, inputBuffer + numSamples, outputBuffer);
   }
+  m_hardClipActive.store(hardClip);
+  endBlock(state);
+}
+
+void Limiter::processLookAhead(BlockState& state, bool& hardClip,
+                               const float* inputBuffer, float* outputBuffer,
+                               int numSamples) {
+  const float threshold = state.params.thresholdLinear;
+  const float releaseCoef = state.params.releaseCoef;
+  // A peak detected at position p must be fully applied when its sample is
+  // output at p + window - 1: every gain averaged then comes from a window
+  // that contains p.
+  const uint32_t window = static_cast<uint32_t>(m_lookAheadFrames) + 1;
+  const uint32_t delay = static_cast<uint32_t>(m_lookAheadFrames) +
+                         static_cast<uint32_t>(kTruePeakDelay);
+  const double inverseWindow = 1.0 / window;
+
+  // Running state in locals, so that stores to the output do not force
+  // reloads.
+  uint32_t position = m_position;
+  uint32_t head = m_peakQueueHead;
+  uint32_t tail = m_peakQueueTail;
+  float releaseGain = m_releaseGain;
+  double gainSum = m_gainSum;
+  float windowPeak = state.envelope;
+
+  for (int i = 0; i < numSamples; ++i) {
+    const float input = inputBuffer[i];
+    m_delayLine[position & kRingMask] = input;
 
-  if (!m_isEnabled) {
-    publishBypassMeterState(inputBuffer, numSamples);
-    m_hardClipActive.store(false);
+    // Sliding-window maximum of the true peak.
+    const float peak = truePeak(position);
+    while (tail != head && m_peakQueue[(tail - 1) & kRingMask] <= peak) {
+      --tail;
+    }
+    m_peakQueue[tail & kRingMask] = peak;
+    m_peakQueuePosition[tail & kRingMask] = position;
+    ++tail;
+    if (position - m_peakQueuePosition[head & kRingMask] >= window) {
+      ++head;
+    }
+    windowPeak = m_peakQueue[head & kRingMask];
+
+    // Drop instantly, recover with the release time. The result never
+    // exceeds the gain the window's peak needs.
+    const float targetGain =
+        windowPeak > threshold ? threshold / windowPeak : 1.0f;
+    releaseGain =
+        targetGain < releaseGain
+            ? targetGain
+            : releaseCoef * releaseGain + (1.0f - releaseCoef) * targetGain;
+
+    // Moving average over the window.
+    gainSum += releaseGain - m_gainHistory[(position - window) & kRingMask];
+    m_gainHistory[position & kRingMask] = releaseGain;
+    const float gain =
+        std::min(static_cast<float>(gainSum * inverseWindow), 1.0f);
+
+    const float output = m_delayLine[(position - delay) & kRingMask] * gain;
+    const float clampedOutput = std::clamp(output, -threshold, threshold);
+    hardClip = hardClip || clampedOutput != output;
+    state.meter(std::abs(input), clampedOutput, gain);
+    outputBuffer[i] = clampedOutput;
+    ++position;
   }
+
+  m_position = position;
+  m_peakQueueHead = head;
+  m_peakQueueTail = tail;
+  m_releaseGain = releaseGain;
+  m_gainSum = gainSum;
+  state.envelope = windowPeak;
 }
 
-float Limiter::computeGain(float envDb, float input, float attackCoef,
-                           float releaseCoef) {
-  (void)attackCoef;
-  (void)releaseCoef;
+void Limiter::resetLookAhead(int lookAheadFrames) {
+  m_lookAheadFrames = lookAheadFrames;
+  m_position = 0;
+  m_delayLine.fill(0.0f);
+  m_peakQueueHead = 0;
+  m_peakQueueTail = 0;
+  m_gainHistory.fill(1.0f);
+  m_gainSum = lookAheadFrames + 1;
+  m_releaseGain = 1.0f;
+}
 
-  // Use the larger of envelope and current input peak for faster limiting.
-  const float detectorDb = std::max(envDb, linearToDb(input));
+float Limiter::truePeak(uint32_t newest) const {
+  // The interpolated points lie between the samples kTruePeakDelay and
+  // kTruePeakDelay - 1 frames before the newest one.
+  const uint32_t oldest = newest - (kTruePeakTaps - 1);
+  std::array<float, kTruePeakTaps> history;
+  for (int k = 0; k < kTruePeakTaps; ++k) {
+    history[k] = m_delayLine[(oldest + k) & kRingMask];
+  }
+  float peak = std::abs(history[kTruePeakTaps - 1 - kTruePeakDelay]);
+  for (const auto& phase : kTruePeakPhases) {
+    float value = 0.0f;
+    for (int k = 0; k < kTruePeakTaps; ++k) {
+      value += phase[k] * history[k];
+    }
+    peak = std::max(peak, std::abs(value));
+  }
+  return peak;
+}
 
-  float gainDb = 0.0f;
-  if (detectorDb > m_thresholdDb) {
-    // Infinite-ratio style limiting above threshold.
-    gainDb = m_thresholdDb - detectorDb;
+int Limiter::lookAheadFrames(const Parameters& params) {
+  if (params.lookAheadMs <= 0.0f) {
+    return 0;
   }
+  const int frames = static_cast<int>(
+      std::lround(params.sampleRate * params.lookAheadMs / 1000.0f));
+  return std::clamp(frames, 1, kRingSize - kTruePeakTaps - 1);
+}
 
-  return gainDb;
-}
\ No newline at end of file
+void Limiter::setLookAhead(float lookAheadMs) {
+  m_settings.lookAheadMs = std::clamp(lookAheadMs, 0.0f, kMaxLookAheadMs);
+  publishParameters();
+}
+
+int Limiter::getLatencyFrames() const {
+  const int frames = lookAheadFrames(m_settings);
+  return isEnabled() && frames > 0 ? frames + kTruePeakDelay : 0;
+}
@@ -1,7 +1,9 @@
 #ifndef EFFECT_LIMITER_HPP
 #define EFFECT_LIMITER_HPP
 
+#include <array>
 #include <atomic>
+#include <cstdint>
 
 #include "DynamicProcessor.hpp"
 
@@ -12,9 +14,23 @@
  * that prevents the signal from exceeding a set threshold level.
  *
  * Extends DynamicProcessor with a fixed high ratio.
+ *
+ * In look-ahead mode (setLookAhead()) the signal is delayed so that the gain
+ * can ramp down before a peak reaches the output instead of clipping it:
+ * - The detector is a 4x oversampled true-peak meter, so peaks between
+ *   samples are caught too.
+ * - The largest peak within the look-ahead window comes from a monotonic
+ *   deque, in O(1) amortized time per sample.
+ * - The gain for that peak is averaged over the window, which turns the drop
+ *   into a ramp that reaches the required gain when the peak is output.
+ * The attack time is not used in this mode; the release time still is. The
+ * added delay is reported by getLatencyFrames().
  */
 class Limiter : public DynamicProcessor {
  public:
+  // Longest look-ahead accepted by setLookAhead().
+  static constexpr float kMaxLookAheadMs = 10.0f;
+
   /**
    * @brief Constructor for Limiter.
    *
@@ -36,14 +52,80 @@ class Limiter : public DynamicProcessor {
   void process(const float* inputBuffer, float* outputBuffer,
                int numSamples) override;
 
+  /**
+   * @brief Sets the look-ahead time.
+   *
+   * @param lookAheadMs Look-ahead in milliseconds, clamped to
+   * kMaxLookAheadMs. 0 turns look-ahead off.
+   */
+  void setLookAhead(float lookAheadMs);
+  float getLookAhead() const { return m_settings.lookAheadMs; }
+
+  /**
+   * @brief Delay added by look-ahead while the limiter is enabled, in frames.
+   */
+  int getLatencyFrames() const override;
+
   bool isHardClipActive() const { return m_hardClipActive.load(); }
 
+  /**
+   * @brief Limits one sample without look-ahead; see DynamicProcessor.
+   */
+  static float processSample(BlockState& state, bool& hardClip,
+                             float input) {
+    const float threshold = state.params.thresholdLinear;
+    const float level = std::abs(input);
+    // Use the larger of envelope and current input peak for faster limiting.
+    const float detector = std::max(state.followEnvelope(level), level);
+    float gain = 1.0f;
+    if (detector > threshold) {
+      // Infinite-ratio style limiting above threshold.
+      gain = threshold / detector;
+    }
+
+    // Enforce hard output ceiling so peaks do not exceed the limiter
+    // threshold.
+    const float output = input * gain;
+    const float clampedOutput = std::clamp(output, -threshold, threshold);
+    hardClip = hardClip || clampedOutput != output;
+    state.meter(level, clampedOutput, gain);
+    return clampedOutput;
+  }
+
  private:
+  // Capacity of the look-ahead buffers; a power of two that holds
+  // kMaxLookAheadMs at 192 kHz.
+  static constexpr int kRingSize = 4096;
+  static constexpr uint32_t kRingMask = kRingSize - 1;
+
+  static int lookAheadFrames(const Parameters& params);
+
+  void processLookAhead(BlockState& state, bool& hardClip,
+                        const float* inputBuffer, float* outputBuffer,
+                        int numSamples);
+  void resetLookAhead(int lookAheadFrames);
+  // True peak around the sample kTruePeakDelay frames before the one at
+  // position newest.
+  float truePeak(uint32_t newest) const;
+
   std::atomic<bool> m_hardClipActive{false};
 
-  // Override from DynamicProcessor
-  float computeGain(float envDb, float input, float attackCoef,
-                    float releaseCoef) override;
+  // Look-ahead state (audio thread only). Positions count frames and index
+  // the buffers modulo kRingSize.
+  int m_lookAheadFrames = 0;  // 0 while look-ahead is inactive
+  uint32_t m_appliedResetCount = 0;
+  uint32_t m_position = 0;
+  std::array<float, kRingSize> m_delayLine{};
+  // Monotonic deque of (peak, position): peaks decrease from head to tail,
+  // so the head is the window's maximum.
+  std::array<float, kRingSize> m_peakQueue{};
+  std::array<uint32_t, kRingSize> m_peakQueuePosition{};
+  uint32_t m_peakQueueHead = 0;
+  uint32_t m_peakQueueTail = 0;
+  // Gains of the window, summed for the moving average.
+  std::array<float, kRingSize> m_gainHistory{};
+  double m_gainSum = 0.0;
+  float m_releaseGain = 1.0f;
 };
 
-#endif  // EFFECT_LIMITER_HPP
\ No newline at end of file
+#endif  // EFFECT_LIMITER_HPP
@@ -0,0 +1,77 @@
+#include "MeterSnapshot.hpp"
+
+#include <algorithm>
+#include <utility>
+
+MeterSnapshot::MeterSnapshot(Block* block,
+                             std::shared_ptr<const DynamicProcessor> noiseGate,
+                             std::shared_ptr<const DynamicProcessor> compressor,
+                             std::shared_ptr<const DynamicProcessor> limiter,
+                             std::shared_ptr<const RNNoiseProcessor> rnnoise)
+    : m_block(block),
+      m_noiseGate(std::move(noiseGate)),
+      m_compressor(std::move(compressor)),
+      m_limiter(std::move(limiter)),
+      m_rnnoise(std::move(rnnoise)) {
+  publish();
+}
+
+void MeterSnapshot::process(const float* inputBuffer, float* outputBuffer,
+                            int numSamples) {
+  if (inputBuffer != outputBuffer) {
+    std::copy(inputBuffer, inputBuffer + numSamples, outputBuffer);
+  }
+  publish();
+}
+
+void MeterSnapshot::publish() {
+  auto& values = m_block->values;
+  auto set = [&values](Meter meter, float value) {
+    values[meter].store(value, std::memory_order_relaxed);
+  };
+  // A dynamics processor's four meters are consecutive, in this order. A
+  // disabled processor rests: the chain may no longer run it at all, and
+  // then its own meters would hold the last values they had.
+  auto setDynamics = [&set](const DynamicProcessor& processor,
+                            Meter inputPeak) {
+    const bool isEnabled = processor.isEnabled();
+    set(inputPeak, isEnabled ? processor.getInputPeakDb() : kRestingDb);
+    set(static_cast<Meter>(inputPeak + 1),
+        isEnabled ? processor.getOutputPeakDb() : kRestingDb);
+    set(static_cast<Meter>(inputPeak + 2),
+        isEnabled ? processor.getGainReductionDb() : 0.0f);
+    set(static_cast<Meter>(inputPeak + 3),
+        isEnabled ? processor.getDetectorLevelDb() : kRestingDb);
+  };
+  const bool isRNNoiseEnabled = m_rnnoise->isEnabled();
+
+  // Odd, then the values, then even again; the fences keep the value stores
+  // between the two sequence stores.
+  const uint32_t sequence =
+      m_block->sequence.load(std::memory_order_relaxed) + 1;
+  m_block->sequence.store(sequence, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  setDynamics(*m_noiseGate, kNoiseGateInputPeakDb);
+  setDynamics(*m_compressor, kCompressorInputPeakDb);
+  setDynamics(*m_limiter, kLimiterInputPeakDb);
+  set(kRNNoiseInputPeakDb,
+      isRNNoiseEnabled ? m_rnnoise->getInputPeakDb() : kRestingDb);
+  set(kRNNoiseOutputPeakDb,
+      isRNNoiseEnabled ? m_rnnoise->getOutputPeakDb() : kRestingDb);
+  set(kRNNoiseVadProbability,
+      isRNNoiseEnabled ? m_rnnoise->getLastVadProbability() : 0.0f);
+  m_block->sequence.store(sequence + 1, std::memory_order_release);
+}
+
+void MeterSnapshot::read(const Block& block, float (&values)[kNumMeters]) {
+  uint32_t before;
+  uint32_t after;
+  do {
+    before = block.sequence.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < kNumMeters; ++i) {
+      values[i] = block.values[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    after = block.sequence.load(std::memory_order_relaxed);
+  } while ((before & 1) != 0 || before != after);
+}
@@ -0,0 +1,93 @@
+#ifndef EFFECT_METER_SNAPSHOT_HPP
+#define EFFECT_METER_SNAPSHOT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "AudioEffector.hpp"
+#include "DynamicProcessor.hpp"
+#include "RNNoiseProcessor.hpp"
+
+/**
+ * @brief Copies every meter into one block of plain memory, once per audio
+ * block, for the UI to read without a call per value.
+ *
+ * Runs as a pass-through stage at the end of the chain, so the meters it
+ * copies all describe the same block. The block is a seqlock: the sequence
+ * is odd while a copy is being written, and a reader that sees the same even
+ * sequence before and after reading the values has a consistent snapshot.
+ * Its layout is fixed so that Java can read it through a direct ByteBuffer
+ * in native byte order; keep MeterSnapshot.kt in sync with it.
+ */
+class MeterSnapshot : public AudioEffector {
+ public:
+  // What the meters of a disabled stage read, like a processor's before it
+  // has seen audio.
+  static constexpr float kRestingDb = -100.0f;
+
+  enum Meter : uint32_t {
+    kNoiseGateInputPeakDb,
+    kNoiseGateOutputPeakDb,
+    kNoiseGateGainReductionDb,
+    kNoiseGateDetectorLevelDb,
+    kCompressorInputPeakDb,
+    kCompressorOutputPeakDb,
+    kCompressorGainReductionDb,
+    kCompressorDetectorLevelDb,
+    kLimiterInputPeakDb,
+    kLimiterOutputPeakDb,
+    kLimiterGainReductionDb,
+    kLimiterDetectorLevelDb,
+    kRNNoiseInputPeakDb,
+    kRNNoiseOutputPeakDb,
+    kRNNoiseVadProbability,
+    kNumMeters
+  };
+
+  // Byte offsets: sequence 0, meterCount 4, values 8 (floats).
+  struct Block {
+    // Odd while the audio thread is writing.
+    std::atomic<uint32_t> sequence{0};
+    const uint32_t meterCount = kNumMeters;
+    std::atomic<float> values[kNumMeters] = {};
+  };
+  static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+                    std::atomic<float>::is_always_lock_free &&
+                    sizeof(Block) == 8 + sizeof(float) * kNumMeters,
+                "Block must have the plain layout Java expects");
+
+  /**
+   * @param block Written by process(), and once here so that it holds the
+   * meters' resting values before audio runs. Must outlive this stage and
+   * every reader, e.g. a static.
+   */
+  MeterSnapshot(Block* block, std::shared_ptr<const DynamicProcessor> noiseGate,
+                std::shared_ptr<const DynamicProcessor> compressor,
+                std::shared_ptr<const DynamicProcessor> limiter,
+                std::shared_ptr<const RNNoiseProcessor> rnnoise);
+
+  void process(const float* inputBuffer, float* outputBuffer,
+               int numSamples) override;
+  void setSampleRate(float) override {}
+  // Always copies; the meters have their own enable switches.
+  void setEnabled(bool) override {}
+  bool isEnabled() const override { return true; }
+
+  /**
+   * @brief Reads a consistent snapshot of the block, retrying while it is
+   * being written. Any thread.
+   */
+  static void read(const Block& block, float (&values)[kNumMeters]);
+
+ private:
+  void publish();
+
+  Block* m_block;
+  std::shared_ptr<const DynamicProcessor> m_noiseGate;
+  std::shared_ptr<const DynamicProcessor> m_compressor;
+  std::shared_ptr<const DynamicProcessor> m_limiter;
+  std::shared_ptr<const RNNoiseProcessor> m_rnnoise;
+};
+
+#endif  // EFFECT_METER_SNAPSHOT_HPP
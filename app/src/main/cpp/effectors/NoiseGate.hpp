@@ -46,24 +46,35 @@ class NoiseGate : public DynamicProcessor {
    */
 
   void setRange(float range);
-  float getRange() const { return m_rangeDb; }
+  float getRange() const { return m_settings.rangeDb; }
   float getGateGainDb() const { return getGainReductionDb(); }
   bool isGateOpen() const { return getGateGainDb() > -0.1f; }
 
- protected:
-  // DynamicProcessor base handles threshold, attack, release, sampleRate,
-  // envelope
+  /**
+   * @brief Gates one sample; see DynamicProcessor.
+   */
+  static float processSample(BlockState& state, float input) {
+    const Parameters& params = state.params;
+    const float level = std::abs(input);
+    const float envelope = state.followEnvelope(level);
 
- private:
-  // Parameters
-  float m_rangeDb;
+    // Gate behavior: fully open above threshold, attenuate to range below.
+    const float targetGain =
+        envelope < params.thresholdLinear ? params.rangeLinear : 1.0f;
 
-  // Internal state
-  float m_gain;
+    // NoiseGate-specific: Smooth gain transition
+    const float coef =
+        targetGain > state.gain ? params.attackCoef : params.releaseCoef;
+    state.gain = coef * state.gain + (1.0f - coef) * targetGain;
 
-  // Override from DynamicProcessor
-  float computeGain(float envDb, float input, float attackCoef,
-                    float releaseCoef) override;
+    const float output = input * state.gain;
+    state.meter(level, output, state.gain);
+    return output;
+  }
+
+ protected:
+  // DynamicProcessor base handles threshold, attack, release, sampleRate,
+  // envelope
 };
 
 #endif  // EFFECT_NOISE_GATE_HPP
\ No newline at end of file
@@ -0,0 +1,150 @@
+#ifndef EFFECT_PARAMETER_TRANSPORT_HPP
+#define EFFECT_PARAMETER_TRANSPORT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @brief Makes the snapshots published while it is open reach the audio
+ * thread at the same block boundary, across any number of
+ * ParameterTransports.
+ *
+ * Every snapshot carries an epoch. Publishes inside a batch are tagged with
+ * the next epoch, which the batch commits when it is destroyed; the audio
+ * thread latches the committed epoch once per block with latch() and only
+ * acquires snapshots tagged no later. A block therefore sees either none or
+ * all of a batch, or newer snapshots published after it. Publishes outside a
+ * batch carry the committed epoch and are unaffected.
+ *
+ * Batches are serialized and must not nest. If nothing calls latch(), no
+ * batch ever becomes visible; only a caller that does may open one.
+ */
+class ParameterBatch {
+ public:
+  ParameterBatch() : m_lock(s_mutex) {
+    t_epoch = s_committed.load(std::memory_order_relaxed) + 1;
+    t_isOpen = true;
+  }
+
+  ~ParameterBatch() {
+    t_isOpen = false;
+    s_committed.store(t_epoch, std::memory_order_release);
+  }
+
+  ParameterBatch(const ParameterBatch&) = delete;
+  ParameterBatch& operator=(const ParameterBatch&) = delete;
+
+  /**
+   * @brief Lets the next block acquire everything committed so far. Audio
+   * thread, before each block.
+   */
+  static void latch() {
+    s_latched.store(s_committed.load(std::memory_order_acquire),
+                    std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief The epoch to tag a snapshot published now by this thread with.
+   */
+  static uint32_t publishEpoch() {
+    return t_isOpen ? t_epoch : s_committed.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Whether the current block may acquire a snapshot of epoch, given
+   * modulo 2^bits. Audio thread.
+   */
+  template <int bits>
+  static bool isLatched(uint32_t epoch) {
+    const uint32_t ahead = epoch - s_latched.load(std::memory_order_relaxed);
+    return static_cast<int32_t>(ahead << (32 - bits)) <= 0;
+  }
+
+ private:
+  std::lock_guard<std::mutex> m_lock;
+
+  static inline std::mutex s_mutex;
+  static inline std::atomic<uint32_t> s_committed{0};
+  static inline std::atomic<uint32_t> s_latched{0};
+  static inline thread_local bool t_isOpen = false;
+  static inline thread_local uint32_t t_epoch = 0;
+};
+
+/**
+ * @brief Hands parameter snapshots from control threads to the audio thread.
+ *
+ * A triple buffer: control threads publish() a complete snapshot into a back
+ * slot and swap it into the middle, and the audio thread calls acquire() at
+ * a block boundary to swap the newest middle slot into the front. The audio
+ * side never blocks, allocates or sees a half-written snapshot; publishers
+ * are serialized by a mutex only the control side takes. Snapshots published
+ * faster than the audio thread picks them up are coalesced, so the audio
+ * thread always sees the latest one. A snapshot published inside a
+ * ParameterBatch is only acquired once the batch has been committed.
+ *
+ * T must be copy-assignable; copies happen on the publishing thread only.
+ */
+template <typename T>
+class ParameterTransport {
+ public:
+  explicit ParameterTransport(const T& initial = T{})
+      : m_slots{initial, initial, initial} {}
+
+  ParameterTransport(const ParameterTransport&) = delete;
+  ParameterTransport& operator=(const ParameterTransport&) = delete;
+
+  /**
+   * @brief Publishes a snapshot. Control threads only.
+   */
+  void publish(const T& value) {
+    std::lock_guard<std::mutex> lock(m_publishMutex);
+    m_slots[m_back] = value;
+    const uint32_t middle =
+        (ParameterBatch::publishEpoch() << kEpochShift) | m_back | kFresh;
+    m_back = m_middle.exchange(middle, std::memory_order_acq_rel) &
+             kIndexMask;
+  }
+
+  /**
+   * @brief Makes the newest published snapshot current. Audio thread only.
+   *
+   * @return True if current() changed since the previous call.
+   */
+  bool acquire() {
+    uint32_t middle = m_middle.load(std::memory_order_relaxed);
+    do {
+      if ((middle & kFresh) == 0 ||
+          !ParameterBatch::isLatched<32 - kEpochShift>(middle >>
+                                                       kEpochShift)) {
+        return false;
+      }
+      // Retried only if a publisher swapped in a newer snapshot meanwhile.
+    } while (!m_middle.compare_exchange_weak(middle, m_front,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_relaxed));
+    m_front = middle & kIndexMask;
+    return true;
+  }
+
+  /**
+   * @brief The snapshot made current by the last acquire(). Audio thread
+   * only; stays valid and unchanged until the next acquire().
+   */
+  const T& current() const { return m_slots[m_front]; }
+
+ private:
+  // m_middle holds the slot index, the fresh flag and, from kEpochShift up,
+  // the epoch of the snapshot in the slot.
+  static constexpr uint32_t kIndexMask = 0x3;
+  static constexpr uint32_t kFresh = 0x4;
+  static constexpr int kEpochShift = 8;
+
+  T m_slots[3];
+  uint32_t m_front = 0;  // Owned by the audio thread.
+  uint32_t m_back = 1;   // Owned by publishers, under m_publishMutex.
+  std::atomic<uint32_t> m_middle{2};
+  std::mutex m_publishMutex;
+};
+
+#endif  // EFFECT_PARAMETER_TRANSPORT_HPP
@@ -1,18 +1,20 @@
 #include "ParametricEqualizer.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 
+#include "FastMath.hpp"
+
 ParametricEqualizer::ParametricEqualizer(float sampleRate, int numBands)
     : m_sampleRate(sampleRate),
       m_numBands(std::min(std::max(numBands, 1), 8)),
       m_bands(m_numBands, {1000.0f, 1.0f, 0.0f}),
       m_filterTypes(m_numBands, FilterType::PEAKING),
-      m_z1(m_numBands, std::vector<float>(1, 0.0f)),
-      m_z2(m_numBands, std::vector<float>(1, 0.0f)),
       m_coeffs(m_numBands, BiquadCoeffs{0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f}),
-      m_cachedSampleRate(sampleRate),
-      m_cacheValid(false) {}
+      m_cascade(m_numBands) {
+  m_activeCoeffs.fill(BiquadCoeffs{1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f});
+}
 
 void ParametricEqualizer::setNumBands(int numBands) {
   int bands = std::min(std::max(numBands, 1), 8);
@@ -20,12 +22,9 @@ void ParametricEqualizer::setNumBands(int numBands) {
     m_numBands = bands;
     m_bands.assign(m_numBands, {1000.0f, 1.0f, 0.0f});
     m_filterTypes.assign(m_numBands, FilterType::PEAKING);
-    m_z1.assign(m_numBands, std::vector<float>(1, 0.0f));
-    m_z2.assign(m_numBands, std::vector<float>(1, 0.0f));
     m_coeffs.assign(m_numBands,
                     BiquadCoeffs{0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f});
     computeAllCoeffs();
-    m_cacheValid = false;
   }
 }
 
@@ -40,7 +39,7 @@ void ParametricEqualizer::setBandAsPeaking(int bandIndex, float centerFrequency,
 
   computePeakingCoeffs(bandIndex, m_bands[bandIndex].centerFrequency,
                        m_bands[bandIndex].Q, m_bands[bandIndex].gainDb);
-  m_cacheValid = false;
+  publishCoeffs();
 }
 
 void ParametricEqualizer::setBandAsLowpass(int bandIndex, float cutoffFrequency,
@@ -54,7 +53,7 @@ void ParametricEqualizer::setBandAsLowpass(int bandIndex, float cutoffFrequency,
 
   computeLowpassCoeffs(bandIndex, m_bands[bandIndex].centerFrequency,
                        m_bands[bandIndex].Q);
-  m_cacheValid = false;
+  publishCoeffs();
 }
 
 void ParametricEqualizer::setBandAsHighpass(int bandIndex,
@@ -68,7 +67,7 @@ void ParametricEqualizer::setBandAsHighpass(int bandIndex,
 
   computeHighpassCoeffs(bandIndex, m_bands[bandIndex].centerFrequency,
                         m_bands[bandIndex].Q);
-  m_cacheValid = false;
+  publishCoeffs();
 }
 
 void ParametricEqualizer::setBandAsLowShelf(int bandIndex,
@@ -83,7 +82,7 @@ void ParametricEqualizer::setBandAsLowShelf(int bandIndex,
 
   computeLowShelfCoeffs(bandIndex, m_bands[bandIndex].centerFrequency,
                         m_bands[bandIndex].Q, m_bands[bandIndex].gainDb);
-  m_cacheValid = false;
+  publishCoeffs();
 }
 
 void ParametricEqualizer::setBandAsHighShelf(int bandIndex,
@@ -98,7 +97,7 @@ void ParametricEqualizer::setBandAsHighShelf(int bandIndex,
 
   computeHighShelfCoeffs(bandIndex, m_bands[bandIndex].centerFrequency,
                          m_bands[bandIndex].Q, m_bands[bandIndex].gainDb);
-  m_cacheValid = false;
+  publishCoeffs();
 }
 
 void ParametricEqualizer::setBandAsNotch(int bandIndex, float centerFrequency,
@@ -112,7 +111,7 @@ void ParametricEqualizer::setBandAsNotch(int bandIndex, float centerFrequency,
 
   computeNotchCoeffs(bandIndex, m_bands[bandIndex].centerFrequency,
                      m_bands[bandIndex].Q);
-  m_cacheValid = false;
+  publishCoeffs();
 }
 
 void ParametricEqualizer::setBandAsAllpass(int bandIndex, float centerFrequency,
@@ -126,7 +125,23 @@ void ParametricEqualizer::setBandAsAllpass(int bandIndex, float centerFrequency,
 
   computeAllpassCoeffs(bandIndex, m_bands[bandIndex].centerFrequency,
                        m_bands[bandIndex].Q);
-  m_cacheValid = false;
+  publishCoeffs();
+}
+
+void ParametricEqualizer::setBands(const std::vector<BandSettings>& bands) {
+  const int count = std::min(static_cast<int>(bands.size()), m_numBands);
+  for (int i = 0; i < count; ++i) {
+    const BandSettings& settings = bands[i];
+    const bool hasGain = settings.type == FilterType::PEAKING ||
+                         settings.type == FilterType::LOWSHELF ||
+                         settings.type == FilterType::HIGHSHELF;
+    m_bands[i].centerFrequency = clamp(settings.frequency, 20.0f, 20000.0f);
+    m_bands[i].Q = clamp(settings.Q, 0.1f, 10.0f);
+    m_bands[i].gainDb = hasGain ? clamp(settings.gainDb, -30.0f, 30.0f) : 0.0f;
+    m_filterTypes[i] = settings.type;
+    computeBandCoeffs(i);
+  }
+  publishCoeffs();
 }
 
 float ParametricEqualizer::getCenterFrequency(int bandIndex) const {
@@ -147,26 +162,88 @@ float ParametricEqualizer::getGain(int bandIndex) const {
 void ParametricEqualizer::setSampleRate(float sampleRate) {
   m_sampleRate = sampleRate;
   computeAllCoeffs();
-  m_cacheValid = false;
 }
 
 void ParametricEqualizer::process(const float* inputBuffer, float* outputBuffer,
                                   int numSamples) {
-  if (m_isEnabled) {
-    // Process through all bands in cascade
-    const float* currentInput = inputBuffer;
-    float* currentOutput = outputBuffer;
-    for (int bandIndex = 0; bandIndex < m_numBands; ++bandIndex) {
-      for (int i = 0; i < numSamples; ++i) {
-        float output = processBiquad(currentInput[i], bandIndex);
-        currentOutput[i] = output;
-      }
-      currentInput =
-          currentOutput;  // Output of this band becomes input for the next
+  if (m_cascadeSnapshot.acquire()) {
+    applySnapshot(m_cascadeSnapshot.current());
+  }
+  if (!m_isEnabled.load()) {
+    // Finish any ramp, so that re-enabling starts from the current bands.
+    if (m_rampStep < m_rampSteps) {
+      m_rampStep = m_rampSteps - 1;
+      loadRampStep();
+    }
+    if (inputBuffer != outputBuffer) {
+      // Bypass: copy input to output
+      std::copy(inputBuffer, inputBuffer + numSamples, outputBuffer);
     }
-  } else if (inputBuffer != outputBuffer) {
-    // Bypass: copy input to output
-    std::copy(inputBuffer, inputBuffer + numSamples, outputBuffer);
+    return;
+  }
+
+  int offset = 0;
+  while (offset < numSamples && m_rampStep < m_rampSteps) {
+    if (m_rampPhase == 0) {
+      loadRampStep();
+    }
+    const int count =
+        std::min(numSamples - offset, kCoeffRampBlockSize - m_rampPhase);
+    m_cascade.process(inputBuffer + offset, outputBuffer + offset, count);
+    offset += count;
+    m_rampPhase = (m_rampPhase + count) % kCoeffRampBlockSize;
+  }
+  if (offset < numSamples) {
+    m_cascade.process(inputBuffer + offset, outputBuffer + offset,
+                      numSamples - offset);
+  }
+}
+
+void ParametricEqualizer::applySnapshot(const CascadeSnapshot& snapshot) {
+  const bool resized = snapshot.numStages != m_cascade.getNumStages();
+  if (resized) {
+    m_cascade.setNumStages(snapshot.numStages);
+  }
+  if (resized || snapshot.resetCount != m_appliedResetCount) {
+    m_appliedResetCount = snapshot.resetCount;
+    m_activeCoeffs = snapshot.coeffs;
+    for (int i = 0; i < snapshot.numStages; ++i) {
+      m_cascade.setStage(i, m_activeCoeffs[i]);
+    }
+    m_rampSteps = 0;
+    m_rampStep = 0;
+    return;
+  }
+
+  // A snapshot arriving mid-ramp starts a new ramp from where the old one is.
+  m_rampFrom = m_activeCoeffs;
+  m_rampTo = snapshot.coeffs;
+  m_rampSteps = std::max(
+      1, static_cast<int>(snapshot.sampleRate * kCoeffRampTimeMs / 1000.0f) /
+             kCoeffRampBlockSize);
+  m_rampStep = 0;
+  m_rampPhase = 0;
+}
+
+void ParametricEqualizer::loadRampStep() {
+  ++m_rampStep;
+  const int numStages = m_cascade.getNumStages();
+  if (m_rampStep >= m_rampSteps) {
+    m_activeCoeffs = m_rampTo;
+  } else {
+    const float t =
+        static_cast<float>(m_rampStep) / static_cast<float>(m_rampSteps);
+    auto lerp = [t](float from, float to) { return from + (to - from) * t; };
+    for (int i = 0; i < numStages; ++i) {
+      const BiquadCoeffs& from = m_rampFrom[i];
+      const BiquadCoeffs& to = m_rampTo[i];
+      m_activeCoeffs[i] = {lerp(from.b0, to.b0), lerp(from.b1, to.b1),
+                           lerp(from.b2, to.b2), 1.0f,
+                           lerp(from.a1, to.a1), lerp(from.a2, to.a2)};
+    }
+  }
+  for (int i = 0; i < numStages; ++i) {
+    m_cascade.setStage(i, m_activeCoeffs[i]);
   }
 }
 
@@ -327,144 +404,159 @@ void ParametricEqualizer::computeAllpassCoeffs(int bandIndex,
   m_coeffs[bandIndex] = {b0 / a0, b1 / a0, b2 / a0, 1.0f, a1 / a0, a2 / a0};
 }
 
-void ParametricEqualizer::computeAllCoeffs() {
-  for (int i = 0; i < m_numBands; ++i) {
-    const Band& band = m_bands[i];
-    switch (m_filterTypes[i]) {
-      case FilterType::PEAKING:
-        computePeakingCoeffs(i, band.centerFrequency, band.Q, band.gainDb);
-        break;
-      case FilterType::LOWPASS:
-        computeLowpassCoeffs(i, band.centerFrequency, band.Q);
-        break;
-      case FilterType::HIGHPASS:
-        computeHighpassCoeffs(i, band.centerFrequency, band.Q);
-        break;
-      case FilterType::LOWSHELF:
-        computeLowShelfCoeffs(i, band.centerFrequency, band.Q, band.gainDb);
-        break;
-      case FilterType::HIGHSHELF:
-        computeHighShelfCoeffs(i, band.centerFrequency, band.Q, band.gainDb);
-        break;
-      case FilterType::NOTCH:
-        computeNotchCoeffs(i, band.centerFrequency, band.Q);
-        break;
-      case FilterType::ALLPASS:
-        computeAllpassCoeffs(i, band.centerFrequency, band.Q);
-        break;
-    }
+void ParametricEqualizer::computeBandCoeffs(int bandIndex) {
+  const Band& band = m_bands[bandIndex];
+  switch (m_filterTypes[bandIndex]) {
+    case FilterType::PEAKING:
+      computePeakingCoeffs(bandIndex, band.centerFrequency, band.Q,
+                           band.gainDb);
+      break;
+    case FilterType::LOWPASS:
+      computeLowpassCoeffs(bandIndex, band.centerFrequency, band.Q);
+      break;
+    case FilterType::HIGHPASS:
+      computeHighpassCoeffs(bandIndex, band.centerFrequency, band.Q);
+      break;
+    case FilterType::LOWSHELF:
+      computeLowShelfCoeffs(bandIndex, band.centerFrequency, band.Q,
+                            band.gainDb);
+      break;
+    case FilterType::HIGHSHELF:
+      computeHighShelfCoeffs(bandIndex, band.centerFrequency, band.Q,
+                             band.gainDb);
+      break;
+    case FilterType::NOTCH:
+      computeNotchCoeffs(bandIndex, band.centerFrequency, band.Q);
+      break;
+    case FilterType::ALLPASS:
+      computeAllpassCoeffs(bandIndex, band.centerFrequency, band.Q);
+      break;
   }
-  m_cacheValid = true;
 }
 
-float ParametricEqualizer::processBiquad(float input, int bandIndex) {
-  // Direct form II transposed biquad filter
-  float output = m_coeffs[bandIndex].b0 * input + m_z1[bandIndex][0];
-  m_z1[bandIndex][0] = m_coeffs[bandIndex].b1 * input -
-                       m_coeffs[bandIndex].a1 * output + m_z2[bandIndex][0];
-  m_z2[bandIndex][0] =
-      m_coeffs[bandIndex].b2 * input - m_coeffs[bandIndex].a2 * output;
-
-  return output;
+void ParametricEqualizer::computeAllCoeffs() {
+  for (int i = 0; i < m_numBands; ++i) {
+    computeBandCoeffs(i);
+  }
+  ++m_resetCount;
+  publishCoeffs();
 }
 
-float ParametricEqualizer::computeBiquadMagnitude(int bandIndex,
-                                                  float frequency) const {
-  if (bandIndex < 0 || bandIndex >= m_numBands) return 1.0f;
-  if (frequency <= 0.0f || frequency >= m_sampleRate * 0.5f) return 1.0f;
-
-  const auto& coeffs = m_coeffs[bandIndex];
-
-  // ω = 2πf/fs
-  float omega = 2.0f * static_cast<float>(M_PI) * frequency / m_sampleRate;
-
-  // cos(ω) and cos(2ω)
-  float cosW = std::cos(omega);
-  float cos2W = std::cos(2.0f * omega);
-  float sinW = std::sin(omega);
-  float sin2W = std::sin(2.0f * omega);
-
-  // Numerator: b0 + b1·e^(-jω) + b2·e^(-j2ω)
-  float realNum = coeffs.b0 + coeffs.b1 * cosW + coeffs.b2 * cos2W;
-  float imagNum = -(coeffs.b1 * sinW + coeffs.b2 * sin2W);
-
-  // Denominator: a0 + a1·e^(-jω) + a2·e^(-j2ω)  (a0 == 1.0)
-  float realDen = 1.0f + coeffs.a1 * cosW + coeffs.a2 * cos2W;
-  float imagDen = -(coeffs.a1 * sinW + coeffs.a2 * sin2W);
-
-  // |H(ω)|
-  float mag = std::sqrt(realNum * realNum + imagNum * imagNum) /
-              std::sqrt(realDen * realDen + imagDen * imagDen);
-
-  return mag;
+void ParametricEqualizer::publishCoeffs() {
+  CascadeSnapshot snapshot;
+  snapshot.numStages = m_numBands;
+  std::copy(m_coeffs.begin(), m_coeffs.end(), snapshot.coeffs.begin());
+  snapshot.sampleRate = m_sampleRate;
+  snapshot.resetCount = m_resetCount;
+  m_cascadeSnapshot.publish(snapshot);
 }
 
-bool ParametricEqualizer::isCacheValid(
-    const std::vector<float>& frequencies) const {
-  if (!m_cacheValid) return false;
-  if (m_cachedFrequencies.size() != frequencies.size()) return false;
-  if (m_cachedResponse.size() != frequencies.size()) return false;
-  if (m_cachedBands.size() != static_cast<size_t>(m_numBands)) return false;
-  if (m_cachedFilterTypes.size() != static_cast<size_t>(m_numBands)) {
-    return false;
+void ParametricEqualizer::updateResponseGrid(const float* frequencies,
+                                             int numPoints) {
+  const size_t count = static_cast<size_t>(numPoints);
+  if (m_sampleRate == m_responseSampleRate &&
+      m_responseFrequencies.size() == count &&
+      std::equal(frequencies, frequencies + count,
+                 m_responseFrequencies.begin())) {
+    return;
   }
 
-  // Check if frequencies match
-  for (size_t i = 0; i < frequencies.size(); ++i) {
-    if (frequencies[i] != m_cachedFrequencies[i]) return false;
+  m_responseFrequencies.assign(frequencies, frequencies + count);
+  m_responseSampleRate = m_sampleRate;
+  m_responsePhi.resize(count);
+  m_responseMask.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    const float frequency = frequencies[i];
+    const float halfOmega =
+        static_cast<float>(M_PI) * frequency / m_sampleRate;
+    const float sinHalfOmega = std::sin(halfOmega);
+    m_responsePhi[i] = sinHalfOmega * sinHalfOmega;
+    m_responseMask[i] =
+        frequency > 0.0f && frequency < m_sampleRate * 0.5f ? 1.0f : 0.0f;
   }
-
-  // Check if sample rate changed
-  if (m_sampleRate != m_cachedSampleRate) return false;
-
-  // Check if any band parameters changed
-  for (int i = 0; i < m_numBands; ++i) {
-    if (m_bands[i].centerFrequency != m_cachedBands[i].centerFrequency ||
-        m_bands[i].Q != m_cachedBands[i].Q ||
-        m_bands[i].gainDb != m_cachedBands[i].gainDb ||
-        m_filterTypes[i] != m_cachedFilterTypes[i]) {
-      return false;
-    }
-  }
-
-  return true;
+  m_responseScratch.resize(2 * count);
+  // Every band has to be evaluated on the new grid.
+  m_responseCoeffs.clear();
 }
 
-std::vector<float> ParametricEqualizer::computeFrequencyResponse(
-    const std::vector<float>& frequencies) {
-  // Check cache
-  if (isCacheValid(frequencies)) {
-    return m_cachedResponse;
+void ParametricEqualizer::computeBandResponse(int bandIndex, float* responseDb,
+                                              int numPoints) {
+  // |H|^2 of a biquad as a ratio of two quadratics in phi = sin^2(w/2):
+  // |b0 + b1 e^-jw + b2 e^-2jw|^2 = (b0 + b1 + b2)^2
+  //     - 4 (b0 b1 + 4 b0 b2 + b1 b2) phi + 16 b0 b2 phi^2,
+  // and likewise for the denominator with a0 = 1. Unlike the form in cos(w),
+  // this does not cancel at low frequencies. The quadratics' coefficients
+  // do cancel near a notch, so they are derived in double, once per band;
+  // the loops below are plain float multiply-adds over the grid, which the
+  // compiler vectorizes, and the logs go through fastmath's SIMD path.
+  const BiquadCoeffs& c = m_coeffs[bandIndex];
+  auto quadratic = [](double c0, double c1, double c2) {
+    const double sum = c0 + c1 + c2;
+    return std::array<float, 3>{
+        static_cast<float>(sum * sum),
+        static_cast<float>(-4.0 * (c0 * c1 + 4.0 * c0 * c2 + c1 * c2)),
+        static_cast<float>(16.0 * c0 * c2)};
+  };
+  const auto [num0, num1, num2] = quadratic(c.b0, c.b1, c.b2);
+  const auto [den0, den1, den2] = quadratic(1.0, c.a1, c.a2);
+
+  const float* phi = m_responsePhi.data();
+  float* num = m_responseScratch.data();
+  float* den = num + numPoints;
+  for (int i = 0; i < numPoints; ++i) {
+    // Floored so that the log stays finite at the zero of a notch.
+    num[i] = std::max(num0 + phi[i] * (num1 + phi[i] * num2),
+                      kResponsePowerFloor);
+    den[i] = std::max(den0 + phi[i] * (den1 + phi[i] * den2),
+                      kResponsePowerFloor);
   }
+  fastmath::log2Block(num, num, numPoints);
+  fastmath::log2Block(den, den, numPoints);
+  // 10 log10 of a power ratio, half of fastmath's 20 log10.
+  const float scale = 0.5f * fastmath::kLog2ToDb;
+  for (int i = 0; i < numPoints; ++i) {
+    responseDb[i] = (num[i] - den[i]) * scale;
+  }
+}
 
-  // Compute response
-  std::vector<float> response(frequencies.size(), 0.0f);
-
-  for (size_t i = 0; i < frequencies.size(); ++i) {
-    float magLinear = 1.0f;
+void ParametricEqualizer::computeFrequencyResponse(const float* frequencies,
+                                                   float* responseDb,
+                                                   int numPoints) {
+  if (numPoints <= 0) return;
+  updateResponseGrid(frequencies, numPoints);
 
-    // Cascade all bands: multiply magnitudes
-    for (int band = 0; band < m_numBands; ++band) {
-      magLinear *= computeBiquadMagnitude(band, frequencies[i]);
+  const size_t count = static_cast<size_t>(numPoints);
+  m_bandResponseDb.resize(static_cast<size_t>(m_numBands) * count);
+  if (m_responseCoeffs.size() > static_cast<size_t>(m_numBands)) {
+    m_responseCoeffs.resize(m_numBands);
+  }
+  std::fill(responseDb, responseDb + count, 0.0f);
+  for (int band = 0; band < m_numBands; ++band) {
+    float* bandDb = &m_bandResponseDb[band * count];
+    const BiquadCoeffs& coeffs = m_coeffs[band];
+    // Bands from m_responseCoeffs.size() on have not been evaluated yet.
+    if (static_cast<size_t>(band) == m_responseCoeffs.size()) {
+      computeBandResponse(band, bandDb, numPoints);
+      m_responseCoeffs.push_back(coeffs);
+    } else if (BiquadCoeffs& cached = m_responseCoeffs[band];
+               coeffs.b0 != cached.b0 || coeffs.b1 != cached.b1 ||
+               coeffs.b2 != cached.b2 || coeffs.a1 != cached.a1 ||
+               coeffs.a2 != cached.a2) {
+      computeBandResponse(band, bandDb, numPoints);
+      cached = coeffs;
     }
-
-    // Convert to dB
-    if (magLinear > 1e-10f) {
-      response[i] = 20.0f * std::log10(magLinear);
-    } else {
-      response[i] = -120.0f;  // Near-zero magnitude floor
+    for (size_t i = 0; i < count; ++i) {
+      responseDb[i] += bandDb[i];
     }
   }
 
-  // Update cache
-  m_cachedFrequencies = frequencies;
-  m_cachedBands = m_bands;
-  m_cachedFilterTypes = m_filterTypes;
-  m_cachedSampleRate = m_sampleRate;
-  m_cachedResponse = response;
-  m_cacheValid = true;
-
-  return response;
+  const float* mask = m_responseMask.data();
+  for (size_t i = 0; i < count; ++i) {
+    // Every band is flat outside (0, Nyquist); the floor matches a cascade
+    // magnitude below 1e-10.
+    const float db = responseDb[i] * mask[i];
+    responseDb[i] = db > -200.0f ? db : -120.0f;
+  }
 }
 
 float ParametricEqualizer::clamp(float value, float minVal, float maxVal) {
@@ -3,18 +3,15 @@
 
 #define _USE_MATH_DEFINES
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
 #include <vector>
 
 #include "AudioEffector.hpp"
-
-/**
- * @brief Biquad filter coefficient structure.
- */
-struct BiquadCoeffs {
-  float b0, b1, b2;
-  float a0, a1, a2;
-};
+#include "BiquadCascade.hpp"
+#include "ParameterTransport.hpp"
 
 enum class FilterType {
   PEAKING,
@@ -30,7 +27,17 @@ enum class FilterType {
  * @brief A parametric equalizer using IIR biquad filters.
  *
  * Supports multiple bands, each with adjustable center frequency, Q factor, and
- * gain. Uses cascaded biquad IIR filters for efficient processing.
+ * gain. The bands run as one BiquadCascade, which filters all of them in a
+ * single SIMD pass.
+ *
+ * Band setters compute coefficients on the calling (control) thread and
+ * publish them as one snapshot; process() loads the newest snapshot into the
+ * cascade at the start of a block. Band changes are not applied in one step:
+ * the coefficients are interpolated linearly from the old to the new set
+ * every kCoeffRampBlockSize samples over kCoeffRampTimeMs, which avoids
+ * zipper noise while a slider is dragged. Interpolating a1/a2 between two
+ * stable filters always yields a stable filter, since the stability triangle
+ * is convex. Sample rate and band count changes switch immediately.
  */
 class ParametricEqualizer : public AudioEffector {
  public:
@@ -43,6 +50,16 @@ class ParametricEqualizer : public AudioEffector {
     float gainDb;           // Gain in dB (-24.0 to +24.0)
   };
 
+  /**
+   * @brief A band together with its filter type, for setBands().
+   */
+  struct BandSettings {
+    FilterType type;
+    float frequency;  // Center or cutoff frequency in Hz
+    float Q;
+    float gainDb;  // Ignored by the types without gain
+  };
+
   /**
    * @brief Constructor for ParametricEqualizer.
    *
@@ -142,6 +159,17 @@ class ParametricEqualizer : public AudioEffector {
    */
   void setBandAsAllpass(int bandIndex, float centerFrequency, float Q);
 
+  /**
+   * @brief Sets bands 0 to bands.size() - 1 at once, e.g. from a preset.
+   *
+   * The bands are clamped like the single-band setters and published as one
+   * snapshot, so they ramp to their new values together. Bands beyond the
+   * band count are ignored.
+   *
+   * @param bands Settings per band, starting at band 0.
+   */
+  void setBands(const std::vector<BandSettings>& bands);
+
   /**
    * @brief Gets the center frequency of a band.
    *
@@ -167,17 +195,21 @@ class ParametricEqualizer : public AudioEffector {
   float getGain(int bandIndex) const;
 
   /**
-   * @brief Computes the frequency response at specified points.
+   * @brief Computes the magnitude response of all bands at the given points.
    *
-   * Uses the biquad coefficients to calculate the magnitude response
-   * via the complex transfer function H(e^(jω)).
+   * Control thread. Cheap to call repeatedly, e.g. for every redraw while a
+   * band is dragged: the trigonometry for the points is done only when they
+   * or the sample rate change, and each band's response is kept and
+   * re-evaluated only when its coefficients change, so moving one band costs
+   * one band's worth of multiply-adds and logs over the grid.
    *
-   * @param frequencies Vector of frequency points in Hz (log-spaced
-   * recommended).
-   * @return Vector of magnitude responses in dB.
+   * @param frequencies Frequency points in Hz (log-spaced recommended).
+   * @param responseDb Receives numPoints magnitudes in dB; 0 dB at points
+   * outside (0, Nyquist).
+   * @param numPoints Number of points.
    */
-  std::vector<float> computeFrequencyResponse(
-      const std::vector<float>& frequencies);
+  void computeFrequencyResponse(const float* frequencies, float* responseDb,
+                                int numPoints);
 
   /**
    * @brief Enables or disables the equalizer.
@@ -185,14 +217,15 @@ class ParametricEqualizer : public AudioEffector {
    * @param enabled True to enable, false to bypass.
    */
 
-  void setEnabled(bool enabled) override { m_isEnabled = enabled; }
+  void setEnabled(bool enabled) override { m_isEnabled.store(enabled); }
 
   /**
    * @brief Checks if the equalizer is enabled.
    *
    * @return True if enabled, false if bypassed.
    */
-  bool isEnabled() const override { return m_isEnabled; }
+  bool isEnabled() const override { return m_isEnabled.load(); }
+  bool isBypassedWhenDisabled() const override { return true; }
 
  private:
   // Parameters
@@ -201,13 +234,34 @@ class ParametricEqualizer : public AudioEffector {
   std::vector<Band> m_bands;
   std::vector<FilterType> m_filterTypes;
 
-  // Biquad filter states
-  std::vector<std::vector<float>> m_z1;  // Delay line 1 per band
-  std::vector<std::vector<float>> m_z2;  // Delay line 2 per band
-
-  // Filter coefficients per band
+  // Filter coefficients per band, published to the audio thread
   std::vector<BiquadCoeffs> m_coeffs;
 
+  using CoeffArray = std::array<BiquadCoeffs, BiquadCascade::kMaxStages>;
+  struct CascadeSnapshot {
+    int numStages = 1;
+    CoeffArray coeffs{};
+    float sampleRate = 44100.0f;
+    // Bumped by sample rate and band count changes, which switch the
+    // coefficients immediately instead of ramping.
+    uint32_t resetCount = 0;
+  };
+  ParameterTransport<CascadeSnapshot> m_cascadeSnapshot;
+  uint32_t m_resetCount = 0;
+
+  static constexpr float kCoeffRampTimeMs = 20.0f;
+  static constexpr int kCoeffRampBlockSize = 32;
+
+  // Audio thread only.
+  BiquadCascade m_cascade;
+  CoeffArray m_activeCoeffs{};  // Coefficients loaded into m_cascade
+  CoeffArray m_rampFrom{};
+  CoeffArray m_rampTo{};
+  int m_rampSteps = 0;
+  int m_rampStep = 0;
+  int m_rampPhase = 0;  // Samples into the current ramp step
+  uint32_t m_appliedResetCount = 0;
+
   // Helper functions
   void computePeakingCoeffs(int bandIndex, float centerFrequency, float Q,
                             float gainDb);
@@ -219,20 +273,29 @@ class ParametricEqualizer : public AudioEffector {
                               float gainDb);
   void computeNotchCoeffs(int bandIndex, float centerFrequency, float Q);
   void computeAllpassCoeffs(int bandIndex, float centerFrequency, float Q);
+  void computeBandCoeffs(int bandIndex);
   void computeAllCoeffs();
-  float processBiquad(float input, int bandIndex);
+  void publishCoeffs();
+  void applySnapshot(const CascadeSnapshot& snapshot);
+  void loadRampStep();
   float clamp(float value, float minVal, float maxVal);
-  float computeBiquadMagnitude(int bandIndex, float frequency) const;
-  bool isCacheValid(const std::vector<float>& frequencies) const;
-
-  // Cache members
-  mutable std::vector<float> m_cachedResponse;
-  mutable std::vector<float> m_cachedFrequencies;
-  mutable std::vector<Band> m_cachedBands;
-  mutable std::vector<FilterType> m_cachedFilterTypes;
-  float m_cachedSampleRate;
-  bool m_cacheValid;
-  bool m_isEnabled = false;
+  void updateResponseGrid(const float* frequencies, int numPoints);
+  void computeBandResponse(int bandIndex, float* responseDb, int numPoints);
+
+  // Frequency response cache, control thread only.
+  static constexpr float kResponsePowerFloor = 1e-30f;
+  // The grid the tables below were computed for.
+  std::vector<float> m_responseFrequencies;
+  float m_responseSampleRate = 0.0f;
+  std::vector<float> m_responsePhi;   // sin^2(w/2) per point
+  std::vector<float> m_responseMask;  // 1 inside (0, Nyquist), else 0
+  std::vector<float> m_responseScratch;
+  // Response of each band in dB, m_numBands rows of the grid size, and the
+  // coefficients each row was computed from.
+  std::vector<float> m_bandResponseDb;
+  std::vector<BiquadCoeffs> m_responseCoeffs;
+
+  std::atomic<bool> m_isEnabled{false};
 };
 
 #endif  // EFFECT_PARAMETRIC_EQUALIZER_HPP
@@ -0,0 +1,165 @@
+#include "PolyphaseResampler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+// Stopband attenuation of about 80 dB.
+constexpr double kKaiserBeta = 7.86;
+// Passband edge, as a fraction of the lower rate's Nyquist frequency; the
+// stopband starts at Nyquist.
+constexpr double kPassband = 0.8;
+
+// Zeroth-order modified Bessel function of the first kind.
+double besselI0(double x) {
+  double sum = 1.0;
+  double term = 1.0;
+  for (int k = 1; k < 32; ++k) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+// Sum of a[i] * b[i] for a multiple of 16 samples.
+float dot(const float* a, const float* b, int n) {
+#if defined(__ARM_NEON)
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  float32x4_t acc2 = vdupq_n_f32(0.0f);
+  float32x4_t acc3 = vdupq_n_f32(0.0f);
+  for (int i = 0; i < n; i += 16) {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    acc2 = vmlaq_f32(acc2, vld1q_f32(a + i + 8), vld1q_f32(b + i + 8));
+    acc3 = vmlaq_f32(acc3, vld1q_f32(a + i + 12), vld1q_f32(b + i + 12));
+  }
+  const float32x4_t sum =
+      vaddq_f32(vaddq_f32(acc0, acc1), vaddq_f32(acc2, acc3));
+  const float32x2_t half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+  return vget_lane_f32(vpadd_f32(half, half), 0);
+#elif defined(__SSE2__)
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  __m128 acc2 = _mm_setzero_ps();
+  __m128 acc3 = _mm_setzero_ps();
+  for (int i = 0; i < n; i += 16) {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i),
+                                       _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4),
+                                       _mm_loadu_ps(b + i + 4)));
+    acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(a + i + 8),
+                                       _mm_loadu_ps(b + i + 8)));
+    acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(a + i + 12),
+                                       _mm_loadu_ps(b + i + 12)));
+  }
+  const __m128 sum = _mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3));
+  const __m128 pairs = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  return _mm_cvtss_f32(
+      _mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+#else
+  float acc[4] = {};
+  for (int i = 0; i < n; i += 4) {
+    for (int k = 0; k < 4; ++k) acc[k] += a[i + k] * b[i + k];
+  }
+  return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+}
+}  // namespace
+
+static_assert(PolyphaseResampler::kTapsPerPhase % 16 == 0,
+              "dot() handles multiples of 16 taps");
+
+bool PolyphaseResampler::configure(int inputRate, int outputRate,
+                                   int maxInputFrames) {
+  if (inputRate <= 0 || outputRate <= 0 || maxInputFrames <= 0) {
+    return false;
+  }
+  const int divisor = std::gcd(inputRate, outputRate);
+  const int up = outputRate / divisor;
+  const int down = inputRate / divisor;
+  if (up > kMaxPhases) {
+    return false;
+  }
+  m_up = up;
+  m_down = down;
+  // Scale the length with the decimation so that the transition band stays
+  // as narrow when downsampling.
+  m_taps = (kTapsPerPhase * std::max(up, down) / up + 15) / 16 * 16;
+  m_maxInputFrames = maxInputFrames;
+  // Outputs per block, rounded up, plus one for the phase carried over.
+  m_maxOutputFrames = static_cast<int>(
+      (static_cast<long long>(maxInputFrames) * up + down - 1) / down + 1);
+
+  // Prototype lowpass at the upsampled rate, split into m_up phases.
+  const int length = m_up * m_taps;
+  const double center = (length - 1) / 2.0;
+  const double cutoff = 0.5 * (1.0 + kPassband) / 2.0 / std::max(m_up, m_down);
+  const double normalization = besselI0(kKaiserBeta);
+  m_coefficients.assign(static_cast<size_t>(length), 0.0f);
+  for (int phase = 0; phase < m_up; ++phase) {
+    for (int k = 0; k < m_taps; ++k) {
+      const int n = phase + k * m_up;
+      const double t = n - center;
+      const double sinc =
+          t == 0.0 ? 2.0 * cutoff
+                   : std::sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+      const double r = t / (center + 0.5);
+      const double window =
+          besselI0(kKaiserBeta * std::sqrt(std::max(0.0, 1.0 - r * r))) /
+          normalization;
+      // Gain m_up restores the level lost to zero stuffing.
+      m_coefficients[static_cast<size_t>(phase * m_taps + m_taps - 1 - k)] =
+          static_cast<float>(m_up * sinc * window);
+    }
+  }
+
+  m_buffer.assign(static_cast<size_t>(m_taps - 1 + maxInputFrames),
+                  0.0f);
+  reset();
+  return true;
+}
+
+void PolyphaseResampler::reset() {
+  std::fill(m_buffer.begin(), m_buffer.end(), 0.0f);
+  m_phase = 0;
+  m_inputOffset = 0;
+}
+
+int PolyphaseResampler::process(const float* input, int numInput,
+                                float* output) {
+  numInput = std::min(numInput, m_maxInputFrames);
+  const int history = m_taps - 1;
+  std::memcpy(m_buffer.data() + history, input, sizeof(float) * numInput);
+
+  int produced = 0;
+  int index = m_inputOffset;
+  int phase = m_phase;
+  while (index < numInput) {
+    // The window ends at the current input sample, m_buffer[history + index].
+    output[produced++] = dot(m_buffer.data() + index,
+                             m_coefficients.data() + phase * m_taps, m_taps);
+    phase += m_down;
+    index += phase / m_up;
+    phase %= m_up;
+  }
+  m_phase = phase;
+  m_inputOffset = index - numInput;
+
+  // Keep the last history samples for the next block.
+  std::memmove(m_buffer.data(), m_buffer.data() + numInput,
+               sizeof(float) * history);
+  return produced;
+}
+
+double PolyphaseResampler::getDelayFrames() const {
+  return (m_up * m_taps - 1) / (2.0 * m_up);
+}
@@ -0,0 +1,79 @@
+#ifndef EFFECT_POLYPHASE_RESAMPLER_HPP
+#define EFFECT_POLYPHASE_RESAMPLER_HPP
+
+#include <vector>
+
+/**
+ * @brief Streaming rational-ratio resampler.
+ *
+ * Converts between two integer rates through a polyphase Kaiser-windowed
+ * sinc filter: the ratio is reduced to up / down, and every output sample is
+ * one dot product (NEON/SSE2) with the coefficients of its phase. Each phase
+ * has kTapsPerPhase taps at the lower of the two rates, so downsampling uses
+ * proportionally more input samples per output. The stopband starts at the
+ * Nyquist frequency of the lower rate and lies more than 70 dB down; the
+ * passband ends at 80% of it.
+ *
+ * configure() allocates and sizes the buffers for a maximum block; process()
+ * neither allocates nor locks, and may be called with any block size up to
+ * that maximum. Output is produced as soon as the input sample it lines up
+ * with has arrived, so the count per call varies by one or two around
+ * numInput * outputRate / inputRate.
+ */
+class PolyphaseResampler {
+ public:
+  // Filter length per phase, in samples of the lower rate.
+  static constexpr int kTapsPerPhase = 48;
+  // Largest reduced numerator accepted by configure(); 11025 <-> 48000 needs
+  // 640.
+  static constexpr int kMaxPhases = 1024;
+
+  /**
+   * @brief Designs the filter and allocates the buffers. Control thread
+   * only, while process() is not running.
+   *
+   * @return False if the rates are invalid or their ratio needs more than
+   * kMaxPhases phases; the resampler is then unusable.
+   */
+  bool configure(int inputRate, int outputRate, int maxInputFrames);
+
+  /**
+   * @brief Clears the history, as if the resampler had only seen silence.
+   */
+  void reset();
+
+  /**
+   * @brief Resamples a block.
+   *
+   * @param input numInput samples, at most the maxInputFrames of configure().
+   * @param output Room for at least getMaxOutputFrames() samples.
+   * @return Number of samples written to output.
+   */
+  int process(const float* input, int numInput, float* output);
+
+  int getMaxOutputFrames() const { return m_maxOutputFrames; }
+
+  /**
+   * @brief Group delay of the filter, in input frames.
+   */
+  double getDelayFrames() const;
+
+ private:
+  int m_up = 1;
+  int m_down = 1;
+  int m_maxInputFrames = 0;
+  int m_maxOutputFrames = 0;
+  // Taps per phase at the input rate, a multiple of 16.
+  int m_taps = kTapsPerPhase;
+  // Phase of the next output on the upsampled grid, in [0, m_up).
+  int m_phase = 0;
+  // Input sample the next output lines up with, relative to the start of the
+  // next block; it can lie beyond the current block when downsampling.
+  int m_inputOffset = 0;
+  // m_taps coefficients per phase, reversed for the dot product.
+  std::vector<float> m_coefficients;
+  // m_taps - 1 samples of history followed by the current block.
+  std::vector<float> m_buffer;
+};
+
+#endif  // EFFECT_POLYPHASE_RESAMPLER_HPP
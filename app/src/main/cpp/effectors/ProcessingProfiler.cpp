@@ -0,0 +1,166 @@
+#include "ProcessingProfiler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+void TimingHistogram::record(int64_t nanos, int64_t deadlineNanos) {
+  nanos = std::max<int64_t>(nanos, 0);
+  m_buckets[bucketIndex(nanos)].fetch_add(1, std::memory_order_relaxed);
+  m_totalNanos.fetch_add(static_cast<uint64_t>(nanos),
+                         std::memory_order_relaxed);
+  int64_t currentMax = m_maxNanos.load(std::memory_order_relaxed);
+  while (nanos > currentMax &&
+         !m_maxNanos.compare_exchange_weak(currentMax, nanos,
+                                           std::memory_order_relaxed)) {
+  }
+  if (deadlineNanos > 0 && nanos > deadlineNanos) {
+    m_deadlineMisses.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+TimingHistogram::Stats TimingHistogram::stats() const {
+  std::array<uint64_t, kNumBuckets> counts;
+  uint64_t total = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+
+  Stats stats;
+  if (total == 0) {
+    return stats;
+  }
+  const int64_t maxNanos = m_maxNanos.load(std::memory_order_relaxed);
+  stats.count = total;
+  stats.meanMicros =
+      static_cast<double>(m_totalNanos.load(std::memory_order_relaxed)) /
+      static_cast<double>(total) / 1000.0;
+  stats.p50Micros = percentileMicros(counts, total, 0.50, maxNanos);
+  stats.p95Micros = percentileMicros(counts, total, 0.95, maxNanos);
+  stats.p99Micros = percentileMicros(counts, total, 0.99, maxNanos);
+  stats.maxMicros = static_cast<double>(maxNanos) / 1000.0;
+  stats.deadlineMisses = m_deadlineMisses.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void TimingHistogram::reset() {
+  for (auto& bucket : m_buckets) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  m_totalNanos.store(0, std::memory_order_relaxed);
+  m_maxNanos.store(0, std::memory_order_relaxed);
+  m_deadlineMisses.store(0, std::memory_order_relaxed);
+}
+
+int TimingHistogram::bucketIndex(int64_t nanos) {
+  const uint64_t ticks = static_cast<uint64_t>(nanos) >> kTickShift;
+  if (ticks < kSubBuckets) {
+    return static_cast<int>(ticks);
+  }
+  // Bins per octave: the top two bits below the leading one pick the bin.
+  const int octave = std::bit_width(ticks) - 1;
+  const int sub = static_cast<int>(ticks >> (octave - 2)) & (kSubBuckets - 1);
+  return std::min(kSubBuckets * (octave - 1) + sub, kNumBuckets - 1);
+}
+
+int64_t TimingHistogram::bucketLowerBoundNanos(int index) {
+  if (index < kSubBuckets) {
+    return static_cast<int64_t>(index) << kTickShift;
+  }
+  const int octave = index / kSubBuckets + 1;
+  const int sub = index % kSubBuckets;
+  return static_cast<int64_t>(kSubBuckets + sub) << (octave - 2 + kTickShift);
+}
+
+double TimingHistogram::percentileMicros(
+    const std::array<uint64_t, kNumBuckets>& counts, uint64_t total,
+    double fraction, int64_t maxNanos) const {
+  const uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(fraction * total)));
+  uint64_t cumulative = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    cumulative += counts[i];
+    if (cumulative >= rank) {
+      // Report the bin's upper edge, which never understates the latency,
+      // but never beyond the exact maximum.
+      const int64_t upper = i + 1 < kNumBuckets
+                                ? bucketLowerBoundNanos(i + 1)
+                                : maxNanos;
+      return static_cast<double>(std::min(upper, maxNanos)) / 1000.0;
+    }
+  }
+  return static_cast<double>(maxNanos) / 1000.0;
+}
+
+int ProcessingProfiler::addStage(const std::string& name) {
+  const int index = m_numStages.load(std::memory_order_relaxed);
+  if (index >= kMaxStages) {
+    return -1;
+  }
+  Stage& stage = m_stages[index];
+  const size_t length = std::min(name.size(), kMaxNameLength);
+  std::copy_n(name.data(), length, stage.name);
+  stage.name[length] = '\0';
+  stage.histogram.reset();
+  m_numStages.store(index + 1, std::memory_order_release);
+  return index;
+}
+
+void ProcessingProfiler::clearStages() {
+  m_numStages.store(0, std::memory_order_release);
+}
+
+ProcessingProfiler::Snapshot ProcessingProfiler::snapshot() const {
+  Snapshot snapshot;
+  snapshot.callback = m_callback.stats();
+  snapshot.chain = m_chain.stats();
+  const int numStages = m_numStages.load(std::memory_order_acquire);
+  snapshot.stages.reserve(numStages);
+  for (int i = 0; i < numStages; ++i) {
+    snapshot.stages.push_back(
+        {m_stages[i].name, m_stages[i].histogram.stats()});
+  }
+  return snapshot;
+}
+
+void ProcessingProfiler::reset() {
+  m_callback.reset();
+  m_chain.reset();
+  for (auto& stage : m_stages) {
+    stage.histogram.reset();
+  }
+}
+
+std::string ProcessingProfiler::formatReport() const {
+  const Snapshot current = snapshot();
+  std::string report;
+  char line[160];
+  auto append = [&](const char* name, const TimingHistogram::Stats& stats) {
+    std::snprintf(line, sizeof(line),
+                  "%-16s %10llu %9.1f %9.1f %9.1f %9.1f %9.1f %8llu\n", name,
+                  static_cast<unsigned long long>(stats.count),
+                  stats.meanMicros, stats.p50Micros, stats.p95Micros,
+                  stats.p99Micros, stats.maxMicros,
+                  static_cast<unsigned long long>(stats.deadlineMisses));
+    report += line;
+  };
+  std::snprintf(line, sizeof(line), "%-16s %10s %9s %9s %9s %9s %9s %8s\n",
+                "stage", "count", "mean_us", "p50_us", "p95_us", "p99_us",
+                "max_us", "misses");
+  report += line;
+  append("callback", current.callback);
+  append("chain", current.chain);
+  for (const auto& stage : current.stages) {
+    append(stage.name.c_str(), stage.stats);
+  }
+  return report;
+}
+
+int64_t ProcessingProfiler::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
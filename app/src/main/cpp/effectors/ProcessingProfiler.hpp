@@ -0,0 +1,148 @@
+#ifndef PROCESSING_PROFILER_HPP
+#define PROCESSING_PROFILER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Lock-free timing histogram for one processing stage.
+ *
+ * Durations are binned on a log scale with four bins per octave (at most
+ * 25% relative error), starting at 256 ns and saturating above ~0.5 s. The
+ * exact maximum is tracked separately. record() only performs relaxed atomic
+ * updates, so it can run on the audio thread while another thread reads.
+ */
+class TimingHistogram {
+ public:
+  struct Stats {
+    uint64_t count = 0;
+    double meanMicros = 0.0;
+    double p50Micros = 0.0;
+    double p95Micros = 0.0;
+    double p99Micros = 0.0;
+    double maxMicros = 0.0;
+    uint64_t deadlineMisses = 0;
+  };
+
+  /**
+   * @brief Adds one measurement.
+   *
+   * @param nanos Measured duration.
+   * @param deadlineNanos Time budget; 0 disables the deadline check.
+   */
+  void record(int64_t nanos, int64_t deadlineNanos);
+
+  /**
+   * @brief Computes statistics over everything recorded since the last reset.
+   */
+  Stats stats() const;
+
+  /**
+   * @brief Clears all counters. Measurements recorded concurrently may be
+   * partially lost.
+   */
+  void reset();
+
+ private:
+  static constexpr int kTickShift = 8;  // 256 ns per tick
+  static constexpr int kSubBuckets = 4;
+  static constexpr int kNumBuckets = 80;
+
+  static int bucketIndex(int64_t nanos);
+  static int64_t bucketLowerBoundNanos(int index);
+  double percentileMicros(const std::array<uint64_t, kNumBuckets>& counts,
+                          uint64_t total, double fraction,
+                          int64_t maxNanos) const;
+
+  std::array<std::atomic<uint64_t>, kNumBuckets> m_buckets{};
+  std::atomic<uint64_t> m_totalNanos{0};
+  std::atomic<int64_t> m_maxNanos{0};
+  std::atomic<uint64_t> m_deadlineMisses{0};
+};
+
+/**
+ * @brief Real-time profiler for the audio callback and the effector chain.
+ *
+ * Keeps one TimingHistogram for the whole callback, one for a full pass of
+ * the effector chain and one per chain stage. Stages are registered with
+ * addStage() while audio is stopped; the record calls never allocate or lock.
+ * Recording is off until setEnabled(true), and callers skip taking timestamps
+ * while it is off.
+ */
+class ProcessingProfiler {
+ public:
+  static constexpr int kMaxStages = 16;
+  static constexpr size_t kMaxNameLength = 31;
+
+  struct StageSnapshot {
+    std::string name;
+    TimingHistogram::Stats stats;
+  };
+
+  struct Snapshot {
+    TimingHistogram::Stats callback;
+    TimingHistogram::Stats chain;
+    std::vector<StageSnapshot> stages;
+  };
+
+  /**
+   * @brief Registers a stage and returns its index, or -1 if all stage slots
+   * are in use. Not real-time safe.
+   */
+  int addStage(const std::string& name);
+
+  /**
+   * @brief Removes every stage. Not real-time safe.
+   */
+  void clearStages();
+
+  void setEnabled(bool enabled) {
+    m_isEnabled.store(enabled, std::memory_order_relaxed);
+  }
+  bool isEnabled() const {
+    return m_isEnabled.load(std::memory_order_relaxed);
+  }
+
+  void recordCallback(int64_t nanos, int64_t deadlineNanos) {
+    m_callback.record(nanos, deadlineNanos);
+  }
+  void recordChain(int64_t nanos, int64_t deadlineNanos) {
+    m_chain.record(nanos, deadlineNanos);
+  }
+  void recordStage(int stage, int64_t nanos, int64_t deadlineNanos) {
+    if (stage >= 0 && stage < kMaxStages) {
+      m_stages[stage].histogram.record(nanos, deadlineNanos);
+    }
+  }
+
+  Snapshot snapshot() const;
+  void reset();
+
+  /**
+   * @brief Formats the current snapshot as a plain-text table, one line per
+   * histogram, for logs and command-line tools.
+   */
+  std::string formatReport() const;
+
+  /**
+   * @brief Monotonic timestamp in nanoseconds.
+   */
+  static int64_t now();
+
+ private:
+  struct Stage {
+    char name[kMaxNameLength + 1] = {};
+    TimingHistogram histogram;
+  };
+
+  std::atomic<bool> m_isEnabled{false};
+  std::atomic<int> m_numStages{0};
+  TimingHistogram m_callback;
+  TimingHistogram m_chain;
+  std::array<Stage, kMaxStages> m_stages;
+};
+
+#endif  // PROCESSING_PROFILER_HPP
@@ -1,6 +1,7 @@
 #include "RNNoiseProcessor.hpp"
 
 #include <algorithm>
+#include <cmath>
 
 RNNoiseProcessor::RNNoiseProcessor() {
   mFrameSize = rnnoise_get_frame_size();
@@ -31,23 +32,12 @@ void RNNoiseProcessor::process(const float* inputBuffer, float* outputBuffer,
   m_inputPeakDb.store(20.0f * std::log10(inputPeak));
 
   if (mIsEnabled && mRnnoiseState != nullptr && mFrameSize > 0 &&
-      numSamples == mFrameSize && mSampleRate == 48000.0f) {
-    // RNNoise processes PCM-scale floats (int16 range, ~±32768), not normalized
-    // float samples (±1.0) used by the Oboe pipeline. Scale up before
-    // processing and back down afterward. A separate buffer is required because
-    // inputBuffer and outputBuffer may alias (in-place processing in the
-    // chain).
-    constexpr float kPcmScale = 32768.0f;
-    constexpr float kPcmScaleInv = 1.0f / kPcmScale;
-
-    for (int i = 0; i < numSamples; ++i) {
-      m_scaledInputBuffer[i] = inputBuffer[i] * kPcmScale;
+      numSamples % mFrameSize == 0 && mSampleRate == kSampleRate) {
+    for (int offset = 0; offset < numSamples; offset += mFrameSize) {
+      processFrame(inputBuffer + offset, outputBuffer + offset);
     }
-    mLastVadProbability = rnnoise_process_frame(mRnnoiseState, outputBuffer,
-                                                m_scaledInputBuffer.data());
     auto outputPeak = 1e-8f;
     for (int i = 0; i < numSamples; ++i) {
-      outputBuffer[i] = outputBuffer[i] * kPcmScaleInv;
       outputPeak = std::max(outputPeak, std::abs(outputBuffer[i]));
     }
     m_outputPeakDb.store(20.0f * std::log10(outputPeak));
@@ -58,3 +48,22 @@ void RNNoiseProcessor::process(const float* inputBuffer, float* outputBuffer,
     m_outputPeakDb.store(m_inputPeakDb.load());
   }
 }
+
+void RNNoiseProcessor::processFrame(const float* inputFrame,
+                                    float* outputFrame) {
+  // RNNoise processes PCM-scale floats (int16 range, ~±32768), not normalized
+  // float samples (±1.0) used by the Oboe pipeline. Scale up before
+  // processing and back down afterward. A separate buffer is required because
+  // inputFrame and outputFrame may alias (in-place processing in the chain).
+  constexpr float kPcmScale = 32768.0f;
+  constexpr float kPcmScaleInv = 1.0f / kPcmScale;
+
+  for (int i = 0; i < mFrameSize; ++i) {
+    m_scaledInputBuffer[i] = inputFrame[i] * kPcmScale;
+  }
+  mLastVadProbability.store(rnnoise_process_frame(
+      mRnnoiseState, outputFrame, m_scaledInputBuffer.data()));
+  for (int i = 0; i < mFrameSize; ++i) {
+    outputFrame[i] = outputFrame[i] * kPcmScaleInv;
+  }
+}
@@ -9,6 +9,11 @@
 
 class RNNoiseProcessor : public AudioEffector {
  public:
+  // The only rate RNNoise's model works at; other rates are passed through,
+  // as are blocks that are not a whole number of frames. Wrap the processor
+  // in a BlockAdapter and a ResamplingEffector to run it on any stream.
+  static constexpr float kSampleRate = 48000.0f;
+
   RNNoiseProcessor();
   ~RNNoiseProcessor() override;
 
@@ -18,22 +23,27 @@ class RNNoiseProcessor : public AudioEffector {
   void setSampleRate(float sampleRate) override { mSampleRate = sampleRate; }
   float getSampleRate() const { return mSampleRate; }
 
-  void setEnabled(bool enabled) override { mIsEnabled = enabled; }
-  bool isEnabled() const override { return mIsEnabled; }
+  void setEnabled(bool enabled) override { mIsEnabled.store(enabled); }
+  bool isEnabled() const override { return mIsEnabled.load(); }
+  bool isBypassedWhenDisabled() const override { return true; }
 
   int getFrameSize() const { return mFrameSize; }
-  float getLastVadProbability() const { return mLastVadProbability; }
+  float getLastVadProbability() const { return mLastVadProbability.load(); }
   bool isReady() const { return mRnnoiseState != nullptr; }
 
   float getInputPeakDb() const { return m_inputPeakDb.load(); }
   float getOutputPeakDb() const { return m_outputPeakDb.load(); }
 
  private:
+  // Denoises exactly one RNNoise frame. inputFrame and outputFrame may alias.
+  void processFrame(const float* inputFrame, float* outputFrame);
+
   DenoiseState* mRnnoiseState = nullptr;
   int mFrameSize = 0;
-  float mSampleRate = 48000.0f;
-  bool mIsEnabled = false;
-  float mLastVadProbability = 0.0f;
+  float mSampleRate = kSampleRate;
+  std::atomic<bool> mIsEnabled{false};
+  // Read by VoiceActivityDetector and the UI.
+  std::atomic<float> mLastVadProbability{0.0f};
   std::atomic<float> m_outputPeakDb = -100.0f;
   std::atomic<float> m_inputPeakDb = -100.0f;
   std::vector<float> m_scaledInputBuffer;
@@ -0,0 +1,108 @@
+#include "ResamplingEffector.hpp"
+
+#include <logging_macros.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace {
+// The number of samples the downsampler returns per chunk differs from the
+// chunk size by at most two, in either direction.
+constexpr int kPrimingFrames = 2;
+}  // namespace
+
+ResamplingEffector::ResamplingEffector(std::shared_ptr<AudioEffector> effector,
+                                       float internalSampleRate)
+    : m_effector(std::move(effector)),
+      m_internalSampleRate(internalSampleRate) {}
+
+void ResamplingEffector::setSampleRate(float sampleRate) {
+  m_sampleRate = sampleRate;
+  m_effector->setSampleRate(m_internalSampleRate);
+
+  const int streamRate = static_cast<int>(std::lround(sampleRate));
+  const int internalRate = static_cast<int>(std::lround(m_internalSampleRate));
+  m_isResampling = false;
+  if (streamRate == internalRate) {
+    return;
+  }
+  if (!m_upsampler.configure(streamRate, internalRate, kChunkSize)) {
+    LOGW("Cannot resample %d Hz to %d Hz; the effector is bypassed",
+         streamRate, internalRate);
+    return;
+  }
+  m_downsampler.configure(internalRate, streamRate,
+                          m_upsampler.getMaxOutputFrames());
+  m_internalBuffer.assign(
+      static_cast<size_t>(m_upsampler.getMaxOutputFrames()), 0.0f);
+  m_fifo.assign(static_cast<size_t>(kChunkSize + kPrimingFrames +
+                                    m_downsampler.getMaxOutputFrames()),
+                0.0f);
+  m_isResampling = true;
+  resetResampling();
+}
+
+void ResamplingEffector::process(const float* inputBuffer, float* outputBuffer,
+                                 int numSamples) {
+  const bool enabled = m_effector->isEnabled();
+  if (!m_isResampling || !enabled) {
+    if (enabled) {
+      // Equal rates: nothing to convert.
+      m_effector->process(inputBuffer, outputBuffer, numSamples);
+    } else if (inputBuffer != outputBuffer) {
+      std::copy(inputBuffer, inputBuffer + numSamples, outputBuffer);
+    }
+    m_wasResampling = false;
+    return;
+  }
+
+  if (!m_wasResampling) {
+    // Start from silence rather than from a stale history.
+    resetResampling();
+    m_wasResampling = true;
+  }
+  for (int offset = 0; offset < numSamples; offset += kChunkSize) {
+    const int count = std::min(kChunkSize, numSamples - offset);
+    processChunk(inputBuffer + offset, outputBuffer + offset, count);
+  }
+}
+
+void ResamplingEffector::processChunk(const float* inputBuffer,
+                                      float* outputBuffer, int numSamples) {
+  const int internalCount = m_upsampler.process(inputBuffer, numSamples,
+                                                m_internalBuffer.data());
+  m_effector->process(m_internalBuffer.data(), m_internalBuffer.data(),
+                      internalCount);
+  m_fifoCount += m_downsampler.process(
+      m_internalBuffer.data(), internalCount, m_fifo.data() + m_fifoCount);
+
+  const int available = std::min(numSamples, m_fifoCount);
+  std::copy(m_fifo.begin(), m_fifo.begin() + available, outputBuffer);
+  // Not expected with kPrimingFrames; keeps the output length regardless.
+  std::fill(outputBuffer + available, outputBuffer + numSamples, 0.0f);
+  m_fifoCount -= available;
+  std::memmove(m_fifo.data(), m_fifo.data() + available,
+               sizeof(float) * m_fifoCount);
+}
+
+void ResamplingEffector::resetResampling() {
+  m_upsampler.reset();
+  m_downsampler.reset();
+  std::fill(m_fifo.begin(), m_fifo.end(), 0.0f);
+  m_fifoCount = kPrimingFrames;
+}
+
+int ResamplingEffector::getLatencyFrames() const {
+  if (!m_isResampling || !m_effector->isEnabled()) {
+    return m_effector->isEnabled() ? m_effector->getLatencyFrames() : 0;
+  }
+  const double ratio = m_sampleRate / m_internalSampleRate;
+  const double frames = m_upsampler.getDelayFrames() +
+                        (m_downsampler.getDelayFrames() +
+                         m_effector->getLatencyFrames()) *
+                            ratio +
+                        kPrimingFrames;
+  return static_cast<int>(std::lround(frames));
+}
@@ -0,0 +1,70 @@
+#ifndef EFFECT_RESAMPLING_EFFECTOR_HPP
+#define EFFECT_RESAMPLING_EFFECTOR_HPP
+
+#include <memory>
+#include <vector>
+
+#include "AudioEffector.hpp"
+#include "PolyphaseResampler.hpp"
+
+/**
+ * @brief Runs an effector at a fixed internal rate, whatever the stream
+ * rate.
+ *
+ * Each block is resampled to the internal rate, processed by the wrapped
+ * effector, resampled back and passed through a short FIFO that evens out
+ * the varying number of samples per block. At equal rates, or while the
+ * wrapped effector is disabled, blocks go straight to the effector and no
+ * latency is added.
+ *
+ * Buffers are allocated in setSampleRate(); process() works in chunks of at
+ * most kChunkSize frames so that any block size is accepted.
+ */
+class ResamplingEffector : public AudioEffector {
+ public:
+  static constexpr int kChunkSize = 256;
+
+  ResamplingEffector(std::shared_ptr<AudioEffector> effector,
+                     float internalSampleRate);
+
+  void process(const float* inputBuffer, float* outputBuffer,
+               int numSamples) override;
+
+  /**
+   * @brief Sets the stream rate and configures the resamplers. The wrapped
+   * effector always runs at the internal rate.
+   */
+  void setSampleRate(float sampleRate) override;
+
+  void setEnabled(bool enabled) override { m_effector->setEnabled(enabled); }
+  bool isEnabled() const override { return m_effector->isEnabled(); }
+  bool isBypassedWhenDisabled() const override { return true; }
+
+  /**
+   * @brief Resampling delay plus the wrapped effector's latency, in frames
+   * at the stream rate.
+   */
+  int getLatencyFrames() const override;
+
+ private:
+  void processChunk(const float* inputBuffer, float* outputBuffer,
+                    int numSamples);
+  void resetResampling();
+
+  std::shared_ptr<AudioEffector> m_effector;
+  const float m_internalSampleRate;
+  float m_sampleRate = 0.0f;
+  bool m_isResampling = false;
+  // Whether the previous block went through the resamplers (audio thread).
+  bool m_wasResampling = false;
+
+  PolyphaseResampler m_upsampler;    // stream rate -> internal rate
+  PolyphaseResampler m_downsampler;  // internal rate -> stream rate
+  std::vector<float> m_internalBuffer;
+  // Resampled output waiting to be returned; starts with kPrimingFrames of
+  // silence so that it never runs dry.
+  std::vector<float> m_fifo;
+  int m_fifoCount = 0;
+};
+
+#endif  // EFFECT_RESAMPLING_EFFECTOR_HPP
@@ -0,0 +1,49 @@
+#include "VoiceActivityDetector.hpp"
+
+#include <algorithm>
+#include <utility>
+
+VoiceActivityDetector::VoiceActivityDetector(
+    std::shared_ptr<const RNNoiseProcessor> rnnoise,
+    std::shared_ptr<const NoiseGate> noiseGate)
+    : m_rnnoise(std::move(rnnoise)), m_noiseGate(std::move(noiseGate)) {}
+
+void VoiceActivityDetector::setThreshold(float probability) {
+  m_threshold.store(std::clamp(probability, 0.0f, 1.0f));
+}
+
+void VoiceActivityDetector::setHangover(float hangoverMs) {
+  m_hangoverMs.store(std::max(hangoverMs, 0.0f));
+}
+
+void VoiceActivityDetector::setSampleRate(float sampleRate) {
+  m_sampleRate = sampleRate;
+  m_silentFrames = 0;
+}
+
+bool VoiceActivityDetector::update(int numSamples) {
+  if (!m_isEnabled.load()) {
+    m_silentFrames = 0;
+    return true;
+  }
+
+  bool hasSource = false;
+  bool isSpeech = false;
+  if (m_rnnoise && m_rnnoise->isEnabled() && m_rnnoise->isReady()) {
+    hasSource = true;
+    isSpeech |= m_rnnoise->getLastVadProbability() >= m_threshold.load();
+  }
+  if (m_noiseGate && m_noiseGate->isEnabled()) {
+    hasSource = true;
+    isSpeech |= m_noiseGate->isAboveThreshold();
+  }
+  if (!hasSource || isSpeech) {
+    m_silentFrames = 0;
+    return true;
+  }
+
+  m_silentFrames += numSamples;
+  const auto hangoverFrames =
+      static_cast<int64_t>(m_hangoverMs.load() * m_sampleRate / 1000.0f);
+  return m_silentFrames <= hangoverFrames;
+}
@@ -0,0 +1,73 @@
+#ifndef EFFECT_VOICE_ACTIVITY_DETECTOR_HPP
+#define EFFECT_VOICE_ACTIVITY_DETECTOR_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "NoiseGate.hpp"
+#include "RNNoiseProcessor.hpp"
+
+/**
+ * @brief Decides from upstream effectors whether the current block is
+ * speech, so that an expensive stage can pause during silence.
+ *
+ * A block counts as speech if RNNoise's voice probability reaches the
+ * threshold or the noise gate's detector is above its threshold. Only
+ * enabled sources are asked, and with neither enabled every block counts as
+ * speech. Silence is only reported once it has lasted for the hangover
+ * time, so that word endings and short pauses are never cut off.
+ *
+ * Both sources must run earlier in the same chain, so their state
+ * describes the block that is being classified.
+ */
+class VoiceActivityDetector {
+ public:
+  static constexpr float kDefaultThreshold = 0.5f;
+  static constexpr float kDefaultHangoverMs = 300.0f;
+
+  VoiceActivityDetector(std::shared_ptr<const RNNoiseProcessor> rnnoise,
+                        std::shared_ptr<const NoiseGate> noiseGate);
+
+  void setEnabled(bool enabled) { m_isEnabled.store(enabled); }
+  bool isEnabled() const { return m_isEnabled.load(); }
+
+  /**
+   * @brief RNNoise voice probability, 0 to 1, from which a block is speech.
+   */
+  void setThreshold(float probability);
+  float getThreshold() const { return m_threshold.load(); }
+
+  /**
+   * @brief How long silence must last before update() reports it, in ms.
+   */
+  void setHangover(float hangoverMs);
+  float getHangover() const { return m_hangoverMs.load(); }
+
+  /**
+   * @brief Sets the rate the hangover is counted at and starts over.
+   * Control thread, while the audio thread is not calling update().
+   */
+  void setSampleRate(float sampleRate);
+
+  /**
+   * @brief Classifies the block of numSamples that the sources have just
+   * processed. Audio thread only.
+   *
+   * @return False once silence has outlasted the hangover; always true
+   * while disabled.
+   */
+  bool update(int numSamples);
+
+ private:
+  std::shared_ptr<const RNNoiseProcessor> m_rnnoise;
+  std::shared_ptr<const NoiseGate> m_noiseGate;
+  std::atomic<bool> m_isEnabled{false};
+  std::atomic<float> m_threshold{kDefaultThreshold};
+  std::atomic<float> m_hangoverMs{kDefaultHangoverMs};
+  float m_sampleRate = 48000.0f;
+  // Length of the current silence, in frames (audio thread).
+  int64_t m_silentFrames = 0;
+};
+
+#endif  // EFFECT_VOICE_ACTIVITY_DETECTOR_HPP
@@ -0,0 +1,57 @@
+#include "VoiceGate.hpp"
+
+#include <algorithm>
+#include <utility>
+
+VoiceGate::VoiceGate() { setSampleRate(48000.0f); }
+
+void VoiceGate::setDetector(std::shared_ptr<VoiceActivityDetector> detector) {
+  m_detector = std::move(detector);
+  m_isSkipping.store(false);
+  m_lookBehindSize = 0;
+  m_replaySize = 0;
+}
+
+void VoiceGate::setSampleRate(float sampleRate) {
+  if (m_detector) {
+    m_detector->setSampleRate(sampleRate);
+  }
+  m_lookBehind.assign(
+      static_cast<size_t>(kDefaultLookBehindMs * sampleRate / 1000.0f), 0.0f);
+  m_isSkipping.store(false);
+  m_lookBehindSize = 0;
+  m_replaySize = 0;
+}
+
+VoiceGate::Action VoiceGate::update(const float* input, int numSamples) {
+  m_replaySize = 0;
+  const bool isSpeech = !m_detector || m_detector->update(numSamples);
+  const bool wasSkipping = m_isSkipping.load();
+  if (!isSpeech && wasSkipping) {
+    keep(input, numSamples);
+    return Action::kSkip;
+  }
+  if (wasSkipping) {
+    m_replaySize = m_lookBehindSize;
+    m_lookBehindSize = 0;
+  }
+  m_isSkipping.store(!isSpeech);
+  return isSpeech ? Action::kRun : Action::kRunAndFade;
+}
+
+void VoiceGate::keep(const float* input, int numSamples) {
+  const int capacity = static_cast<int>(m_lookBehind.size());
+  if (numSamples >= capacity) {
+    std::copy(input + numSamples - capacity, input + numSamples,
+              m_lookBehind.begin());
+    m_lookBehindSize = capacity;
+    return;
+  }
+  const int dropped = std::max(m_lookBehindSize + numSamples - capacity, 0);
+  std::copy(m_lookBehind.begin() + dropped,
+            m_lookBehind.begin() + m_lookBehindSize, m_lookBehind.begin());
+  m_lookBehindSize -= dropped;
+  std::copy(input, input + numSamples,
+            m_lookBehind.begin() + m_lookBehindSize);
+  m_lookBehindSize += numSamples;
+}
@@ -0,0 +1,79 @@
+#ifndef EFFECT_VOICE_GATE_HPP
+#define EFFECT_VOICE_GATE_HPP
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "VoiceActivityDetector.hpp"
+
+/**
+ * @brief Decides block by block whether an expensive stage runs, from a
+ * VoiceActivityDetector, without clipping word onsets.
+ *
+ * The detector only reports speech once it has heard some, so the block in
+ * which a word starts is usually classified as silence. While the stage is
+ * paused the gate therefore keeps the latest input, up to the look-behind;
+ * on the first block of speech the stage runs over that input before the
+ * block itself, and the stage's own delay carries the onset into the
+ * output.
+ */
+class VoiceGate {
+ public:
+  static constexpr float kDefaultLookBehindMs = 20.0f;
+
+  enum class Action {
+    // Output silence without running the stage.
+    kSkip,
+    // Run the stage, after getReplay() if there is any.
+    kRun,
+    // Run the stage and fade its output out: the last block before a pause.
+    kRunAndFade,
+  };
+
+  VoiceGate();
+
+  /**
+   * @brief Attaches the detector, or detaches it with nullptr, and starts
+   * over. Control thread, while the audio thread is not calling update().
+   */
+  void setDetector(std::shared_ptr<VoiceActivityDetector> detector);
+
+  /**
+   * @brief Sets the rate of the detector and of the look-behind, and starts
+   * over. Control thread, while the audio thread is not calling update().
+   */
+  void setSampleRate(float sampleRate);
+
+  /**
+   * @brief True while the stage is paused for silence.
+   */
+  bool isSkipping() const { return m_isSkipping.load(); }
+
+  /**
+   * @brief Classifies the block of numSamples in input, which the
+   * detector's sources have just processed. Audio thread only.
+   */
+  Action update(const float* input, int numSamples);
+
+  /**
+   * @brief Input from the pause that the stage must run over before the
+   * block that update() has just returned kRun for, oldest first. Empty
+   * unless that block ends a pause; valid until the next update().
+   */
+  const float* getReplay() const { return m_lookBehind.data(); }
+  int getReplaySize() const { return m_replaySize; }
+
+ private:
+  // Appends to the look-behind, dropping its oldest samples.
+  void keep(const float* input, int numSamples);
+
+  std::shared_ptr<VoiceActivityDetector> m_detector;
+  std::atomic<bool> m_isSkipping{false};
+  // Latest input of the pause, oldest first; at most its capacity.
+  std::vector<float> m_lookBehind;
+  int m_lookBehindSize = 0;
+  int m_replaySize = 0;
+};
+
+#endif  // EFFECT_VOICE_GATE_HPP
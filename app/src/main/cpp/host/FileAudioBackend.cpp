@@ -0,0 +1,40 @@
+#include "FileAudioBackend.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include "beatriceDuplexCore.h"
+
+FileAudioBackend::Result FileAudioBackend::run(const std::vector<float>& input,
+                                               float sampleRate,
+                                               std::vector<float>& output) {
+  BeatriceDuplexCore core(m_effector, false, m_config.blockSize,
+                          m_config.bufferCount);
+  const size_t latency = core.getFrameSize() * core.getBufferCount() +
+                         static_cast<size_t>(m_effector->getLatencyFrames());
+  const size_t callbackSize = std::max<size_t>(m_config.callbackSize, 1);
+
+  // Pad with silence so that the tail of the input leaves the pipeline.
+  std::vector<float> padded(input);
+  padded.resize(input.size() + latency, 0.0f);
+  std::vector<float> processed(padded.size());
+
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t offset = 0; offset < padded.size(); offset += callbackSize) {
+    const size_t count = std::min(callbackSize, padded.size() - offset);
+    core.process(&padded[offset], &processed[offset], count);
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  output.assign(processed.begin() + latency, processed.end());
+
+  Result result;
+  result.numSamples = input.size();
+  result.audioSeconds = input.size() / static_cast<double>(sampleRate);
+  result.processingSeconds =
+      std::chrono::duration<double>(end - start).count();
+  result.realTimeFactor = result.audioSeconds > 0.0
+                              ? result.processingSeconds / result.audioSeconds
+                              : 0.0;
+  return result;
+}
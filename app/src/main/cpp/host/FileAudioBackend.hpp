@@ -0,0 +1,49 @@
+#ifndef HOST_FILE_AUDIO_BACKEND_HPP
+#define HOST_FILE_AUDIO_BACKEND_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "effectors/AudioEffector.hpp"
+
+/**
+ * @brief Runs a recording through the duplex pipeline as fast as possible.
+ *
+ * The signal is fed to BeatriceDuplexCore in callback-sized pieces, exactly
+ * as an Oboe callback would, with inline (sync) processing so that the
+ * result is deterministic. The pipeline delay, including the effector's
+ * reported latency, is removed from the output, so output[i] corresponds to
+ * input[i].
+ */
+class FileAudioBackend {
+ public:
+  struct Config {
+    size_t blockSize = 480;
+    size_t bufferCount = 2;
+    // Frames per simulated callback.
+    size_t callbackSize = 192;
+  };
+
+  struct Result {
+    size_t numSamples = 0;
+    double audioSeconds = 0.0;
+    double processingSeconds = 0.0;
+    // Processing time divided by audio duration; below 1 is faster than real
+    // time.
+    double realTimeFactor = 0.0;
+  };
+
+  FileAudioBackend(std::shared_ptr<AudioEffector> effector,
+                   const Config& config)
+      : m_effector(effector), m_config(config) {}
+
+  Result run(const std::vector<float>& input, float sampleRate,
+             std::vector<float>& output);
+
+ private:
+  std::shared_ptr<AudioEffector> m_effector;
+  Config m_config;
+};
+
+#endif  // HOST_FILE_AUDIO_BACKEND_HPP
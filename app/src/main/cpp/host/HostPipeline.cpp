@@ -0,0 +1,179 @@
+#include "HostPipeline.hpp"
+
+#include <logging_macros.h>
+
+#include <algorithm>
+#include <exception>
+
+namespace {
+void applyEqualizerBand(ParametricEqualizer& equalizer, int index,
+                        const HostSettings::EqualizerBand& band) {
+  switch (band.type) {
+    case 0:
+      equalizer.setBandAsPeaking(index, band.frequency, band.q, band.gain);
+      break;
+    case 1:
+      equalizer.setBandAsLowpass(index, band.frequency, band.q);
+      break;
+    case 2:
+      equalizer.setBandAsHighpass(index, band.frequency, band.q);
+      break;
+    case 3:
+      equalizer.setBandAsLowShelf(index, band.frequency, band.q, band.gain);
+      break;
+    case 4:
+      equalizer.setBandAsHighShelf(index, band.frequency, band.q, band.gain);
+      break;
+    case 5:
+      equalizer.setBandAsNotch(index, band.frequency, band.q);
+      break;
+    case 6:
+      equalizer.setBandAsAllpass(index, band.frequency, band.q);
+      break;
+    default:
+      LOGW("Unknown EQ band type %d", band.type);
+      break;
+  }
+}
+}  // namespace
+
+bool HostPipeline::create(const Options& options) {
+  m_options = options;
+  m_settings.reset();
+  m_profiler = std::make_shared<ProcessingProfiler>();
+  m_hasProcessor = false;
+
+  if (!options.modelPath.empty()) {
+#if BEATRICE_HOST_WITH_PROCESSOR
+    try {
+      m_processor = std::make_shared<BeatriceProcessor>(options.modelPath);
+      m_hasProcessor = true;
+    } catch (const std::exception& e) {
+      LOGE("Failed to read model: %s", e.what());
+      return false;
+    }
+#else
+    LOGE("This host build has no Beatrice library; cannot load %s",
+         options.modelPath.c_str());
+    return false;
+#endif
+  }
+  buildChain(options.sampleRate);
+  return true;
+}
+
+void HostPipeline::buildChain(float sampleRate) {
+  m_chain = std::make_shared<AudioEffectorChain>();
+  m_chain->setProfiler(m_profiler);
+
+  m_amplifier = std::make_shared<Amplifier>(0.0f);
+  m_rnnoise = std::make_shared<RNNoiseProcessor>();
+  m_rnnoiseStage = std::make_shared<ResamplingEffector>(
+      std::make_shared<BlockAdapter>(m_rnnoise, m_rnnoise->getFrameSize()),
+      RNNoiseProcessor::kSampleRate);
+  m_noiseGate = std::make_shared<NoiseGate>();
+  m_compressor = std::make_shared<Compressor>();
+  m_dynamics = std::make_shared<DynamicsEngine>(m_noiseGate, m_compressor);
+  m_preEqualizer = std::make_shared<ParametricEqualizer>(48000.0f, 3);
+  m_postEqualizer = std::make_shared<ParametricEqualizer>(48000.0f, 5);
+  m_limiter = std::make_shared<Limiter>();
+  m_voiceActivityDetector =
+      std::make_shared<VoiceActivityDetector>(m_rnnoise, m_noiseGate);
+
+  m_chain->addEffector(m_amplifier, "amplifier");
+  m_chain->addEffector(m_rnnoiseStage, "rnnoise");
+  m_chain->addEffector(m_dynamics, "dynamics");
+  m_chain->addEffector(m_preEqualizer, "pre_equalizer");
+#if BEATRICE_HOST_WITH_PROCESSOR
+  if (m_processor) {
+    m_processor->setVoiceActivityDetector(m_voiceActivityDetector);
+    m_chain->addEffector(m_processor, "beatrice");
+  }
+#endif
+  m_chain->addEffector(m_postEqualizer, "post_equalizer");
+  m_chain->addEffector(m_limiter, "limiter");
+
+  m_chain->setSampleRate(sampleRate);
+  if (m_options.enableEffects) {
+    m_chain->setEnabled(true);
+  }
+}
+
+void HostPipeline::applySettings(const HostSettings& settings) {
+  m_settings = settings;
+#if BEATRICE_HOST_WITH_PROCESSOR
+  if (m_processor) {
+    m_processor->setVoiceID(settings.voiceId);
+    m_processor->setInputGain(settings.inputGain);
+    m_processor->setOutputGain(settings.outputGain);
+    m_processor->setPitchShift(settings.pitchShift);
+    m_processor->setFormantShift(settings.formantShift);
+    m_processor->setVQNumNeighbors(settings.vqNeighbors);
+    m_processor->setIntonationIntensity(settings.intonationIntensity);
+    m_processor->setPitchCorrection(settings.pitchCorrection);
+    m_processor->setPitchCorrectionMode(settings.pitchCorrectionMode);
+    m_processor->setSourcePitchRange(settings.sourcePitchMin,
+                                     settings.sourcePitchMax);
+
+    std::array<float, beatrice::common::kMaxNSpeakers> weights{};
+    if (settings.morphingWeights.empty()) {
+      weights[0] = 1.0f;
+    } else {
+      std::copy_n(settings.morphingWeights.begin(),
+                  std::min(settings.morphingWeights.size(), weights.size()),
+                  weights.begin());
+    }
+    m_processor->setSpeakerMorphingWeights(weights);
+  }
+#endif
+
+  m_voiceActivityDetector->setEnabled(settings.silenceSkipEnabled);
+  m_voiceActivityDetector->setThreshold(settings.silenceSkipThreshold);
+  m_voiceActivityDetector->setHangover(settings.silenceSkipHangover);
+
+  m_amplifier->setEnabled(settings.amplifierEnabled);
+  m_amplifier->setGain(settings.amplifierGain);
+
+  m_rnnoise->setEnabled(settings.rnnoiseEnabled);
+
+  m_noiseGate->setEnabled(settings.noiseGateEnabled);
+  m_noiseGate->setThreshold(settings.noiseGateThreshold);
+  m_noiseGate->setRange(settings.noiseGateRange);
+  m_noiseGate->setAttack(settings.noiseGateAttack);
+  m_noiseGate->setRelease(settings.noiseGateRelease);
+
+  m_compressor->setEnabled(settings.compressorEnabled);
+  m_compressor->setThreshold(settings.compressorThreshold);
+  m_compressor->setRatio(settings.compressorRatio);
+  m_compressor->setAttack(settings.compressorAttack);
+  m_compressor->setRelease(settings.compressorRelease);
+  m_compressor->setMakeupGain(settings.compressorMakeupGain);
+
+  m_limiter->setEnabled(settings.limiterEnabled);
+  m_limiter->setThreshold(settings.limiterThreshold);
+  m_limiter->setAttack(settings.limiterAttack);
+  m_limiter->setRelease(settings.limiterRelease);
+  m_limiter->setLookAhead(settings.limiterLookAhead);
+
+  m_preEqualizer->setEnabled(settings.preEqualizerEnabled);
+  for (size_t i = 0; i < settings.preEqualizerBands.size(); ++i) {
+    applyEqualizerBand(*m_preEqualizer, static_cast<int>(i),
+                       settings.preEqualizerBands[i]);
+  }
+  m_postEqualizer->setEnabled(settings.postEqualizerEnabled);
+  for (size_t i = 0; i < settings.postEqualizerBands.size(); ++i) {
+    applyEqualizerBand(*m_postEqualizer, static_cast<int>(i),
+                       settings.postEqualizerBands[i]);
+  }
+  m_chain->rebuildPlan();
+}
+
+void HostPipeline::reset(float sampleRate) {
+  // Fresh effectors rather than a reset method on each: nothing of the
+  // previous file can survive in a filter, envelope, FIFO or RNNoise state.
+  // The processor is kept; setSampleRate() reloads its core.
+  buildChain(sampleRate);
+  if (m_settings) {
+    applySettings(*m_settings);
+  }
+}
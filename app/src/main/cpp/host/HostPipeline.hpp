@@ -0,0 +1,101 @@
+#ifndef HOST_PIPELINE_HPP
+#define HOST_PIPELINE_HPP
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "effectors/Amplifier.hpp"
+#include "effectors/AudioEffectorChain.hpp"
+#include "effectors/BlockAdapter.hpp"
+#include "effectors/Compressor.hpp"
+#include "effectors/DynamicsEngine.hpp"
+#include "effectors/Limiter.hpp"
+#include "effectors/NoiseGate.hpp"
+#include "effectors/ParametricEqualizer.hpp"
+#include "effectors/ProcessingProfiler.hpp"
+#include "effectors/RNNoiseProcessor.hpp"
+#include "effectors/ResamplingEffector.hpp"
+#include "effectors/VoiceActivityDetector.hpp"
+#include "HostSettings.hpp"
+
+#if BEATRICE_HOST_WITH_PROCESSOR
+#include "beatriceProcessor.h"
+#endif
+
+/**
+ * @brief The app's effector chain, assembled without JNI or Oboe.
+ *
+ * Mirrors create()/resetEffectorChain() in native-lib.cpp: amplifier,
+ * RNNoise (resampled to 48 kHz), noise gate and compressor (one
+ * DynamicsEngine stage), pre-EQ, Beatrice, post-EQ, limiter. The Beatrice
+ * stage is only present when a model path is given and the host build
+ * links the Beatrice library (BEATRICE_HOST_WITH_PROCESSOR).
+ */
+class HostPipeline {
+ public:
+  struct Options {
+    float sampleRate = 48000.0f;
+    // Model TOML; empty runs the chain without the Beatrice stage.
+    std::string modelPath;
+    // Enables every effector with its default settings. Otherwise only the
+    // Beatrice stage is active, as on a fresh app install.
+    bool enableEffects = false;
+  };
+
+  /**
+   * @brief Builds the chain.
+   *
+   * @return False (after logging the reason) if the model cannot be loaded.
+   */
+  bool create(const Options& options);
+
+  /**
+   * @brief Applies user settings the way MainActivity does after the engine
+   * is created. Processor settings are skipped without a Beatrice stage.
+   */
+  void applySettings(const HostSettings& settings);
+
+  /**
+   * @brief Starts over at the given sample rate, so that consecutive
+   * recordings do not bleed into each other.
+   *
+   * Every effector except the Beatrice stage is rebuilt, with the last
+   * settings applied again; the Beatrice stage reloads its core, as opening
+   * the streams does on Android. The chain returned by getChain() is
+   * replaced.
+   */
+  void reset(float sampleRate);
+
+  std::shared_ptr<AudioEffectorChain> getChain() const { return m_chain; }
+  std::shared_ptr<ProcessingProfiler> getProfiler() const {
+    return m_profiler;
+  }
+  bool hasProcessor() const { return m_hasProcessor; }
+
+ private:
+  // Builds every effector but the processor, and the chain around them.
+  void buildChain(float sampleRate);
+
+  Options m_options;
+  // The last settings applied, for reset() to apply again.
+  std::optional<HostSettings> m_settings;
+  std::shared_ptr<AudioEffectorChain> m_chain;
+  std::shared_ptr<ProcessingProfiler> m_profiler;
+  std::shared_ptr<Amplifier> m_amplifier;
+  std::shared_ptr<RNNoiseProcessor> m_rnnoise;
+  std::shared_ptr<ResamplingEffector> m_rnnoiseStage;
+  std::shared_ptr<NoiseGate> m_noiseGate;
+  std::shared_ptr<Compressor> m_compressor;
+  std::shared_ptr<DynamicsEngine> m_dynamics;
+  std::shared_ptr<ParametricEqualizer> m_preEqualizer;
+  std::shared_ptr<ParametricEqualizer> m_postEqualizer;
+  std::shared_ptr<Limiter> m_limiter;
+  std::shared_ptr<VoiceActivityDetector> m_voiceActivityDetector;
+#if BEATRICE_HOST_WITH_PROCESSOR
+  std::shared_ptr<BeatriceProcessor> m_processor;
+#endif
+  bool m_hasProcessor = false;
+};
+
+#endif  // HOST_PIPELINE_HPP
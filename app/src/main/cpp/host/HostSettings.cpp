@@ -0,0 +1,221 @@
+#include "HostSettings.hpp"
+
+#include <logging_macros.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+
+namespace {
+bool parseFloat(const std::string& text, float& value) {
+  char* end = nullptr;
+  const float parsed = std::strtof(text.c_str(), &end);
+  if (text.empty() || *end != '\0') {
+    return false;
+  }
+  value = parsed;
+  return true;
+}
+
+bool parseInt(const std::string& text, int32_t& value) {
+  char* end = nullptr;
+  const long parsed = std::strtol(text.c_str(), &end, 10);
+  if (text.empty() || *end != '\0') {
+    return false;
+  }
+  value = static_cast<int32_t>(parsed);
+  return true;
+}
+
+bool parseBool(const std::string& text, bool& value) {
+  if (text == "true" || text == "1") {
+    value = true;
+  } else if (text == "false" || text == "0") {
+    value = false;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Semicolon-separated, as SettingsManager.saveMorphingWeights writes them.
+bool parseWeights(const std::string& text, std::vector<float>& weights) {
+  std::vector<float> parsed;
+  size_t begin = 0;
+  while (begin <= text.size()) {
+    const size_t end = std::min(text.find(';', begin), text.size());
+    float weight = 0.0f;
+    if (!parseFloat(text.substr(begin, end - begin), weight)) {
+      return false;
+    }
+    parsed.push_back(weight);
+    begin = end + 1;
+  }
+  weights = std::move(parsed);
+  return true;
+}
+
+std::string trim(const std::string& text) {
+  const auto begin = text.find_first_not_of(" \t\r");
+  if (begin == std::string::npos) {
+    return {};
+  }
+  const auto end = text.find_last_not_of(" \t\r");
+  return text.substr(begin, end - begin + 1);
+}
+
+// "preset_<n>_pitch_shift" -> "pitch_shift".
+std::string stripPresetPrefix(const std::string& key) {
+  static const std::string kPrefix = "preset_";
+  if (key.rfind(kPrefix, 0) != 0) {
+    return key;
+  }
+  size_t pos = kPrefix.size();
+  while (pos < key.size() &&
+         std::isdigit(static_cast<unsigned char>(key[pos]))) {
+    ++pos;
+  }
+  if (pos == kPrefix.size() || pos >= key.size() || key[pos] != '_') {
+    return key;
+  }
+  return key.substr(pos + 1);
+}
+
+template <size_t N>
+bool setEqualizerBand(std::array<HostSettings::EqualizerBand, N>& bands,
+                      const std::string& key, const std::string& value) {
+  // key is "<index>_<field>".
+  const auto separator = key.find('_');
+  int32_t index = -1;
+  if (separator == std::string::npos ||
+      !parseInt(key.substr(0, separator), index) || index < 0 ||
+      index >= static_cast<int32_t>(N)) {
+    return false;
+  }
+  auto& band = bands[index];
+  const auto field = key.substr(separator + 1);
+  if (field == "type") {
+    return parseInt(value, band.type) && band.type >= 0 && band.type <= 6;
+  }
+  if (field == "freq") {
+    return parseFloat(value, band.frequency);
+  }
+  if (field == "q") {
+    return parseFloat(value, band.q);
+  }
+  if (field == "gain") {
+    return parseFloat(value, band.gain);
+  }
+  return false;
+}
+}  // namespace
+
+bool HostSettings::set(const std::string& rawKey, const std::string& value) {
+  using Setter = std::function<bool(HostSettings&, const std::string&)>;
+  auto floatField = [](float HostSettings::*field) -> Setter {
+    return [field](HostSettings& s, const std::string& v) {
+      return parseFloat(v, s.*field);
+    };
+  };
+  auto intField = [](int32_t HostSettings::*field) -> Setter {
+    return [field](HostSettings& s, const std::string& v) {
+      return parseInt(v, s.*field);
+    };
+  };
+  auto boolField = [](bool HostSettings::*field) -> Setter {
+    return [field](HostSettings& s, const std::string& v) {
+      return parseBool(v, s.*field);
+    };
+  };
+  static const std::map<std::string, Setter> kSetters = {
+      {"voice_id", intField(&HostSettings::voiceId)},
+      {"input_gain", floatField(&HostSettings::inputGain)},
+      {"output_gain", floatField(&HostSettings::outputGain)},
+      {"pitch_shift", floatField(&HostSettings::pitchShift)},
+      {"formant_shift", floatField(&HostSettings::formantShift)},
+      {"vq_neighbors", intField(&HostSettings::vqNeighbors)},
+      {"intonation_intensity",
+       floatField(&HostSettings::intonationIntensity)},
+      {"pitch_correction", floatField(&HostSettings::pitchCorrection)},
+      {"pitch_correction_mode", intField(&HostSettings::pitchCorrectionMode)},
+      {"source_pitch_range_min", floatField(&HostSettings::sourcePitchMin)},
+      {"source_pitch_range_max", floatField(&HostSettings::sourcePitchMax)},
+      {"morphing_weights",
+       [](HostSettings& s, const std::string& v) {
+         return parseWeights(v, s.morphingWeights);
+       }},
+      {"silence_skip_enabled", boolField(&HostSettings::silenceSkipEnabled)},
+      {"silence_skip_threshold",
+       floatField(&HostSettings::silenceSkipThreshold)},
+      {"silence_skip_hangover", floatField(&HostSettings::silenceSkipHangover)},
+      {"amplifier_enabled", boolField(&HostSettings::amplifierEnabled)},
+      {"amplifier_gain", floatField(&HostSettings::amplifierGain)},
+      {"rnnoise_enabled", boolField(&HostSettings::rnnoiseEnabled)},
+      {"noise_gate_enabled", boolField(&HostSettings::noiseGateEnabled)},
+      {"noise_gate_threshold", floatField(&HostSettings::noiseGateThreshold)},
+      {"noise_gate_range", floatField(&HostSettings::noiseGateRange)},
+      {"noise_gate_attack", floatField(&HostSettings::noiseGateAttack)},
+      {"noise_gate_release", floatField(&HostSettings::noiseGateRelease)},
+      {"compressor_enabled", boolField(&HostSettings::compressorEnabled)},
+      {"compressor_threshold",
+       floatField(&HostSettings::compressorThreshold)},
+      {"compressor_ratio", floatField(&HostSettings::compressorRatio)},
+      {"compressor_attack", floatField(&HostSettings::compressorAttack)},
+      {"compressor_release", floatField(&HostSettings::compressorRelease)},
+      {"compressor_makeup_gain",
+       floatField(&HostSettings::compressorMakeupGain)},
+      {"limiter_enabled", boolField(&HostSettings::limiterEnabled)},
+      {"limiter_threshold", floatField(&HostSettings::limiterThreshold)},
+      {"limiter_attack", floatField(&HostSettings::limiterAttack)},
+      {"limiter_release", floatField(&HostSettings::limiterRelease)},
+      {"limiter_look_ahead", floatField(&HostSettings::limiterLookAhead)},
+      {"pre_equalizer_enabled", boolField(&HostSettings::preEqualizerEnabled)},
+      {"post_equalizer_enabled",
+       boolField(&HostSettings::postEqualizerEnabled)},
+  };
+
+  const std::string key = stripPresetPrefix(rawKey);
+  if (auto it = kSetters.find(key); it != kSetters.end()) {
+    return it->second(*this, value);
+  }
+  static const std::string kPreBand = "pre_eq_band_";
+  static const std::string kPostBand = "post_eq_band_";
+  if (key.rfind(kPreBand, 0) == 0) {
+    return setEqualizerBand(preEqualizerBands, key.substr(kPreBand.size()),
+                            value);
+  }
+  if (key.rfind(kPostBand, 0) == 0) {
+    return setEqualizerBand(postEqualizerBands, key.substr(kPostBand.size()),
+                            value);
+  }
+  return false;
+}
+
+bool readSettingsFile(const std::string& path, HostSettings& settings) {
+  std::ifstream file(path);
+  if (!file) {
+    LOGE("Cannot open settings file %s", path.c_str());
+    return false;
+  }
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(file, line)) {
+    ++lineNumber;
+    line = trim(line.substr(0, line.find('#')));
+    if (line.empty()) {
+      continue;
+    }
+    const auto separator = line.find('=');
+    if (separator == std::string::npos ||
+        !settings.set(trim(line.substr(0, separator)),
+                      trim(line.substr(separator + 1)))) {
+      LOGE("%s:%d: invalid setting '%s'", path.c_str(), lineNumber,
+           line.c_str());
+      return false;
+    }
+  }
+  return true;
+}
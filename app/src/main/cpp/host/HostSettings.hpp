@@ -0,0 +1,90 @@
+#ifndef HOST_SETTINGS_HPP
+#define HOST_SETTINGS_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The user settings the app applies to the engine, with the app's
+ * defaults (SettingsManager.kt).
+ *
+ * A settings file holds one "key = value" pair per line, using the keys of
+ * the app's shared preferences (for example "pitch_shift = 2.0" or
+ * "pre_eq_band_1_gain = -3"); '#' starts a comment. Preset keys such as
+ * "preset_2_pitch_shift" are accepted too, so an exported preference file can
+ * be trimmed down to one slot. Missing keys keep their defaults.
+ */
+struct HostSettings {
+  // EQ type codes, in the order of FilterType.
+  struct EqualizerBand {
+    int32_t type = 0;
+    float frequency = 1000.0f;
+    float q = 0.7f;
+    float gain = 0.0f;
+  };
+
+  int32_t voiceId = 0;
+  float inputGain = 0.0f;
+  float outputGain = 0.0f;
+  float pitchShift = 0.0f;
+  float formantShift = 0.0f;
+  int32_t vqNeighbors = 1;
+  float intonationIntensity = 1.0f;
+  float pitchCorrection = 0.0f;
+  int32_t pitchCorrectionMode = 0;
+  float sourcePitchMin = 33.125f;
+  float sourcePitchMax = 80.875f;
+  // Empty selects the first voice, as the app does without saved weights.
+  std::vector<float> morphingWeights;
+  bool silenceSkipEnabled = false;
+  float silenceSkipThreshold = 0.5f;
+  float silenceSkipHangover = 300.0f;
+
+  bool amplifierEnabled = true;
+  float amplifierGain = 0.0f;
+  bool rnnoiseEnabled = false;
+  bool noiseGateEnabled = false;
+  float noiseGateThreshold = -40.0f;
+  float noiseGateRange = -80.0f;
+  float noiseGateAttack = 5.0f;
+  float noiseGateRelease = 50.0f;
+  bool compressorEnabled = false;
+  float compressorThreshold = -12.0f;
+  float compressorRatio = 2.0f;
+  float compressorAttack = 5.0f;
+  float compressorRelease = 50.0f;
+  float compressorMakeupGain = 0.0f;
+  bool limiterEnabled = true;
+  float limiterThreshold = -3.0f;
+  float limiterAttack = 5.0f;
+  float limiterRelease = 50.0f;
+  float limiterLookAhead = 0.0f;
+
+  bool preEqualizerEnabled = false;
+  std::array<EqualizerBand, 3> preEqualizerBands{
+      EqualizerBand{0, 100.0f}, EqualizerBand{0, 1000.0f},
+      EqualizerBand{0, 10000.0f}};
+  bool postEqualizerEnabled = false;
+  std::array<EqualizerBand, 5> postEqualizerBands{
+      EqualizerBand{0, 30.0f}, EqualizerBand{0, 100.0f},
+      EqualizerBand{0, 300.0f}, EqualizerBand{0, 1000.0f},
+      EqualizerBand{0, 10000.0f}};
+
+  /**
+   * @brief Sets one value by its preference key.
+   *
+   * @return False if the key is unknown or the value does not parse.
+   */
+  bool set(const std::string& key, const std::string& value);
+};
+
+/**
+ * @brief Reads a settings file on top of the defaults in settings.
+ *
+ * @return False (after logging the offending line) on a malformed file.
+ */
+bool readSettingsFile(const std::string& path, HostSettings& settings);
+
+#endif  // HOST_SETTINGS_HPP
@@ -0,0 +1,100 @@
+#include "SimulatedAudioBackend.hpp"
+
+#include <logging_macros.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "beatriceDuplexCore.h"
+
+namespace {
+void requestRealTimePriority() {
+  sched_param param{};
+  param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+  if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+    LOGW("SCHED_FIFO unavailable; simulated callbacks run at normal priority");
+  }
+}
+}  // namespace
+
+SimulatedAudioBackend::Result SimulatedAudioBackend::run() {
+  if (!m_config.realTime) {
+    return runOnCurrentThread();
+  }
+  Result result;
+  std::thread callbackThread([this, &result]() {
+    requestRealTimePriority();
+    result = runOnCurrentThread();
+  });
+  callbackThread.join();
+  return result;
+}
+
+SimulatedAudioBackend::Result SimulatedAudioBackend::runOnCurrentThread() {
+  using Clock = std::chrono::steady_clock;
+
+  const int32_t burst = std::max(m_config.framesPerBurst, 1);
+  const int64_t numCallbacks = static_cast<int64_t>(
+      m_config.seconds * m_config.sampleRate / burst);
+  const auto period = std::chrono::nanoseconds(
+      static_cast<int64_t>(1e9 * burst / m_config.sampleRate));
+  const auto slack = period * std::max(m_config.bufferBursts - 1, 0);
+
+  BeatriceDuplexCore core(m_effector, m_config.useAsyncProcessing,
+                          m_config.blockSize, m_config.bufferCount);
+  std::vector<float> input(burst);
+  std::vector<float> output(burst);
+  std::minstd_rand random(1);
+  std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+  const double phaseStep = 2.0 * M_PI * m_config.toneHz / m_config.sampleRate;
+  double phase = 0.0;
+
+  Result result;
+  const auto start = Clock::now();
+  for (int64_t i = 0; i < numCallbacks; ++i) {
+    // The device asks for data at fixed times and catches up after a late
+    // callback, so the schedule never drifts.
+    const auto due = start + period * i;
+    if (m_config.realTime) {
+      std::this_thread::sleep_until(due);
+    }
+
+    // Generating the input stands in for the device's DMA and is not timed.
+    for (int32_t n = 0; n < burst; ++n) {
+      input[n] = m_config.toneLevel * static_cast<float>(std::sin(phase)) +
+                 m_config.noiseLevel * noise(random);
+      phase = std::fmod(phase + phaseStep, 2.0 * M_PI);
+    }
+
+    const auto callbackStart = Clock::now();
+    core.process(input.data(), output.data(), burst);
+    const auto callbackEnd = Clock::now();
+
+    if (m_profiler && m_profiler->isEnabled()) {
+      m_profiler->recordCallback(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(callbackEnd -
+                                                               callbackStart)
+              .count(),
+          period.count());
+    }
+    if (m_config.realTime ? callbackEnd > due + slack
+                          : callbackEnd - callbackStart > slack) {
+      ++result.xruns;
+    }
+    ++result.callbacks;
+  }
+
+  result.wallSeconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  result.audioSeconds =
+      static_cast<double>(numCallbacks) * burst / m_config.sampleRate;
+  result.overruns = core.getOverrunCount();
+  result.underruns = core.getUnderrunCount();
+  return result;
+}
@@ -0,0 +1,63 @@
+#ifndef HOST_SIMULATED_AUDIO_BACKEND_HPP
+#define HOST_SIMULATED_AUDIO_BACKEND_HPP
+
+#include <cstdint>
+#include <memory>
+
+#include "effectors/AudioEffector.hpp"
+#include "effectors/ProcessingProfiler.hpp"
+
+/**
+ * @brief Emulates a full-duplex audio device that calls back every burst.
+ *
+ * Each callback receives framesPerBurst samples of a test signal (a tone plus
+ * white noise) and runs them through BeatriceDuplexCore, just like
+ * BeatriceFullDuplexPass does on Android. The device holds bufferBursts
+ * bursts, so a callback that finishes more than (bufferBursts - 1) burst
+ * periods after it was due is counted as an XRun.
+ *
+ * In real-time mode callbacks are paced by the wall clock on a thread that
+ * asks for SCHED_FIFO (best effort), so the async worker competes for CPU as
+ * on a device. Otherwise callbacks run back to back to measure throughput.
+ */
+class SimulatedAudioBackend {
+ public:
+  struct Config {
+    int32_t sampleRate = 48000;
+    int32_t framesPerBurst = 192;
+    int32_t bufferBursts = 2;
+    double seconds = 10.0;
+    bool realTime = true;
+    bool useAsyncProcessing = false;
+    size_t blockSize = 480;
+    size_t bufferCount = 2;
+    float toneHz = 220.0f;
+    float toneLevel = 0.25f;
+    float noiseLevel = 0.01f;
+  };
+
+  struct Result {
+    uint64_t callbacks = 0;
+    uint64_t xruns = 0;
+    uint64_t overruns = 0;
+    uint64_t underruns = 0;
+    double wallSeconds = 0.0;
+    double audioSeconds = 0.0;
+  };
+
+  SimulatedAudioBackend(std::shared_ptr<AudioEffector> effector,
+                        std::shared_ptr<ProcessingProfiler> profiler,
+                        const Config& config)
+      : m_effector(effector), m_profiler(profiler), m_config(config) {}
+
+  Result run();
+
+ private:
+  Result runOnCurrentThread();
+
+  std::shared_ptr<AudioEffector> m_effector;
+  std::shared_ptr<ProcessingProfiler> m_profiler;
+  Config m_config;
+};
+
+#endif  // HOST_SIMULATED_AUDIO_BACKEND_HPP
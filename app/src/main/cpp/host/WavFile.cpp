@@ -0,0 +1,177 @@
+#include "WavFile.hpp"
+
+#include <logging_macros.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+constexpr uint16_t kFormatPcm = 1;
+constexpr uint16_t kFormatFloat = 3;
+constexpr uint16_t kFormatExtensible = 0xFFFE;
+
+uint16_t readU16(const uint8_t* p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t readU32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) |
+         (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void writeU16(std::ofstream& ofs, uint16_t value) {
+  const uint8_t bytes[] = {static_cast<uint8_t>(value),
+                           static_cast<uint8_t>(value >> 8)};
+  ofs.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+void writeU32(std::ofstream& ofs, uint32_t value) {
+  const uint8_t bytes[] = {
+      static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8),
+      static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 24)};
+  ofs.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+float decodeSample(const uint8_t* p, uint16_t format, uint16_t bits) {
+  if (format == kFormatFloat) {
+    if (bits == 32) {
+      float value;
+      std::memcpy(&value, p, sizeof(value));
+      return value;
+    }
+    double value;
+    std::memcpy(&value, p, sizeof(value));
+    return static_cast<float>(value);
+  }
+  switch (bits) {
+    case 16:
+      return static_cast<int16_t>(readU16(p)) / 32768.0f;
+    case 24: {
+      int32_t value = static_cast<int32_t>(p[0] | (p[1] << 8) | (p[2] << 16));
+      if (value & 0x800000) {
+        value -= 0x1000000;
+      }
+      return value / 8388608.0f;
+    }
+    default:
+      return static_cast<int32_t>(readU32(p)) / 2147483648.0f;
+  }
+}
+}  // namespace
+
+bool readWavFile(const std::string& path, WavData& data) {
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs) {
+    LOGE("Cannot open %s", path.c_str());
+    return false;
+  }
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(ifs)),
+                             std::istreambuf_iterator<char>());
+  if (bytes.size() < 12 || std::memcmp(bytes.data(), "RIFF", 4) != 0 ||
+      std::memcmp(bytes.data() + 8, "WAVE", 4) != 0) {
+    LOGE("%s is not a RIFF/WAVE file", path.c_str());
+    return false;
+  }
+
+  uint16_t format = 0;
+  uint16_t numChannels = 0;
+  uint32_t sampleRate = 0;
+  uint16_t bits = 0;
+  const uint8_t* payload = nullptr;
+  size_t payloadSize = 0;
+  size_t offset = 12;
+  while (offset + 8 <= bytes.size()) {
+    const uint8_t* chunk = bytes.data() + offset;
+    const size_t chunkSize = std::min<size_t>(readU32(chunk + 4),
+                                              bytes.size() - offset - 8);
+    if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16) {
+      format = readU16(chunk + 8);
+      numChannels = readU16(chunk + 10);
+      sampleRate = readU32(chunk + 12);
+      bits = readU16(chunk + 22);
+      if (format == kFormatExtensible && chunkSize >= 40) {
+        // The first two bytes of the sub-format GUID hold the real format.
+        format = readU16(chunk + 32);
+      }
+    } else if (std::memcmp(chunk, "data", 4) == 0) {
+      payload = chunk + 8;
+      payloadSize = chunkSize;
+    }
+    offset += 8 + chunkSize + (chunkSize & 1);
+  }
+
+  const bool supported =
+      (format == kFormatPcm && (bits == 16 || bits == 24 || bits == 32)) ||
+      (format == kFormatFloat && (bits == 32 || bits == 64));
+  if (!payload || numChannels == 0 || sampleRate == 0 || !supported) {
+    LOGE("%s: unsupported WAV format %u (%u bits, %u channels)", path.c_str(),
+         format, bits, numChannels);
+    return false;
+  }
+
+  const size_t bytesPerSample = bits / 8;
+  const size_t numSamples =
+      payloadSize / (bytesPerSample * numChannels) * numChannels;
+  data.sampleRate = static_cast<int32_t>(sampleRate);
+  data.numChannels = numChannels;
+  data.samples.resize(numSamples);
+  for (size_t i = 0; i < numSamples; ++i) {
+    data.samples[i] =
+        decodeSample(payload + i * bytesPerSample, format, bits);
+  }
+  return true;
+}
+
+bool writeWavFile(const std::string& path, const WavData& data) {
+  std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+  if (!ofs) {
+    LOGE("Cannot create %s", path.c_str());
+    return false;
+  }
+  const uint32_t dataSize =
+      static_cast<uint32_t>(data.samples.size() * sizeof(float));
+  const uint16_t blockAlign =
+      static_cast<uint16_t>(data.numChannels * sizeof(float));
+
+  ofs.write("RIFF", 4);
+  writeU32(ofs, 36 + dataSize);
+  ofs.write("WAVE", 4);
+  ofs.write("fmt ", 4);
+  writeU32(ofs, 16);
+  writeU16(ofs, kFormatFloat);
+  writeU16(ofs, static_cast<uint16_t>(data.numChannels));
+  writeU32(ofs, static_cast<uint32_t>(data.sampleRate));
+  writeU32(ofs, static_cast<uint32_t>(data.sampleRate) * blockAlign);
+  writeU16(ofs, blockAlign);
+  writeU16(ofs, 32);
+  ofs.write("data", 4);
+  writeU32(ofs, dataSize);
+  // WAV is little-endian, as are all supported hosts.
+  ofs.write(reinterpret_cast<const char*>(data.samples.data()), dataSize);
+
+  if (!ofs) {
+    LOGE("Failed to write %s", path.c_str());
+    return false;
+  }
+  return true;
+}
+
+std::vector<float> downmixToMono(const WavData& data) {
+  if (data.numChannels <= 1) {
+    return data.samples;
+  }
+  const size_t numFrames = data.numFrames();
+  std::vector<float> mono(numFrames);
+  const float scale = 1.0f / data.numChannels;
+  for (size_t i = 0; i < numFrames; ++i) {
+    float sum = 0.0f;
+    for (int32_t c = 0; c < data.numChannels; ++c) {
+      sum += data.samples[i * data.numChannels + c];
+    }
+    mono[i] = sum * scale;
+  }
+  return mono;
+}
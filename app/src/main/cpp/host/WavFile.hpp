@@ -0,0 +1,39 @@
+#ifndef HOST_WAV_FILE_HPP
+#define HOST_WAV_FILE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Decoded RIFF/WAVE audio with interleaved float samples in [-1, 1].
+ */
+struct WavData {
+  int32_t sampleRate = 48000;
+  int32_t numChannels = 1;
+  std::vector<float> samples;
+
+  size_t numFrames() const {
+    return numChannels > 0 ? samples.size() / numChannels : 0;
+  }
+};
+
+/**
+ * @brief Reads a WAV file with 16/24/32-bit PCM or 32/64-bit float samples,
+ * including WAVE_FORMAT_EXTENSIBLE headers.
+ *
+ * @return False (after logging the reason) if the file cannot be decoded.
+ */
+bool readWavFile(const std::string& path, WavData& data);
+
+/**
+ * @brief Writes data as a 32-bit float WAV file.
+ */
+bool writeWavFile(const std::string& path, const WavData& data);
+
+/**
+ * @brief Averages all channels into one.
+ */
+std::vector<float> downmixToMono(const WavData& data);
+
+#endif  // HOST_WAV_FILE_HPP
@@ -0,0 +1,238 @@
+// beatrice_batch: converts recordings offline with the app's pipeline.
+//
+//   beatrice_batch --output-dir <dir> [options] <input.wav>...
+//
+// Options:
+//   --model <path.toml>   add the Beatrice stage (needs the Beatrice library)
+//   --settings <file>     user settings to apply (see HostSettings.hpp)
+//   --list <file>         read further input paths from a file, one per line
+//   --jobs <n>            worker threads (default: number of cores)
+//   --block <n>           samples per process() call (default 8192)
+//
+// Each worker owns a complete pipeline, including its own BeatriceProcessor,
+// and takes the next file from a shared queue. Files are processed in large
+// blocks without the duplex queue, so the output is as long as the input and
+// is not delayed by the block/buffer settings of the live engine; the
+// latency the effectors report (limiter look-ahead) is removed as well.
+// Output files are mono 32-bit float WAVs named after their input.
+
+#include <logging_macros.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "HostPipeline.hpp"
+#include "HostSettings.hpp"
+#include "WavFile.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Arguments {
+  std::string modelPath;
+  std::string outputDir;
+  HostSettings settings;
+  std::vector<std::string> inputs;
+  unsigned int jobs = 0;
+  size_t blockSize = 8192;
+};
+
+struct FileResult {
+  bool ok = false;
+  size_t numSamples = 0;
+  double audioSeconds = 0.0;
+  double processingSeconds = 0.0;
+};
+
+void printUsage() {
+  std::fprintf(stderr,
+               "usage: beatrice_batch --output-dir <dir> [options] "
+               "<input.wav>...\n"
+               "options: --model <toml> --settings <file> --list <file>\n"
+               "         --jobs <n> --block <n>\n");
+}
+
+bool readInputList(const std::string& path, std::vector<std::string>& inputs) {
+  std::ifstream file(path);
+  if (!file) {
+    LOGE("Cannot open input list %s", path.c_str());
+    return false;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (!line.empty()) {
+      inputs.push_back(line);
+    }
+  }
+  return true;
+}
+
+bool parseArguments(int argc, char** argv, Arguments& args) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg.rfind("--", 0) != 0) {
+      args.inputs.push_back(arg);
+      continue;
+    }
+    if (i + 1 >= argc) {
+      LOGE("Missing value for %s", arg.c_str());
+      return false;
+    }
+    const char* value = argv[++i];
+    if (arg == "--model") {
+      args.modelPath = value;
+    } else if (arg == "--output-dir") {
+      args.outputDir = value;
+    } else if (arg == "--settings") {
+      if (!readSettingsFile(value, args.settings)) {
+        return false;
+      }
+    } else if (arg == "--list") {
+      if (!readInputList(value, args.inputs)) {
+        return false;
+      }
+    } else if (arg == "--jobs") {
+      args.jobs = static_cast<unsigned int>(std::strtoul(value, nullptr, 10));
+    } else if (arg == "--block") {
+      args.blockSize = std::strtoul(value, nullptr, 10);
+    } else {
+      LOGE("Unknown option %s", arg.c_str());
+      return false;
+    }
+  }
+  return !args.outputDir.empty() && !args.inputs.empty() && args.blockSize > 0;
+}
+
+FileResult convertFile(HostPipeline& pipeline, const std::string& inputPath,
+                       const std::string& outputPath, size_t blockSize) {
+  FileResult result;
+  WavData input;
+  if (!readWavFile(inputPath, input)) {
+    return result;
+  }
+  std::vector<float> mono = downmixToMono(input);
+  const size_t numSamples = mono.size();
+  WavData output;
+  output.sampleRate = input.sampleRate;
+  output.numChannels = 1;
+
+  const auto start = Clock::now();
+  pipeline.reset(static_cast<float>(input.sampleRate));
+  auto chain = pipeline.getChain();
+  // Pad with silence so that the tail of the input leaves the delay.
+  const size_t latency = static_cast<size_t>(chain->getLatencyFrames());
+  mono.resize(numSamples + latency, 0.0f);
+  output.samples.resize(mono.size());
+  for (size_t offset = 0; offset < mono.size(); offset += blockSize) {
+    const size_t count = std::min(blockSize, mono.size() - offset);
+    chain->process(&mono[offset], &output.samples[offset],
+                   static_cast<int>(count));
+  }
+  output.samples.erase(output.samples.begin(),
+                       output.samples.begin() + latency);
+  const auto end = Clock::now();
+
+  if (!writeWavFile(outputPath, output)) {
+    return result;
+  }
+  result.ok = true;
+  result.numSamples = numSamples;
+  result.audioSeconds = numSamples / static_cast<double>(input.sampleRate);
+  result.processingSeconds = std::chrono::duration<double>(end - start).count();
+  return result;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  Arguments args;
+  if (!parseArguments(argc, argv, args)) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+  std::error_code error;
+  std::filesystem::create_directories(args.outputDir, error);
+  if (error) {
+    LOGE("Cannot create %s: %s", args.outputDir.c_str(),
+         error.message().c_str());
+    return EXIT_FAILURE;
+  }
+
+  const unsigned int jobs = std::min<size_t>(
+      args.jobs > 0 ? args.jobs
+                    : std::max(std::thread::hardware_concurrency(), 1u),
+      args.inputs.size());
+
+  std::atomic<size_t> nextInput{0};
+  std::atomic<size_t> failures{0};
+  std::mutex printMutex;
+  double totalAudioSeconds = 0.0;
+
+  auto worker = [&]() {
+    HostPipeline::Options options;
+    options.modelPath = args.modelPath;
+    HostPipeline pipeline;
+    if (!pipeline.create(options)) {
+      // Leave the files to the other workers; if every worker fails they
+      // are all reported below.
+      return;
+    }
+    pipeline.applySettings(args.settings);
+
+    for (size_t i = nextInput.fetch_add(1); i < args.inputs.size();
+         i = nextInput.fetch_add(1)) {
+      const std::filesystem::path inputPath(args.inputs[i]);
+      const auto outputPath =
+          std::filesystem::path(args.outputDir) /
+          inputPath.filename().replace_extension(".wav");
+      const auto result = convertFile(pipeline, inputPath.string(),
+                                      outputPath.string(), args.blockSize);
+
+      std::lock_guard<std::mutex> lock(printMutex);
+      if (!result.ok) {
+        ++failures;
+        std::printf("%s failed\n", inputPath.string().c_str());
+        continue;
+      }
+      totalAudioSeconds += result.audioSeconds;
+      std::printf("%s samples %zu audio %.3f s processing %.3f s rtf %.4f\n",
+                  inputPath.string().c_str(), result.numSamples,
+                  result.audioSeconds, result.processingSeconds,
+                  result.audioSeconds > 0.0
+                      ? result.processingSeconds / result.audioSeconds
+                      : 0.0);
+      std::fflush(stdout);
+    }
+  };
+
+  const auto start = Clock::now();
+  std::vector<std::thread> workers;
+  for (unsigned int i = 0; i < jobs; ++i) {
+    workers.emplace_back(worker);
+  }
+  for (auto& thread : workers) {
+    thread.join();
+  }
+  const double wallSeconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+
+  // Files no worker got to (every pipeline failed to load) count as failed.
+  const size_t processed = std::min(nextInput.load(), args.inputs.size());
+  const size_t failed = failures + (args.inputs.size() - processed);
+  std::printf("files %zu failed %zu jobs %u audio %.3f s wall %.3f s "
+              "speed %.2fx real time\n",
+              args.inputs.size(), failed, jobs, totalAudioSeconds, wallSeconds,
+              wallSeconds > 0.0 ? totalAudioSeconds / wallSeconds : 0.0);
+  return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
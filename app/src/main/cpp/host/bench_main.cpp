@@ -0,0 +1,662 @@
+// beatrice_bench: micro-benchmarks for every AudioEffector.
+//
+//   beatrice_bench [options]
+//
+// Options:
+//   --format csv|json     output format (default csv)
+//   --filter <text>       only run effectors whose name contains text
+//   --min-time <s>        measuring time per case (default 0.05)
+//   --flush-denormals     set the FPU's flush-to-zero/denormals-are-zero
+//                         modes, as a comparison for the denormal inputs
+//   --check-math          instead of benchmarking, measure the error of the
+//                         fastmath approximations (scalar and block paths)
+//                         against libm and fail if a bound is exceeded
+//   --model-load <path>   instead of benchmarking the effectors, compare
+//                         loading the model weights (<path> is a .bin file
+//                         or a model directory) into a heap buffer against
+//                         memory-mapping them
+//
+// Every effector is measured at block sizes 32..4096 (powers of two), enabled
+// and bypassed, in place and out of place, and with two inputs: "signal"
+// (a tone plus noise at speech level) and "denormal" (subnormal floats only,
+// the worst case for IIR filters and envelope followers fed near-silence).
+// Each case reports ns/sample as the best and the median of several timed
+// batches, after one untimed warm-up batch. The fastmath_* and libm_* rows
+// time the dB conversions alone, as the dynamics processors use them.
+//
+// --model-load reports, per weight file and method, the best and median time
+// and the growth of the process's anonymous and file-backed RSS while the
+// weights are held. "read" reads the file into a heap buffer; "mmap" maps it
+// and touches every page. "extract_read" and "extract_mmap" copy the file
+// the way asset extraction does, through a whole-file heap buffer as before
+// and through BeatriceMappedFile::copyTo(). The files stay in the page cache
+// between runs, so the times are for a warm cache.
+
+#include <logging_macros.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <xmmintrin.h>
+#endif
+
+#include "HostPipeline.hpp"
+#include "beatriceMappedFile.h"
+#include "effectors/Amplifier.hpp"
+#include "effectors/BlockAdapter.hpp"
+#include "effectors/Compressor.hpp"
+#include "effectors/DynamicsEngine.hpp"
+#include "effectors/FastMath.hpp"
+#include "effectors/Limiter.hpp"
+#include "effectors/NoiseGate.hpp"
+#include "effectors/ParametricEqualizer.hpp"
+#include "effectors/RNNoiseProcessor.hpp"
+#include "effectors/ResamplingEffector.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr float kSampleRate = 48000.0f;
+constexpr int kMinBlockSize = 32;
+constexpr int kMaxBlockSize = 4096;
+// Samples per timed batch: large enough to swamp clock overhead at the
+// smallest block size, small enough to stay in L2.
+constexpr int kBatchSamples = 16384;
+constexpr int kNumRepetitions = 7;
+
+struct Arguments {
+  bool json = false;
+  std::string filter;
+  double minTime = 0.05;
+  bool flushDenormals = false;
+  bool checkMath = false;
+  std::string modelLoadPath;
+};
+
+struct Case {
+  std::string effector;
+  int blockSize = 0;
+  bool enabled = false;
+  bool inPlace = false;
+  std::string input;
+};
+
+struct Measurement {
+  double bestNsPerSample = 0.0;
+  double medianNsPerSample = 0.0;
+  long long samples = 0;
+};
+
+struct EffectorFactory {
+  std::string name;
+  std::function<std::shared_ptr<AudioEffector>()> create;
+};
+
+// Wraps a dB conversion kernel so that measure() can time it. The enabled
+// flag is ignored.
+class KernelEffector : public AudioEffector {
+ public:
+  using Kernel = std::function<void(const float*, float*, int)>;
+
+  explicit KernelEffector(Kernel kernel) : m_kernel(std::move(kernel)) {}
+
+  void process(const float* inputBuffer, float* outputBuffer,
+               int numSamples) override {
+    m_kernel(inputBuffer, outputBuffer, numSamples);
+  }
+  void setSampleRate(float) override {}
+  void setEnabled(bool enabled) override { m_enabled = enabled; }
+  bool isEnabled() const override { return m_enabled; }
+
+ private:
+  Kernel m_kernel;
+  bool m_enabled = true;
+};
+
+// linearToDb of the sample magnitudes, as the meters and gain computers see
+// them.
+void fastLinearToDbKernel(const float* input, float* output, int n) {
+  for (int i = 0; i < n; ++i) {
+    output[i] = std::abs(input[i]);
+  }
+  fastmath::linearToDbBlock(output, output, n);
+}
+
+void libmLinearToDbKernel(const float* input, float* output, int n) {
+  for (int i = 0; i < n; ++i) {
+    output[i] = 20.0f * std::log10(std::abs(input[i]));
+  }
+}
+
+void fastDbToLinearKernel(const float* input, float* output, int n) {
+  fastmath::dbToLinearBlock(input, output, n);
+}
+
+void libmDbToLinearKernel(const float* input, float* output, int n) {
+  for (int i = 0; i < n; ++i) {
+    output[i] = std::pow(10.0f, input[i] / 20.0f);
+  }
+}
+
+// Settings that keep each effector's gain computer busy at speech level.
+std::vector<EffectorFactory> makeFactories() {
+  return {
+      {"amplifier", [] { return std::make_shared<Amplifier>(6.0f); }},
+      {"noise_gate",
+       [] {
+         auto gate = std::make_shared<NoiseGate>();
+         gate->setThreshold(-30.0f);
+         return gate;
+       }},
+      {"compressor",
+       [] { return std::make_shared<Compressor>(-24.0f, 4.0f); }},
+      {"dynamics",
+       [] {
+         auto gate = std::make_shared<NoiseGate>();
+         gate->setThreshold(-30.0f);
+         return std::make_shared<DynamicsEngine>(
+             gate, std::make_shared<Compressor>(-24.0f, 4.0f));
+       }},
+      {"limiter",
+       [] {
+         auto limiter = std::make_shared<Limiter>();
+         limiter->setThreshold(-12.0f);
+         return limiter;
+       }},
+      {"limiter_look_ahead",
+       [] {
+         auto limiter = std::make_shared<Limiter>();
+         limiter->setThreshold(-12.0f);
+         limiter->setLookAhead(2.0f);
+         return limiter;
+       }},
+      {"parametric_equalizer",
+       [] {
+         auto equalizer =
+             std::make_shared<ParametricEqualizer>(kSampleRate, 5);
+         const float frequencies[] = {30.0f, 100.0f, 300.0f, 1000.0f,
+                                      10000.0f};
+         for (int i = 0; i < 5; ++i) {
+           equalizer->setBandAsPeaking(i, frequencies[i], 0.7f,
+                                       i % 2 ? 3.0f : -3.0f);
+         }
+         return equalizer;
+       }},
+      {"fastmath_linear_to_db",
+       [] { return std::make_shared<KernelEffector>(fastLinearToDbKernel); }},
+      {"libm_linear_to_db",
+       [] { return std::make_shared<KernelEffector>(libmLinearToDbKernel); }},
+      {"fastmath_db_to_linear",
+       [] { return std::make_shared<KernelEffector>(fastDbToLinearKernel); }},
+      {"libm_db_to_linear",
+       [] { return std::make_shared<KernelEffector>(libmDbToLinearKernel); }},
+      {"rnnoise",
+       [] {
+         auto rnnoise = std::make_shared<RNNoiseProcessor>();
+         return std::make_shared<BlockAdapter>(rnnoise,
+                                               rnnoise->getFrameSize());
+       }},
+      // Resampling cost alone: 48 kHz -> 44.1 kHz -> 48 kHz around a gain.
+      {"resampler_44k",
+       [] {
+         return std::make_shared<ResamplingEffector>(
+             std::make_shared<Amplifier>(0.0f), 44100.0f);
+       }},
+      {"chain",
+       []() -> std::shared_ptr<AudioEffector> {
+         HostPipeline pipeline;
+         HostPipeline::Options options;
+         options.sampleRate = kSampleRate;
+         options.enableEffects = true;
+         pipeline.create(options);
+         return pipeline.getChain();
+       }},
+  };
+}
+
+std::vector<float> makeInput(const std::string& kind, size_t length) {
+  std::vector<float> samples(length);
+  std::minstd_rand random(1);
+  std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+  if (kind == "denormal") {
+    // Uniform over the subnormal range, both signs.
+    for (auto& sample : samples) {
+      sample = noise(random) * 1.0e-39f;
+    }
+    return samples;
+  }
+  const double phaseStep = 2.0 * M_PI * 220.0 / kSampleRate;
+  for (size_t i = 0; i < length; ++i) {
+    samples[i] = 0.25f * static_cast<float>(std::sin(phaseStep * i)) +
+                 0.01f * noise(random);
+  }
+  return samples;
+}
+
+void setFlushDenormals() {
+#if defined(__x86_64__) || defined(__i386__)
+  // FTZ (bit 15) and DAZ (bit 6).
+  _mm_setcsr(_mm_getcsr() | 0x8040);
+#elif defined(__aarch64__)
+  uint64_t fpcr;
+  asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+  asm volatile("msr fpcr, %0" ::"r"(fpcr | (1ull << 24)));
+#else
+  LOGW("--flush-denormals is not supported on this architecture");
+#endif
+}
+
+Measurement measure(AudioEffector& effector, const Case& c,
+                    const std::vector<float>& source, double minTime) {
+  const int blocks = kBatchSamples / c.blockSize;
+  const size_t batchSamples = static_cast<size_t>(blocks) * c.blockSize;
+  std::vector<float> input(source.begin(), source.begin() + batchSamples);
+  std::vector<float> output(batchSamples);
+
+  // In-place batches overwrite their input, so it is restored between
+  // batches outside the timed region.
+  auto runBatch = [&]() {
+    if (c.inPlace) {
+      std::copy(input.begin(), input.end(), output.begin());
+    }
+    const auto start = Clock::now();
+    for (int b = 0; b < blocks; ++b) {
+      float* out = &output[static_cast<size_t>(b) * c.blockSize];
+      const float* in = c.inPlace ? out : &input[out - output.data()];
+      effector.process(in, out, c.blockSize);
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start)
+        .count();
+  };
+
+  runBatch();
+  const double repetitionTime = minTime / kNumRepetitions;
+  std::vector<double> nsPerSample;
+  Measurement result;
+  for (int r = 0; r < kNumRepetitions; ++r) {
+    double elapsed = 0.0;
+    long long samples = 0;
+    do {
+      elapsed += runBatch();
+      samples += static_cast<long long>(batchSamples);
+    } while (elapsed < repetitionTime * 1e9);
+    nsPerSample.push_back(elapsed / samples);
+    result.samples += samples;
+  }
+  std::sort(nsPerSample.begin(), nsPerSample.end());
+  result.bestNsPerSample = nsPerSample.front();
+  result.medianNsPerSample = nsPerSample[nsPerSample.size() / 2];
+  return result;
+}
+
+void printResult(const Arguments& args, const Case& c, const Measurement& m,
+                 bool first) {
+  if (args.json) {
+    std::printf(
+        "%s\n    {\"effector\": \"%s\", \"block_size\": %d, \"enabled\": %s, "
+        "\"in_place\": %s, \"input\": \"%s\", \"ns_per_sample\": %.4f, "
+        "\"ns_per_sample_median\": %.4f, \"samples\": %lld}",
+        first ? "" : ",", c.effector.c_str(), c.blockSize,
+        c.enabled ? "true" : "false", c.inPlace ? "true" : "false",
+        c.input.c_str(), m.bestNsPerSample, m.medianNsPerSample, m.samples);
+  } else {
+    std::printf("%s,%d,%d,%d,%s,%.4f,%.4f,%lld\n", c.effector.c_str(),
+                c.blockSize, c.enabled ? 1 : 0, c.inPlace ? 1 : 0,
+                c.input.c_str(), m.bestNsPerSample, m.medianNsPerSample,
+                m.samples);
+  }
+  std::fflush(stdout);
+}
+
+struct ErrorBound {
+  const char* name;
+  double maxError;
+  bool relative;
+  std::function<double(double)> reference;
+  std::function<float(float)> scalar;
+  std::function<void(const float*, float*, int)> block;
+  std::vector<float> inputs;
+};
+
+// Largest error of the scalar and block paths over the inputs.
+bool checkMathBound(const ErrorBound& bound) {
+  std::vector<float> blockOutput(bound.inputs.size());
+  bound.block(bound.inputs.data(), blockOutput.data(),
+              static_cast<int>(bound.inputs.size()));
+  double scalarError = 0.0;
+  double blockError = 0.0;
+  for (size_t i = 0; i < bound.inputs.size(); ++i) {
+    const double expected = bound.reference(bound.inputs[i]);
+    const double scale = bound.relative ? std::abs(expected) : 1.0;
+    const double scalarOutput = bound.scalar(bound.inputs[i]);
+    scalarError =
+        std::max(scalarError, std::abs(scalarOutput - expected) / scale);
+    blockError = std::max(blockError,
+                          std::abs(blockOutput[i] - expected) / scale);
+  }
+  const bool passed =
+      scalarError <= bound.maxError && blockError <= bound.maxError;
+  std::printf("%s,%s,%.3g,%.3g,%.3g,%s\n", bound.name,
+              bound.relative ? "relative" : "absolute", scalarError,
+              blockError, bound.maxError, passed ? "ok" : "FAILED");
+  return passed;
+}
+
+// The error bounds documented in FastMath.hpp.
+bool checkMath() {
+  std::vector<float> levels;  // 2^-126 .. 2^126, 4096 steps per octave
+  for (int step = -126 * 4096; step <= 126 * 4096; ++step) {
+    levels.push_back(static_cast<float>(std::exp2(step / 4096.0)));
+  }
+  std::vector<float> exponents;  // -126 .. 126
+  for (int step = -126 * 4096; step <= 126 * 4096; ++step) {
+    exponents.push_back(static_cast<float>(step / 4096.0));
+  }
+  std::vector<float> decibels;  // -120 dB .. +40 dB
+  std::vector<float> amplitudes;
+  for (int step = -120 * 1024; step <= 40 * 1024; ++step) {
+    decibels.push_back(static_cast<float>(step / 1024.0));
+    amplitudes.push_back(
+        static_cast<float>(std::pow(10.0, step / 1024.0 / 20.0)));
+  }
+  // Odd lengths, so the block functions' scalar tails are covered too.
+  const std::vector<ErrorBound> bounds = {
+      {"log2", 5e-6, false, [](double x) { return std::log2(x); },
+       fastmath::fastLog2, fastmath::log2Block, levels},
+      {"exp2", 4e-7, true, [](double x) { return std::exp2(x); },
+       fastmath::fastExp2, fastmath::exp2Block, exponents},
+      {"linear_to_db", 5e-5, false,
+       [](double x) { return 20.0 * std::log10(x); }, fastmath::fastLinearToDb,
+       fastmath::linearToDbBlock, amplitudes},
+      {"db_to_linear", 1e-6, true,
+       [](double x) { return std::pow(10.0, x / 20.0); },
+       fastmath::fastDbToLinear, fastmath::dbToLinearBlock, decibels},
+  };
+  std::printf("function,error,scalar,block,bound,result\n");
+  bool passed = true;
+  for (const auto& bound : bounds) {
+    passed = checkMathBound(bound) && passed;
+  }
+  return passed;
+}
+
+struct ResidentMemory {
+  long anonKb = 0;
+  long fileKb = 0;
+};
+
+ResidentMemory readResidentMemory() {
+  ResidentMemory memory;
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.starts_with("RssAnon:")) {
+      memory.anonKb = std::atol(line.c_str() + 8);
+    } else if (line.starts_with("RssFile:")) {
+      memory.fileKb = std::atol(line.c_str() + 8);
+    }
+  }
+  return memory;
+}
+
+// Keeps touchPages() from being optimized away.
+volatile uint64_t touchedSum = 0;
+
+// Reads one byte per page, as a consumer of the weights eventually does.
+void touchPages(const uint8_t* data, size_t size) {
+  uint64_t sum = 0;
+  for (size_t i = 0; i < size; i += 4096) {
+    sum += data[i];
+  }
+  touchedSum = touchedSum + sum;
+}
+
+struct LoadMeasurement {
+  double bestMs = 0.0;
+  double medianMs = 0.0;
+  ResidentMemory growth;
+};
+
+// Times load() several times. The RSS growth is measured while its result
+// is still held and is the largest over the runs, since later runs may reuse
+// heap pages that an earlier one left resident.
+template <typename Load>
+LoadMeasurement measureLoad(Load load) {
+  std::vector<double> times;
+  LoadMeasurement result;
+  for (int r = 0; r < kNumRepetitions; ++r) {
+    const ResidentMemory before = readResidentMemory();
+    const auto start = Clock::now();
+    auto held = load();
+    times.push_back(
+        std::chrono::duration<double, std::milli>(Clock::now() - start)
+            .count());
+    const ResidentMemory after = readResidentMemory();
+    result.growth.anonKb =
+        std::max(result.growth.anonKb, after.anonKb - before.anonKb);
+    result.growth.fileKb =
+        std::max(result.growth.fileKb, after.fileKb - before.fileKb);
+  }
+  std::sort(times.begin(), times.end());
+  result.bestMs = times.front();
+  result.medianMs = times[times.size() / 2];
+  return result;
+}
+
+std::vector<uint8_t> readWholeFile(const std::string& path) {
+  std::ifstream ifs(path, std::ios::binary);
+  std::vector<uint8_t> data(std::filesystem::file_size(path));
+  ifs.read(reinterpret_cast<char*>(data.data()),
+           static_cast<std::streamsize>(data.size()));
+  return data;
+}
+
+bool benchmarkModelLoad(const Arguments& args) {
+  std::vector<std::string> files;
+  std::error_code error;
+  if (std::filesystem::is_directory(args.modelLoadPath, error)) {
+    for (const auto& entry :
+         std::filesystem::directory_iterator(args.modelLoadPath, error)) {
+      if (entry.is_regular_file() && entry.path().extension() == ".bin") {
+        files.push_back(entry.path().string());
+      }
+    }
+    std::sort(files.begin(), files.end());
+  } else if (std::filesystem::is_regular_file(args.modelLoadPath, error)) {
+    files.push_back(args.modelLoadPath);
+  }
+  if (files.empty()) {
+    LOGE("No weight files found at %s", args.modelLoadPath.c_str());
+    return false;
+  }
+  const std::string extractPath =
+      (std::filesystem::temp_directory_path() / "beatrice_bench_extract.bin")
+          .string();
+
+  using Method = std::pair<const char*, std::function<LoadMeasurement(
+                                            const std::string&)>>;
+  const std::vector<Method> methods = {
+      {"read",
+       [](const std::string& file) {
+         return measureLoad([&] {
+           auto data = readWholeFile(file);
+           touchPages(data.data(), data.size());
+           return data;
+         });
+       }},
+      {"mmap",
+       [](const std::string& file) {
+         return measureLoad([&] {
+           auto mapping = std::make_unique<BeatriceMappedFile>();
+           if (mapping->open(file)) {
+             touchPages(mapping->data(), mapping->size());
+           }
+           return mapping;
+         });
+       }},
+      {"extract_read",
+       [&extractPath](const std::string& file) {
+         return measureLoad([&] {
+           const auto data = readWholeFile(file);
+           std::ofstream ofs(extractPath, std::ios::binary | std::ios::trunc);
+           ofs.write(reinterpret_cast<const char*>(data.data()),
+                     static_cast<std::streamsize>(data.size()));
+           return data;
+         });
+       }},
+      {"extract_mmap",
+       [&extractPath](const std::string& file) {
+         return measureLoad([&] {
+           auto mapping = std::make_unique<BeatriceMappedFile>();
+           if (mapping->open(file)) {
+             mapping->copyTo(extractPath);
+           }
+           return mapping;
+         });
+       }},
+  };
+
+  if (args.json) {
+    std::printf("{\"results\": [");
+  } else {
+    std::printf("file,method,bytes,ms,ms_median,rss_anon_kb,rss_file_kb\n");
+  }
+  bool first = true;
+  for (const auto& file : files) {
+    const auto bytes =
+        static_cast<long long>(std::filesystem::file_size(file));
+    const std::string name = std::filesystem::path(file).filename().string();
+    for (const auto& [method, run] : methods) {
+      const LoadMeasurement m = run(file);
+      if (args.json) {
+        std::printf(
+            "%s\n    {\"file\": \"%s\", \"method\": \"%s\", "
+            "\"bytes\": %lld, \"ms\": %.3f, \"ms_median\": %.3f, "
+            "\"rss_anon_kb\": %ld, \"rss_file_kb\": %ld}",
+            first ? "" : ",", name.c_str(), method, bytes, m.bestMs,
+            m.medianMs, m.growth.anonKb, m.growth.fileKb);
+      } else {
+        std::printf("%s,%s,%lld,%.3f,%.3f,%ld,%ld\n", name.c_str(), method,
+                    bytes, m.bestMs, m.medianMs, m.growth.anonKb,
+                    m.growth.fileKb);
+      }
+      std::fflush(stdout);
+      first = false;
+    }
+  }
+  if (args.json) {
+    std::printf("\n]}\n");
+  }
+  std::filesystem::remove(extractPath, error);
+  return true;
+}
+
+bool parseArguments(int argc, char** argv, Arguments& args) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--flush-denormals") {
+      args.flushDenormals = true;
+      continue;
+    }
+    if (arg == "--check-math") {
+      args.checkMath = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      return false;
+    }
+    const std::string value = argv[++i];
+    if (arg == "--format" && (value == "csv" || value == "json")) {
+      args.json = value == "json";
+    } else if (arg == "--filter") {
+      args.filter = value;
+    } else if (arg == "--min-time") {
+      args.minTime = std::atof(value.c_str());
+    } else if (arg == "--model-load") {
+      args.modelLoadPath = value;
+    } else {
+      return false;
+    }
+  }
+  return args.minTime > 0.0;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  Arguments args;
+  if (!parseArguments(argc, argv, args)) {
+    std::fprintf(stderr,
+                 "usage: beatrice_bench [--format csv|json] [--filter <text>]"
+                 "\n                      [--min-time <s>] "
+                 "[--flush-denormals] [--check-math]"
+                 "\n                      [--model-load <path>]\n");
+    return EXIT_FAILURE;
+  }
+  if (args.checkMath) {
+    return checkMath() ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  if (!args.modelLoadPath.empty()) {
+    return benchmarkModelLoad(args) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  if (args.flushDenormals) {
+    setFlushDenormals();
+  }
+
+  const std::vector<std::string> inputKinds = {"signal", "denormal"};
+  std::vector<std::vector<float>> inputs;
+  for (const auto& kind : inputKinds) {
+    inputs.push_back(makeInput(kind, kBatchSamples));
+  }
+
+  if (args.json) {
+    std::printf("{\"flush_denormals\": %s, \"results\": [",
+                args.flushDenormals ? "true" : "false");
+  } else {
+    std::printf(
+        "effector,block_size,enabled,in_place,input,ns_per_sample,"
+        "ns_per_sample_median,samples\n");
+  }
+
+  bool first = true;
+  for (const auto& factory : makeFactories()) {
+    if (factory.name.find(args.filter) == std::string::npos) {
+      continue;
+    }
+    for (int blockSize = kMinBlockSize; blockSize <= kMaxBlockSize;
+         blockSize *= 2) {
+      for (bool enabled : {true, false}) {
+        for (bool inPlace : {false, true}) {
+          for (size_t k = 0; k < inputKinds.size(); ++k) {
+            // A fresh instance per case, so filter and envelope state from
+            // one input does not leak into the next.
+            auto effector = factory.create();
+            effector->setSampleRate(kSampleRate);
+            effector->setEnabled(enabled);
+            const Case c{factory.name, blockSize, enabled, inPlace,
+                         inputKinds[k]};
+            printResult(args, c, measure(*effector, c, inputs[k], args.minTime),
+                        first);
+            first = false;
+          }
+        }
+      }
+    }
+  }
+
+  if (args.json) {
+    std::printf("\n]}\n");
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,59 @@
+#ifndef BEATRICE_HOST_ANDROID_LOG_H
+#define BEATRICE_HOST_ANDROID_LOG_H
+
+// Minimal stand-in for the NDK's <android/log.h> on Linux hosts. Messages go
+// to stderr; set BEATRICE_LOG_LEVEL (2 = verbose ... 7 = fatal, default 4 =
+// info) to filter them.
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+typedef enum android_LogPriority {
+  ANDROID_LOG_UNKNOWN = 0,
+  ANDROID_LOG_DEFAULT,
+  ANDROID_LOG_VERBOSE,
+  ANDROID_LOG_DEBUG,
+  ANDROID_LOG_INFO,
+  ANDROID_LOG_WARN,
+  ANDROID_LOG_ERROR,
+  ANDROID_LOG_FATAL,
+  ANDROID_LOG_SILENT,
+} android_LogPriority;
+
+inline int beatrice_host_log_level() {
+  static const int level = [] {
+    const char* value = std::getenv("BEATRICE_LOG_LEVEL");
+    return value ? std::atoi(value) : static_cast<int>(ANDROID_LOG_INFO);
+  }();
+  return level;
+}
+
+inline int __android_log_vprint(int prio, const char* tag, const char* fmt,
+                                va_list ap) {
+  if (prio < beatrice_host_log_level()) {
+    return 0;
+  }
+  static const char kLevels[] = "??VDIWEFS";
+  const char level = prio >= 0 && prio <= ANDROID_LOG_SILENT ? kLevels[prio]
+                                                             : '?';
+  int written = std::fprintf(stderr, "%c/%s: ", level, tag ? tag : "");
+  written += std::vfprintf(stderr, fmt, ap);
+  std::fputc('\n', stderr);
+  return written + 1;
+}
+
+inline int __android_log_print(int prio, const char* tag, const char* fmt,
+                               ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  const int written = __android_log_vprint(prio, tag, fmt, ap);
+  va_end(ap);
+  return written;
+}
+
+inline int __android_log_write(int prio, const char* tag, const char* text) {
+  return __android_log_print(prio, tag, "%s", text);
+}
+
+#endif  // BEATRICE_HOST_ANDROID_LOG_H
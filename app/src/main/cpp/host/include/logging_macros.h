@@ -0,0 +1,20 @@
+#ifndef BEATRICE_HOST_LOGGING_MACROS_H
+#define BEATRICE_HOST_LOGGING_MACROS_H
+
+// Host replacement for Oboe's samples/debug-utils/logging_macros.h, with the
+// same macro names, backed by the <android/log.h> shim.
+
+#include <android/log.h>
+
+#ifndef MODULE_NAME
+#define MODULE_NAME "beatrice"
+#endif
+
+#define LOGV(...) __android_log_print(ANDROID_LOG_VERBOSE, MODULE_NAME, __VA_ARGS__)
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, MODULE_NAME, __VA_ARGS__)
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, MODULE_NAME, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, MODULE_NAME, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, MODULE_NAME, __VA_ARGS__)
+#define LOGF(...) __android_log_print(ANDROID_LOG_FATAL, MODULE_NAME, __VA_ARGS__)
+
+#endif  // BEATRICE_HOST_LOGGING_MACROS_H
@@ -0,0 +1,188 @@
+// beatrice_host: runs the app's processing pipeline on a Linux host.
+//
+//   beatrice_host file <input.wav> <output.wav> [options]
+//   beatrice_host simulate [options]
+//
+// Options:
+//   --model <path.toml>   add the Beatrice stage (needs the Beatrice library)
+//   --effects             enable every effector with default settings
+//   --block <n>           processing block size (default 480)
+//   --buffers <n>         blocks between input and output (default 2)
+//   --burst <n>           frames per callback (default 192)
+//   --seconds <s>         simulate: duration (default 10)
+//   --device-bursts <n>   simulate: device buffer size in bursts (default 2)
+//   --async               simulate: process on a worker thread
+//   --free-run            simulate: do not pace callbacks by the wall clock
+//   --profile             print per-stage timing histograms
+
+#include <logging_macros.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "FileAudioBackend.hpp"
+#include "HostPipeline.hpp"
+#include "SimulatedAudioBackend.hpp"
+#include "WavFile.hpp"
+
+namespace {
+struct Arguments {
+  std::string mode;
+  std::vector<std::string> positional;
+  HostPipeline::Options pipeline;
+  size_t blockSize = 480;
+  size_t bufferCount = 2;
+  int32_t burst = 192;
+  double seconds = 10.0;
+  int32_t deviceBursts = 2;
+  bool async = false;
+  bool realTime = true;
+  bool profile = false;
+};
+
+void printUsage() {
+  std::fprintf(stderr,
+               "usage: beatrice_host file <input.wav> <output.wav> [options]\n"
+               "       beatrice_host simulate [options]\n"
+               "options: --model <toml> --effects --block <n> --buffers <n>\n"
+               "         --burst <n> --seconds <s> --device-bursts <n>\n"
+               "         --async --free-run --profile\n");
+}
+
+bool parseArguments(int argc, char** argv, Arguments& args) {
+  if (argc < 2) {
+    return false;
+  }
+  args.mode = argv[1];
+  for (int i = 2; i < argc; ++i) {
+    const std::string arg = argv[i];
+    auto nextValue = [&]() -> const char* {
+      return i + 1 < argc ? argv[++i] : nullptr;
+    };
+    const char* value = nullptr;
+    if (arg == "--effects") {
+      args.pipeline.enableEffects = true;
+    } else if (arg == "--async") {
+      args.async = true;
+    } else if (arg == "--free-run") {
+      args.realTime = false;
+    } else if (arg == "--profile") {
+      args.profile = true;
+    } else if (arg.rfind("--", 0) != 0) {
+      args.positional.push_back(arg);
+    } else if (!(value = nextValue())) {
+      LOGE("Missing value for %s", arg.c_str());
+      return false;
+    } else if (arg == "--model") {
+      args.pipeline.modelPath = value;
+    } else if (arg == "--block") {
+      args.blockSize = std::strtoul(value, nullptr, 10);
+    } else if (arg == "--buffers") {
+      args.bufferCount = std::strtoul(value, nullptr, 10);
+    } else if (arg == "--burst") {
+      args.burst = std::atoi(value);
+    } else if (arg == "--seconds") {
+      args.seconds = std::atof(value);
+    } else if (arg == "--device-bursts") {
+      args.deviceBursts = std::atoi(value);
+    } else {
+      LOGE("Unknown option %s", arg.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+int runFile(Arguments& args) {
+  if (args.positional.size() != 2) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+  WavData input;
+  if (!readWavFile(args.positional[0], input)) {
+    return EXIT_FAILURE;
+  }
+  args.pipeline.sampleRate = static_cast<float>(input.sampleRate);
+  HostPipeline pipeline;
+  if (!pipeline.create(args.pipeline)) {
+    return EXIT_FAILURE;
+  }
+  pipeline.getProfiler()->setEnabled(args.profile);
+
+  FileAudioBackend::Config config;
+  config.blockSize = args.blockSize;
+  config.bufferCount = args.bufferCount;
+  config.callbackSize = static_cast<size_t>(args.burst);
+  FileAudioBackend backend(pipeline.getChain(), config);
+
+  WavData output;
+  output.sampleRate = input.sampleRate;
+  output.numChannels = 1;
+  const auto result = backend.run(downmixToMono(input),
+                                  args.pipeline.sampleRate, output.samples);
+  if (!writeWavFile(args.positional[1], output)) {
+    return EXIT_FAILURE;
+  }
+
+  std::printf("samples %zu audio %.3f s processing %.3f s rtf %.4f\n",
+              result.numSamples, result.audioSeconds, result.processingSeconds,
+              result.realTimeFactor);
+  if (args.profile) {
+    std::printf("%s", pipeline.getProfiler()->formatReport().c_str());
+  }
+  return EXIT_SUCCESS;
+}
+
+int runSimulate(Arguments& args) {
+  HostPipeline pipeline;
+  if (!pipeline.create(args.pipeline)) {
+    return EXIT_FAILURE;
+  }
+  pipeline.getProfiler()->setEnabled(args.profile);
+
+  SimulatedAudioBackend::Config config;
+  config.sampleRate = static_cast<int32_t>(args.pipeline.sampleRate);
+  config.framesPerBurst = args.burst;
+  config.bufferBursts = args.deviceBursts;
+  config.seconds = args.seconds;
+  config.realTime = args.realTime;
+  config.useAsyncProcessing = args.async;
+  config.blockSize = args.blockSize;
+  config.bufferCount = args.bufferCount;
+  SimulatedAudioBackend backend(pipeline.getChain(), pipeline.getProfiler(),
+                                config);
+  const auto result = backend.run();
+
+  std::printf(
+      "callbacks %llu xruns %llu overruns %llu underruns %llu audio %.3f s "
+      "wall %.3f s\n",
+      static_cast<unsigned long long>(result.callbacks),
+      static_cast<unsigned long long>(result.xruns),
+      static_cast<unsigned long long>(result.overruns),
+      static_cast<unsigned long long>(result.underruns), result.audioSeconds,
+      result.wallSeconds);
+  if (args.profile) {
+    std::printf("%s", pipeline.getProfiler()->formatReport().c_str());
+  }
+  return EXIT_SUCCESS;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  Arguments args;
+  if (!parseArguments(argc, argv, args)) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+  if (args.mode == "file") {
+    return runFile(args);
+  }
+  if (args.mode == "simulate") {
+    return runSimulate(args);
+  }
+  printUsage();
+  return EXIT_FAILURE;
+}
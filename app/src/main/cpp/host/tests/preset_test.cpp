@@ -0,0 +1,115 @@
+// Decodes presets with invalid floats. Built with the library's Release
+// flags, whose -ffinite-math-only must not let a NaN or Inf through.
+
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "beatricePreset.h"
+
+namespace {
+int failures = 0;
+
+void expect(bool condition, const char* what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAILED: %s\n", what);
+    ++failures;
+  }
+}
+
+class Writer {
+ public:
+  void u32(uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+      mData.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+  }
+  void i32(int32_t value) { u32(static_cast<uint32_t>(value)); }
+  void f32(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    u32(bits);
+  }
+  size_t offset() const { return mData.size(); }
+  std::vector<uint8_t>& data() { return mData; }
+
+ private:
+  std::vector<uint8_t> mData;
+};
+
+// A valid preset; reports the offset of the compressor ratio and of the first
+// pre-EQ band's frequency.
+std::vector<uint8_t> makePreset(size_t& ratioOffset, size_t& frequencyOffset) {
+  Writer w;
+  w.u32(0x54535042);
+  w.u32(BeatricePreset::kVersion);
+  w.i32(0);                                    // voice ID
+  for (int i = 0; i < 4; ++i) w.f32(0.0f);     // gains, pitch, formant
+  w.i32(0);                                    // VQ neighbors
+  w.f32(1.0f);                                 // intonation intensity
+  w.f32(0.0f);                                 // pitch correction
+  w.i32(0);                                    // pitch correction mode
+  w.f32(60.0f);                                // source pitch min
+  w.f32(1000.0f);                              // source pitch max
+  w.u32(2);                                    // morphing weights
+  w.f32(0.5f);
+  w.f32(0.5f);
+  w.u32(0);                                    // flags
+  w.f32(0.0f);                                 // amplifier gain
+  for (int i = 0; i < 4; ++i) w.f32(1.0f);     // noise gate
+  w.f32(-20.0f);                               // compressor threshold
+  ratioOffset = w.offset();
+  w.f32(4.0f);                                 // compressor ratio
+  for (int i = 0; i < 3; ++i) w.f32(1.0f);     // attack, release, makeup
+  for (int i = 0; i < 4; ++i) w.f32(1.0f);     // limiter
+  w.u32(1);                                    // pre-EQ bands
+  w.i32(0);
+  frequencyOffset = w.offset();
+  w.f32(1000.0f);
+  w.f32(1.0f);
+  w.f32(3.0f);
+  w.u32(0);                                    // post-EQ bands
+  return std::move(w.data());
+}
+
+void overwrite(std::vector<uint8_t>& data, size_t offset, float value) {
+  std::memcpy(data.data() + offset, &value, sizeof(value));
+}
+
+bool decode(const std::vector<uint8_t>& data) {
+  BeatricePreset preset;
+  return BeatricePreset::decode(data.data(), data.size(), preset);
+}
+}  // namespace
+
+int main() {
+  size_t ratioOffset = 0;
+  size_t frequencyOffset = 0;
+  const std::vector<uint8_t> valid = makePreset(ratioOffset, frequencyOffset);
+
+  BeatricePreset preset;
+  expect(BeatricePreset::decode(valid.data(), valid.size(), preset),
+         "a valid preset decodes");
+  expect(preset.compressorRatio == 4.0f, "the compressor ratio round-trips");
+  expect(preset.preEqualizerBands.size() == 1 &&
+             preset.preEqualizerBands[0].frequency == 1000.0f,
+         "the EQ band round-trips");
+
+  for (const float bad : {std::numeric_limits<float>::quiet_NaN(),
+                          std::numeric_limits<float>::infinity(),
+                          -std::numeric_limits<float>::infinity()}) {
+    std::vector<uint8_t> data = valid;
+    overwrite(data, ratioOffset, bad);
+    expect(!decode(data), "a non-finite compressor ratio is rejected");
+    data = valid;
+    overwrite(data, frequencyOffset, bad);
+    expect(!decode(data), "a non-finite EQ frequency is rejected");
+  }
+
+  if (failures == 0) {
+    std::printf("preset_test: OK\n");
+  }
+  return failures == 0 ? 0 : 1;
+}
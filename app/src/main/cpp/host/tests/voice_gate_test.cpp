@@ -0,0 +1,128 @@
+// Feeds the voice gate a word onset that its detector hears too late, and
+// checks that the stage behind the gate still gets to process it.
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "effectors/NoiseGate.hpp"
+#include "effectors/VoiceActivityDetector.hpp"
+#include "effectors/VoiceGate.hpp"
+
+namespace {
+int failures = 0;
+
+void expect(bool condition, const char* what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAILED: %s\n", what);
+    ++failures;
+  }
+}
+
+constexpr float kSampleRate = 48000.0f;
+constexpr int kBlockSize = 480;
+constexpr float kLevel = 0.5f;
+
+// The noise gate as the detector's only source; its 5 ms attack keeps it
+// below the threshold for a step that starts at the end of a block.
+struct Fixture {
+  std::shared_ptr<NoiseGate> noiseGate =
+      std::make_shared<NoiseGate>(-20.0f, 5.0f, 50.0f, -80.0f, kSampleRate);
+  VoiceGate gate;
+
+  Fixture() {
+    noiseGate->setEnabled(true);
+    auto detector = std::make_shared<VoiceActivityDetector>(nullptr, noiseGate);
+    detector->setEnabled(true);
+    detector->setHangover(20.0f);
+    gate.setDetector(detector);
+    gate.setSampleRate(kSampleRate);
+  }
+
+  VoiceGate::Action feed(const std::vector<float>& block) {
+    std::vector<float> gated(block.size());
+    noiseGate->process(block.data(), gated.data(),
+                       static_cast<int>(block.size()));
+    return gate.update(block.data(), static_cast<int>(block.size()));
+  }
+};
+
+// A block of silence that turns into speech for its last voicedSamples.
+std::vector<float> onsetBlock(int voicedSamples) {
+  std::vector<float> block(kBlockSize, 0.0f);
+  std::fill(block.end() - voicedSamples, block.end(), kLevel);
+  return block;
+}
+
+void testLateOnsetIsReplayed() {
+  Fixture fixture;
+  const std::vector<float> silence(kBlockSize, 0.0f);
+  for (int i = 0; i < 10; ++i) {
+    fixture.feed(silence);
+  }
+  expect(fixture.gate.isSkipping(), "silence pauses the stage");
+
+  constexpr int kVoicedSamples = 16;
+  expect(fixture.feed(onsetBlock(kVoicedSamples)) == VoiceGate::Action::kSkip,
+         "the detector is late for the onset");
+
+  const std::vector<float> speech(kBlockSize, kLevel);
+  expect(fixture.feed(speech) == VoiceGate::Action::kRun,
+         "the first block the detector hears runs the stage");
+  const float* replay = fixture.gate.getReplay();
+  const int replaySize = fixture.gate.getReplaySize();
+  expect(replaySize > 0 && replaySize <= kBlockSize * 2,
+         "the replay is the look-behind");
+  expect(replaySize >= kVoicedSamples &&
+             std::all_of(replay + replaySize - kVoicedSamples,
+                         replay + replaySize,
+                         [](float sample) { return sample == kLevel; }) &&
+             std::count(replay, replay + replaySize, kLevel) ==
+                 kVoicedSamples,
+         "the replay ends with the onset the detector missed");
+
+  expect(fixture.feed(speech) == VoiceGate::Action::kRun &&
+             fixture.gate.getReplaySize() == 0,
+         "the onset is replayed once");
+}
+
+void testOnsetHeardInTimeIsNotReplayed() {
+  Fixture fixture;
+  const std::vector<float> silence(kBlockSize, 0.0f);
+  for (int i = 0; i < 10; ++i) {
+    fixture.feed(silence);
+  }
+  expect(fixture.feed(onsetBlock(kBlockSize / 2)) == VoiceGate::Action::kRun,
+         "an onset the detector hears runs the stage");
+  expect(fixture.gate.getReplaySize() > 0,
+         "the silence before it is still replayed");
+  expect(std::count(fixture.gate.getReplay(),
+                    fixture.gate.getReplay() + fixture.gate.getReplaySize(),
+                    kLevel) == 0,
+         "the replay holds no speech from the current block");
+}
+
+void testWithoutDetectorAlwaysRuns() {
+  VoiceGate gate;
+  gate.setSampleRate(kSampleRate);
+  const std::vector<float> silence(kBlockSize, 0.0f);
+  for (int i = 0; i < 10; ++i) {
+    expect(gate.update(silence.data(), kBlockSize) == VoiceGate::Action::kRun,
+           "without a detector every block runs the stage");
+  }
+  expect(!gate.isSkipping() && gate.getReplaySize() == 0,
+         "without a detector nothing is replayed");
+}
+}  // namespace
+
+int main() {
+  testLateOnsetIsReplayed();
+  testOnsetHeardInTimeIsNotReplayed();
+  testWithoutDetectorAlwaysRuns();
+
+  if (failures == 0) {
+    std::printf("voice_gate_test: OK\n");
+  }
+  return failures == 0 ? 0 : 1;
+}
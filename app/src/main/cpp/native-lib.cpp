@@ -4,48 +4,84 @@
 #include <jni.h>
 #include <logging_macros.h>
 
+#include <algorithm>
 #include <array>
 #include <codecvt>
 #include <exception>
-#include <filesystem>
-#include <fstream>
-#include <iostream>
 #include <locale>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "beatriceAssetExtractor.h"
 #include "beatriceAudioEngine.h"
+#include "beatriceModelIndex.h"
+#include "beatricePreset.h"
 #include "beatriceProcessor.h"
 #include "effectors/Amplifier.hpp"
 #include "effectors/AudioEffectorChain.hpp"
+#include "effectors/BlockAdapter.hpp"
 #include "effectors/Compressor.hpp"
+#include "effectors/DynamicsEngine.hpp"
+#include "effectors/HotSwapEffector.hpp"
 #include "effectors/Limiter.hpp"
+#include "effectors/MeterSnapshot.hpp"
 #include "effectors/NoiseGate.hpp"
+#include "effectors/ParameterTransport.hpp"
 #include "effectors/ParametricEqualizer.hpp"
+#include "effectors/ProcessingProfiler.hpp"
 #include "effectors/RNNoiseProcessor.hpp"
+#include "effectors/ResamplingEffector.hpp"
+#include "effectors/VoiceActivityDetector.hpp"
 
 static const int kOboeApiAAudio = 0;
 static const int kOboeApiOpenSLES = 1;
+static const size_t kProfilerStatsStride = 7;
+// Longest the old model is waited for after readModel() starts a crossfade.
+static const int kModelSwapTimeoutMs = 200;
+static const int kAssetExtractionThreads = 4;
+static const char* const kModelIndexFileName = "model_index.bin";
 
 static std::unique_ptr<BeatriceAudioEngine> audioEngine = nullptr;
 static std::shared_ptr<AudioEffectorChain> effectorChain = nullptr;
 static std::shared_ptr<BeatriceProcessor> processor = nullptr;
+// The chain's "beatrice" stage; lets readModel() replace the processor while
+// the streams keep running.
+static std::shared_ptr<HotSwapEffector> processorSlot = nullptr;
 static std::shared_ptr<Amplifier> amplifier = nullptr;
 static std::shared_ptr<Compressor> compressor = nullptr;
 static std::shared_ptr<Limiter> limiter = nullptr;
 static std::shared_ptr<NoiseGate> noiseGate = nullptr;
+static std::shared_ptr<DynamicsEngine> dynamics = nullptr;
 static std::shared_ptr<ParametricEqualizer> preEqualizer = nullptr;
 static std::shared_ptr<ParametricEqualizer> postEqualizer = nullptr;
 static std::shared_ptr<RNNoiseProcessor> rnnoise = nullptr;
+static std::shared_ptr<ResamplingEffector> rnnoiseStage = nullptr;
+static std::shared_ptr<VoiceActivityDetector> voiceActivityDetector = nullptr;
+static std::shared_ptr<ProcessingProfiler> profiler = nullptr;
+static std::unique_ptr<BeatriceModelIndex> modelIndex = nullptr;
+// Static, so the direct ByteBuffer handed to Java can never dangle.
+static MeterSnapshot::Block meterBlock;
+static std::shared_ptr<MeterSnapshot> meterSnapshot = nullptr;
+
+// A model loaded by preloadModel(), waiting for readModel() to commit it.
+static std::mutex preloadMutex;
+static std::shared_ptr<BeatriceProcessor> preloadedProcessor = nullptr;
+static std::string preloadedPath;
+// Rate its core was loaded for; 0 if the streams were stopped.
+static int32_t preloadedSampleRate = 0;
 
 namespace {
 bool isInitialized() {
   return processor != nullptr && audioEngine != nullptr &&
          effectorChain != nullptr && amplifier != nullptr &&
          compressor != nullptr && limiter != nullptr && noiseGate != nullptr &&
-         preEqualizer != nullptr && postEqualizer != nullptr &&
-         rnnoise != nullptr;
+         dynamics != nullptr && preEqualizer != nullptr &&
+         postEqualizer != nullptr && rnnoise != nullptr &&
+         rnnoiseStage != nullptr && voiceActivityDetector != nullptr &&
+         processorSlot != nullptr && meterSnapshot != nullptr;
 }
 
 template <typename T>
@@ -78,103 +114,168 @@ jboolean getEffectorBoolean(const std::shared_ptr<T>& effector,
   return getter(*effector) ? JNI_TRUE : JNI_FALSE;
 }
 
-std::vector<float> toFloatVector(JNIEnv* env, jdoubleArray inputArray) {
-  std::vector<float> result;
-  if (!inputArray) {
-    return result;
+std::vector<ParametricEqualizer::BandSettings> toBandSettings(
+    const std::vector<BeatricePreset::EqualizerBand>& bands) {
+  std::vector<ParametricEqualizer::BandSettings> result;
+  result.reserve(bands.size());
+  for (const auto& band : bands) {
+    result.push_back({static_cast<FilterType>(band.type), band.frequency,
+                      band.q, band.gainDb});
   }
-
-  const jsize length = env->GetArrayLength(inputArray);
-  result.resize(static_cast<size_t>(length));
-
-  std::vector<jdouble> temp(static_cast<size_t>(length));
-  env->GetDoubleArrayRegion(inputArray, 0, length, temp.data());
-
-  for (jsize i = 0; i < length; ++i) {
-    result[static_cast<size_t>(i)] = static_cast<float>(temp[i]);
-  }
-
   return result;
 }
 
-jdoubleArray toDoubleArray(JNIEnv* env, const std::vector<float>& values) {
-  const jsize length = static_cast<jsize>(values.size());
-  jdoubleArray outputArray = env->NewDoubleArray(length);
-  if (!outputArray) {
-    return nullptr;
+std::string toStdString(JNIEnv* env, jstring value) {
+  if (!value) {
+    return {};
   }
-
-  std::vector<jdouble> temp(values.size());
-  for (size_t i = 0; i < values.size(); ++i) {
-    temp[i] = static_cast<jdouble>(values[i]);
-  }
-
-  if (length > 0) {
-    env->SetDoubleArrayRegion(outputArray, 0, length, temp.data());
-  }
-
-  return outputArray;
+  const char* chars = env->GetStringUTFChars(value, nullptr);
+  std::string result = chars ? chars : "";
+  env->ReleaseStringUTFChars(value, chars);
+  return result;
 }
 
 jdoubleArray makeEmptyDoubleArray(JNIEnv* env) {
   return env->NewDoubleArray(0);
 }
 
-std::array<float, beatrice::common::kMaxNSpeakers> toSpeakerMorphingWeights(
-    JNIEnv* env, jfloatArray inputArray) {
-  std::array<float, beatrice::common::kMaxNSpeakers> result{};
-  if (!inputArray) {
-    return result;
+// Pins a primitive Java array for its lifetime, usually without a copy. The
+// VM may hold off garbage collection meanwhile, so the scope must be short
+// and must neither call JNI nor block. Read-only: nothing is written back.
+template <typename T>
+class PinnedArray {
+ public:
+  PinnedArray(JNIEnv* env, jarray array) : mEnv(env), mArray(array) {
+    if (array) {
+      mSize = static_cast<size_t>(env->GetArrayLength(array));
+      mData = static_cast<const T*>(
+          env->GetPrimitiveArrayCritical(array, nullptr));
+    }
   }
-
-  const jsize length = env->GetArrayLength(inputArray);
-  std::vector<jfloat> temp(static_cast<size_t>(length));
-  env->GetFloatArrayRegion(inputArray, 0, length, temp.data());
-
-  const jsize count =
-      length < static_cast<jsize>(beatrice::common::kMaxNSpeakers)
-          ? length
-          : static_cast<jsize>(beatrice::common::kMaxNSpeakers);
-  for (jsize i = 0; i < count; ++i) {
-    result[static_cast<size_t>(i)] = temp[i];
+  ~PinnedArray() {
+    if (mData) {
+      mEnv->ReleasePrimitiveArrayCritical(mArray, const_cast<T*>(mData),
+                                          JNI_ABORT);
+    }
   }
+  PinnedArray(const PinnedArray&) = delete;
+  PinnedArray& operator=(const PinnedArray&) = delete;
+
+  const T* data() const { return mData; }
+  size_t size() const { return mData ? mSize : 0; }
+
+ private:
+  JNIEnv* mEnv;
+  jarray mArray;
+  const T* mData = nullptr;
+  size_t mSize = 0;
+};
+
+// The floats of a direct FloatBuffer, which Java must have created in native
+// byte order; nullptr if the buffer is not direct. capacity is in floats.
+float* getDirectFloats(JNIEnv* env, jobject buffer, jlong& capacity) {
+  capacity = buffer ? env->GetDirectBufferCapacity(buffer) : -1;
+  if (capacity < 0) {
+    LOGE("Expected a direct FloatBuffer");
+    return nullptr;
+  }
+  return static_cast<float*>(env->GetDirectBufferAddress(buffer));
+}
 
-  return result;
+// Fills response, in dB, for the frequencies in Hz. Both are direct
+// FloatBuffers of the same capacity that the app allocates once; the
+// equalizer evaluates straight into response with its own scratch storage.
+jboolean computeEqualizerResponse(ParametricEqualizer& equalizer, JNIEnv* env,
+                                  jobject frequencies, jobject response) {
+  jlong frequencyCount = 0;
+  jlong responseCount = 0;
+  const float* frequencyData =
+      getDirectFloats(env, frequencies, frequencyCount);
+  float* responseData = getDirectFloats(env, response, responseCount);
+  if (!frequencyData || !responseData) {
+    return JNI_FALSE;
+  }
+  if (frequencyCount != responseCount) {
+    LOGE("Frequency and response buffers differ in size: %lld, %lld",
+         static_cast<long long>(frequencyCount),
+         static_cast<long long>(responseCount));
+    return JNI_FALSE;
+  }
+  equalizer.computeFrequencyResponse(frequencyData, responseData,
+                                     static_cast<int>(frequencyCount));
+  return JNI_TRUE;
 }
 
 void resetEffectorChain() {
   if (effectorChain) {
     effectorChain->clearEffectors();
 
-    effectorChain->addEffector(amplifier);
-    effectorChain->addEffector(rnnoise);
-    effectorChain->addEffector(noiseGate);
-    effectorChain->addEffector(compressor);
-    effectorChain->addEffector(preEqualizer);
-    effectorChain->addEffector(processor);
-    effectorChain->addEffector(postEqualizer);
-    effectorChain->addEffector(limiter);
+    effectorChain->addEffector(amplifier, "amplifier");
+    // RNNoise runs on whole frames at 48 kHz whatever the stream.
+    effectorChain->addEffector(rnnoiseStage, "rnnoise");
+    // Noise gate and compressor, fused into one pass.
+    effectorChain->addEffector(dynamics, "dynamics");
+    effectorChain->addEffector(preEqualizer, "pre_equalizer");
+    // Holds the processor; see readModel().
+    effectorChain->addEffector(processorSlot, "beatrice");
+    effectorChain->addEffector(postEqualizer, "post_equalizer");
+    effectorChain->addEffector(limiter, "limiter");
+    // Last, so that every meter it copies describes the same block.
+    effectorChain->addEffector(meterSnapshot, "meters");
+    effectorChain->keepLast("meters");
+  }
+}
+
+// Lets the chain see a stage's new latency; call after anything that changes
+// it. Enabling or disabling a stage needs no call.
+void rebuildEffectorPlan() {
+  if (effectorChain) {
+    effectorChain->rebuildPlan();
   }
 }
 
-void copy_from_asset(AAssetManager* assetManager, std::string filename_in_asst,
-                     std::string filename) {
-  AAsset* asset = AAssetManager_open(assetManager, filename_in_asst.c_str(),
-                                     AASSET_MODE_UNKNOWN);
-  if (!asset) {
-    return;
+// Reads the model and, for a positive rate, loads the core's weights, which
+// takes the longest. Throws on failure. Any thread; touches no shared state.
+std::shared_ptr<BeatriceProcessor> loadProcessor(const std::string& modelPath,
+                                                 int32_t sampleRate) {
+  auto next = std::make_shared<BeatriceProcessor>(modelPath);
+  if (sampleRate > 0) {
+    next->createProcessorCore(sampleRate);
+  }
+  return next;
+}
+
+// The model last switched to, if it is still indexed; otherwise the newest,
+// as a leftover of an import cut short is older than what replaced it.
+const BeatriceModelIndex::Model* selectStartupModel(
+    const std::vector<BeatriceModelIndex::Model>& models,
+    const std::string& selectedPath) {
+  const auto selected = std::find_if(
+      models.begin(), models.end(), [&selectedPath](const auto& model) {
+        return model.path == selectedPath;
+      });
+  if (selected != models.end()) {
+    return &*selected;
   }
-  off_t length = AAsset_getLength(asset);
-  char* buffer = new char[length];
-  AAsset_read(asset, buffer, length);
-  AAsset_close(asset);
+  const auto newest = std::max_element(
+      models.begin(), models.end(),
+      [](const auto& a, const auto& b) { return a.mtime < b.mtime; });
+  return newest != models.end() ? &*newest : nullptr;
+}
 
-  auto ofs = std::ofstream(filename, std::ios::binary | std::ios::trunc);
-  if (ofs) {
-    ofs.write(buffer, length);
+const BeatriceModelIndex::Model* findIndexedModel(jint modelIndex_) {
+  if (!modelIndex) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return nullptr;
   }
-  ofs.close();
-  delete[] buffer;
+  const auto& models = modelIndex->getModels();
+  if (modelIndex_ < 0 || modelIndex_ >= static_cast<jint>(models.size())) {
+    LOGW("Invalid model index: %d", modelIndex_);
+    return nullptr;
+  }
+  return &models[static_cast<size_t>(modelIndex_)];
 }
 
 }  // namespace
@@ -182,57 +283,70 @@ void copy_from_asset(AAssetManager* assetManager, std::string filename_in_asst,
 extern "C" {
 
 JNIEXPORT jboolean JNICALL Java_com_gokrack_beatriceapp_beatriceEngine_create(
-    JNIEnv* env, jclass, jobject asset_manager_, jobject dir_name_) {
+    JNIEnv* env, jclass, jobject asset_manager_, jobject dir_name_,
+    jobject cache_dir_, jstring selected_model_path_) {
   auto c_dir_name =
       env->GetStringUTFChars(static_cast<jstring>(dir_name_), JNI_FALSE);
   auto dir_name = std::string(c_dir_name);
-  std::vector<std::string> tomlFiles;
-  try {
-    for (const auto& entry :
-         std::filesystem::recursive_directory_iterator(dir_name)) {
-      if (entry.is_regular_file() && entry.path().extension() == ".toml") {
-        tomlFiles.push_back(entry.path().string());
-      }
-    }
-  } catch (const std::exception& e) {
-    std::cerr << "Error during directory traversal: " << e.what() << std::endl;
-  }
+  auto c_cache_dir =
+      env->GetStringUTFChars(static_cast<jstring>(cache_dir_), JNI_FALSE);
+  auto cache_dir = std::string(c_cache_dir);
+  env->ReleaseStringUTFChars(static_cast<jstring>(cache_dir_), c_cache_dir);
+
+  // Kept outside dir_name, so that saving it leaves the directory as it was.
+  modelIndex = std::make_unique<BeatriceModelIndex>(
+      dir_name, cache_dir + "/" + kModelIndexFileName);
+  modelIndex->refresh();
 
   std::string toml_path;
-  if (!tomlFiles.empty()) {
-    toml_path = tomlFiles.at(0);
+  if (const auto* model = selectStartupModel(
+          modelIndex->getModels(), toStdString(env, selected_model_path_))) {
+    toml_path = model->path;
   } else {
     AAssetManager* assetManager = AAssetManager_fromJava(env, asset_manager_);
     auto model_name = std::string("beatrice_paraphernalia_jvs");
-    copy_from_asset(assetManager,
-                    model_name + "/beatrice_paraphernalia_jvs.toml",
-                    dir_name + std::string("/beatrice_paraphernalia_jvs.toml"));
-    copy_from_asset(assetManager, model_name + "/phone_extractor.bin",
-                    dir_name + std::string("/phone_extractor.bin"));
-    copy_from_asset(assetManager, model_name + "/pitch_estimator.bin",
-                    dir_name + std::string("/pitch_estimator.bin"));
-    copy_from_asset(assetManager, model_name + "/embedding_setter.bin",
-                    dir_name + std::string("/embedding_setter.bin"));
-    copy_from_asset(assetManager, model_name + "/waveform_generator.bin",
-                    dir_name + std::string("/waveform_generator.bin"));
-    copy_from_asset(assetManager, model_name + "/speaker_embeddings.bin",
-                    dir_name + std::string("/speaker_embeddings.bin"));
-    copy_from_asset(assetManager, model_name + "/noimage.png",
-                    dir_name + std::string("/noimage.png"));
+    BeatriceAssetExtractor extractor(assetManager, dir_name);
+    for (const char* file_name :
+         {"phone_extractor.bin", "pitch_estimator.bin", "embedding_setter.bin",
+          "waveform_generator.bin", "speaker_embeddings.bin", "noimage.png"}) {
+      extractor.add(model_name + "/" + file_name, file_name);
+    }
+    // The TOML goes last: the search above takes its presence to mean that
+    // the model is complete.
+    if (extractor.run(kAssetExtractionThreads).failed == 0) {
+      extractor.add(model_name + "/beatrice_paraphernalia_jvs.toml",
+                    "beatrice_paraphernalia_jvs.toml");
+      extractor.run(1);
+    }
     toml_path = dir_name + std::string("/beatrice_paraphernalia_jvs.toml");
   }
 
   try {
     processor = std::make_shared<BeatriceProcessor>(toml_path);
+    modelIndex->update(toml_path, *processor);
     audioEngine = std::make_unique<BeatriceAudioEngine>();
     effectorChain = std::make_shared<AudioEffectorChain>();
     amplifier = std::make_shared<Amplifier>(0.0f);
     compressor = std::make_shared<Compressor>();
     limiter = std::make_shared<Limiter>();
     noiseGate = std::make_shared<NoiseGate>();
+    dynamics = std::make_shared<DynamicsEngine>(noiseGate, compressor);
     preEqualizer = std::make_shared<ParametricEqualizer>(48000.0f, 3);
     postEqualizer = std::make_shared<ParametricEqualizer>(48000.0f, 5);
     rnnoise = std::make_shared<RNNoiseProcessor>();
+    rnnoiseStage = std::make_shared<ResamplingEffector>(
+        std::make_shared<BlockAdapter>(rnnoise, rnnoise->getFrameSize()),
+        RNNoiseProcessor::kSampleRate);
+    voiceActivityDetector =
+        std::make_shared<VoiceActivityDetector>(rnnoise, noiseGate);
+    // Pauses the core during silence, judged by RNNoise and the gate.
+    processor->setVoiceActivityDetector(voiceActivityDetector);
+    processorSlot = std::make_shared<HotSwapEffector>(processor);
+    meterSnapshot = std::make_shared<MeterSnapshot>(
+        &meterBlock, noiseGate, compressor, limiter, rnnoise);
+    profiler = std::make_shared<ProcessingProfiler>();
+    effectorChain->setProfiler(profiler);
+    audioEngine->setProfiler(profiler);
   } catch (const std::exception& e) {
     LOGE("Failed to create engine: %s", e.what());
     processor.reset();
@@ -242,9 +356,15 @@ JNIEXPORT jboolean JNICALL Java_com_gokrack_beatriceapp_beatriceEngine_create(
     compressor.reset();
     limiter.reset();
     noiseGate.reset();
+    dynamics.reset();
     preEqualizer.reset();
     postEqualizer.reset();
     rnnoise.reset();
+    rnnoiseStage.reset();
+    voiceActivityDetector.reset();
+    processorSlot.reset();
+    meterSnapshot.reset();
+    profiler.reset();
   }
 
   resetEffectorChain();
@@ -265,35 +385,108 @@ Java_com_gokrack_beatriceapp_beatriceEngine_delete(JNIEnv* env, jclass) {
   processor->resetProcessorCore();
   audioEngine.reset();
   processor.reset();
+  processorSlot.reset();
   effectorChain.reset();
+  std::lock_guard<std::mutex> lock(preloadMutex);
+  preloadedProcessor.reset();
 }
 
 JNIEXPORT jboolean JNICALL
-Java_com_gokrack_beatriceapp_beatriceEngine_readModel(JNIEnv* env, jclass,
-                                                      jobject model_path_) {
+Java_com_gokrack_beatriceapp_beatriceEngine_preloadModel(JNIEnv* env, jclass,
+                                                         jobject model_path_) {
+  if (!isInitialized()) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return JNI_FALSE;
+  }
   auto c_model_path =
       env->GetStringUTFChars(static_cast<jstring>(model_path_), JNI_FALSE);
   auto model_path = std::string(c_model_path);
+  env->ReleaseStringUTFChars(static_cast<jstring>(model_path_), c_model_path);
 
-  auto params = processor ? processor->getParameters() : BeatriceParameters{};
-  if (audioEngine) {
-    audioEngine->closeStreams();
-  }
+  // Runs on a worker thread: parse and load the weights for the running
+  // rate here, so that readModel() only has to swap.
+  const int32_t sampleRate =
+      audioEngine->isEffectOn() ? audioEngine->getSampleRate() : 0;
+  std::shared_ptr<BeatriceProcessor> next;
   try {
-    auto nextProcessor = std::make_unique<BeatriceProcessor>(model_path);
-    nextProcessor->setParameters(params);
-    processor = std::move(nextProcessor);
-
-    resetEffectorChain();
-
+    next = loadProcessor(model_path, sampleRate);
   } catch (const std::exception& e) {
-    LOGE("Failed to read model: %s", e.what());
-    env->ReleaseStringUTFChars(static_cast<jstring>(model_path_), c_model_path);
+    LOGE("Failed to preload model: %s", e.what());
     return JNI_FALSE;
   }
 
+  std::lock_guard<std::mutex> lock(preloadMutex);
+  preloadedProcessor = std::move(next);
+  preloadedPath = model_path;
+  preloadedSampleRate = sampleRate;
+  return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_readModel(JNIEnv* env, jclass,
+                                                      jobject model_path_) {
+  if (!isInitialized()) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return JNI_FALSE;
+  }
+  auto c_model_path =
+      env->GetStringUTFChars(static_cast<jstring>(model_path_), JNI_FALSE);
+  auto model_path = std::string(c_model_path);
   env->ReleaseStringUTFChars(static_cast<jstring>(model_path_), c_model_path);
-  return isInitialized() ? JNI_TRUE : JNI_FALSE;
+
+  // Called on the main thread, so it neither loads nor waits: the model
+  // must have been preloaded for the rate that is running now.
+  const bool isRunning = audioEngine->isEffectOn();
+  const int32_t sampleRate = isRunning ? audioEngine->getSampleRate() : 0;
+  std::shared_ptr<BeatriceProcessor> next;
+  {
+    std::lock_guard<std::mutex> lock(preloadMutex);
+    if (preloadedProcessor && preloadedPath == model_path &&
+        (!isRunning || preloadedSampleRate == sampleRate)) {
+      next = std::move(preloadedProcessor);
+    }
+    preloadedProcessor.reset();
+  }
+  if (!next) {
+    // E.g. the streams were restarted after the preload.
+    LOGW("Model %s is not preloaded for %d Hz", model_path.c_str(),
+         sampleRate);
+    return JNI_FALSE;
+  }
+
+  next->setParameters(processor->getParameters());
+  next->setEnabled(processor->isEnabled());
+  // Both processors update the detector during the crossfade, which at most
+  // shortens one hangover by the fade time.
+  next->setVoiceActivityDetector(voiceActivityDetector);
+  if (isRunning) {
+    // Crossfades at the next block boundary. The old model is released once
+    // the fade has ended, off this thread; on a timeout, at the next swap.
+    processorSlot->swap(next);
+    std::thread([slot = processorSlot] {
+      slot->waitForSwap(kModelSwapTimeoutMs);
+    }).detach();
+  } else {
+    processorSlot->setEffector(next);
+  }
+  processor = std::move(next);
+  modelIndex->update(model_path, *processor);
+  return JNI_TRUE;
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getModelPath(JNIEnv* env, jclass) {
+  if (!processor) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return env->NewStringUTF("");
+  }
+  return env->NewStringUTF(processor->getModelPath().c_str());
 }
 
 JNIEXPORT jstring JNICALL
@@ -335,6 +528,77 @@ Java_com_gokrack_beatriceapp_beatriceEngine_getModelVersion(JNIEnv* env,
   return processor->getModelVersion();
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_refreshModelIndex(JNIEnv* env,
+                                                              jclass) {
+  if (!modelIndex) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return JNI_FALSE;
+  }
+  return modelIndex->refresh() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getIndexedModelCount(JNIEnv* env,
+                                                                 jclass) {
+  if (!modelIndex) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return 0;
+  }
+  return static_cast<jint>(modelIndex->getModels().size());
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getIndexedModelPath(
+    JNIEnv* env, jclass, jint modelIndex_) {
+  const auto* model = findIndexedModel(modelIndex_);
+  return env->NewStringUTF(model ? model->path.c_str() : "");
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getIndexedModelName(
+    JNIEnv* env, jclass, jint modelIndex_) {
+  const auto* model = findIndexedModel(modelIndex_);
+  return env->NewStringUTF(
+      model ? reinterpret_cast<const char*>(model->name.c_str()) : "");
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getIndexedModelDescription(
+    JNIEnv* env, jclass, jint modelIndex_) {
+  const auto* model = findIndexedModel(modelIndex_);
+  return env->NewStringUTF(
+      model ? reinterpret_cast<const char*>(model->description.c_str()) : "");
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getIndexedVoiceName(
+    JNIEnv* env, jclass, jint modelIndex_, jint voiceID) {
+  const auto* model = findIndexedModel(modelIndex_);
+  if (!model || voiceID < 0 ||
+      voiceID >= static_cast<jint>(model->voices.size())) {
+    return env->NewStringUTF("");
+  }
+  return env->NewStringUTF(reinterpret_cast<const char*>(
+      model->voices[static_cast<size_t>(voiceID)].name.c_str()));
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getIndexedVoiceDescription(
+    JNIEnv* env, jclass, jint modelIndex_, jint voiceID) {
+  const auto* model = findIndexedModel(modelIndex_);
+  if (!model || voiceID < 0 ||
+      voiceID >= static_cast<jint>(model->voices.size())) {
+    return env->NewStringUTF("");
+  }
+  return env->NewStringUTF(reinterpret_cast<const char*>(
+      model->voices[static_cast<size_t>(voiceID)].description.c_str()));
+}
+
 JNIEXPORT jboolean JNICALL
 Java_com_gokrack_beatriceapp_beatriceEngine_setEffectOn(JNIEnv* env, jclass,
                                                         jboolean isEffectOn) {
@@ -596,6 +860,34 @@ Java_com_gokrack_beatriceapp_beatriceEngine_setAsyncMode(JNIEnv* env,
   return JNI_TRUE;
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_setBlockSize(JNIEnv* env,
+                                                         jclass type,
+                                                         jint blockSize) {
+  if (!audioEngine) {
+    LOGE(
+        "Engine is null, you must call createEngine "
+        "before calling this method");
+    return JNI_FALSE;
+  }
+  audioEngine->setBlockSize(blockSize);
+  return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_setBufferCount(JNIEnv* env,
+                                                           jclass type,
+                                                           jint bufferCount) {
+  if (!audioEngine) {
+    LOGE(
+        "Engine is null, you must call createEngine "
+        "before calling this method");
+    return JNI_FALSE;
+  }
+  audioEngine->setBufferCount(bufferCount);
+  return JNI_TRUE;
+}
+
 JNIEXPORT jboolean JNICALL
 Java_com_gokrack_beatriceapp_beatriceEngine_setVoiceCommunicationMode(
     JNIEnv* env, jclass type, jboolean isVoiceCommunicationMode) {
@@ -688,10 +980,94 @@ Java_com_gokrack_beatriceapp_beatriceEngine_setSpeakerMorphingWeights(
         "method");
     return JNI_FALSE;
   }
-  return processor->setSpeakerMorphingWeights(
-             toSpeakerMorphingWeights(env, weights))
-             ? JNI_TRUE
-             : JNI_FALSE;
+  std::array<float, beatrice::common::kMaxNSpeakers> speakerWeights{};
+  {
+    const PinnedArray<jfloat> pinned(env, weights);
+    std::copy_n(pinned.data(), std::min(pinned.size(), speakerWeights.size()),
+                speakerWeights.begin());
+  }
+  return processor->setSpeakerMorphingWeights(speakerWeights) ? JNI_TRUE
+                                                               : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_applyPreset(JNIEnv* env,
+                                                        jclass type,
+                                                        jbyteArray data) {
+  if (!isInitialized()) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return JNI_FALSE;
+  }
+  if (!data) {
+    return JNI_FALSE;
+  }
+  BeatricePreset preset;
+  {
+    // Decoding is pure, so it can read the pinned array in place.
+    const PinnedArray<jbyte> bytes(env, data);
+    if (!BeatricePreset::decode(reinterpret_cast<const uint8_t*>(bytes.data()),
+                                bytes.size(), preset)) {
+      return JNI_FALSE;
+    }
+  }
+
+  BeatriceParameters params = processor->getParameters();
+  params.targetSpeaker = preset.voiceId;
+  params.inputGain = preset.inputGain;
+  params.outputGain = preset.outputGain;
+  params.pitchShift = preset.pitchShift;
+  params.formantShift = preset.formantShift;
+  params.vqNumNeighbors = preset.vqNumNeighbors;
+  params.intonationIntensity = preset.intonationIntensity;
+  params.pitchCorrection = preset.pitchCorrection;
+  params.pitchCorrectionMode = preset.pitchCorrectionMode;
+  params.minSourcePitch = preset.minSourcePitch;
+  params.maxSourcePitch = preset.maxSourcePitch;
+  params.speakerMorphingWeights.fill(0.0f);
+  std::copy_n(preset.morphingWeights.begin(),
+              std::min(preset.morphingWeights.size(),
+                       params.speakerMorphingWeights.size()),
+              params.speakerMorphingWeights.begin());
+
+  {
+    // Everything below reaches the audio thread in the same block. Each
+    // stage derives its coefficients here, on this thread, once.
+    ParameterBatch batch;
+    processor->setParameters(params);
+    amplifier->setGain(preset.amplifierGain);
+    noiseGate->setThreshold(preset.noiseGateThreshold);
+    noiseGate->setRange(preset.noiseGateRange);
+    noiseGate->setAttack(preset.noiseGateAttack);
+    noiseGate->setRelease(preset.noiseGateRelease);
+    compressor->setThreshold(preset.compressorThreshold);
+    compressor->setRatio(preset.compressorRatio);
+    compressor->setAttack(preset.compressorAttack);
+    compressor->setRelease(preset.compressorRelease);
+    compressor->setMakeupGain(preset.compressorMakeupGain);
+    limiter->setThreshold(preset.limiterThreshold);
+    limiter->setAttack(preset.limiterAttack);
+    limiter->setRelease(preset.limiterRelease);
+    limiter->setLookAhead(preset.limiterLookAhead);
+    preEqualizer->setBands(toBandSettings(preset.preEqualizerBands));
+    postEqualizer->setBands(toBandSettings(preset.postEqualizerBands));
+  }
+  // Switched after the batch is committed, so a stage that comes on starts
+  // with the preset's parameters rather than the previous ones.
+  amplifier->setEnabled(preset.isEnabled(BeatricePreset::kAmplifierEnabled));
+  rnnoise->setEnabled(preset.isEnabled(BeatricePreset::kRNNoiseEnabled));
+  noiseGate->setEnabled(preset.isEnabled(BeatricePreset::kNoiseGateEnabled));
+  compressor->setEnabled(
+      preset.isEnabled(BeatricePreset::kCompressorEnabled));
+  limiter->setEnabled(preset.isEnabled(BeatricePreset::kLimiterEnabled));
+  preEqualizer->setEnabled(
+      preset.isEnabled(BeatricePreset::kPreEqualizerEnabled));
+  postEqualizer->setEnabled(
+      preset.isEnabled(BeatricePreset::kPostEqualizerEnabled));
+  // The preset may change the limiter's look-ahead.
+  rebuildEffectorPlan();
+  return JNI_TRUE;
 }
 
 JNIEXPORT jboolean JNICALL
@@ -796,6 +1172,12 @@ Java_com_gokrack_beatriceapp_beatriceEngine_getNoiseGateRange(JNIEnv* env,
   });
 }
 
+JNIEXPORT jobject JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getMeterBuffer(JNIEnv* env,
+                                                           jclass type) {
+  return env->NewDirectByteBuffer(&meterBlock, sizeof(meterBlock));
+}
+
 JNIEXPORT jdouble JNICALL
 Java_com_gokrack_beatriceapp_beatriceEngine_getNoiseGateDetectorLevel(
     JNIEnv* env, jclass type) {
@@ -879,6 +1261,52 @@ Java_com_gokrack_beatriceapp_beatriceEngine_getRNNoiseVadProbability(
                            });
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_setSilenceSkipEnabled(
+    JNIEnv* env, jclass type, jboolean enabled) {
+  if (!isEffectorAvailable(voiceActivityDetector, "VoiceActivityDetector")) {
+    return JNI_FALSE;
+  }
+  voiceActivityDetector->setEnabled(enabled == JNI_TRUE);
+  return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_isSilenceSkipEnabled(JNIEnv* env,
+                                                                 jclass type) {
+  return getEffectorBoolean(
+      voiceActivityDetector, "VoiceActivityDetector",
+      [](const VoiceActivityDetector& value) { return value.isEnabled(); });
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_setSilenceSkipThreshold(
+    JNIEnv* env, jclass type, jdouble threshold) {
+  if (!isEffectorAvailable(voiceActivityDetector, "VoiceActivityDetector")) {
+    return JNI_FALSE;
+  }
+  voiceActivityDetector->setThreshold(static_cast<float>(threshold));
+  return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_setSilenceSkipHangover(
+    JNIEnv* env, jclass type, jdouble hangover) {
+  if (!isEffectorAvailable(voiceActivityDetector, "VoiceActivityDetector")) {
+    return JNI_FALSE;
+  }
+  voiceActivityDetector->setHangover(static_cast<float>(hangover));
+  return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_isBeatriceCoreSkipping(
+    JNIEnv* env, jclass type) {
+  return getEffectorBoolean(
+      processor, "Processor",
+      [](const BeatriceProcessor& value) { return value.isCoreSkipping(); });
+}
+
 JNIEXPORT jdouble JNICALL
 Java_com_gokrack_beatriceapp_beatriceEngine_getRNNoiseInputPeak(JNIEnv* env,
                                                                 jclass type) {
@@ -1170,16 +1598,13 @@ Java_com_gokrack_beatriceapp_beatriceEngine_setPreEqualizerBandAsAllpass(
   return JNI_TRUE;
 }
 
-JNIEXPORT jdoubleArray JNICALL
+JNIEXPORT jboolean JNICALL
 Java_com_gokrack_beatriceapp_beatriceEngine_getPreEqualizerFrequencyResponse(
-    JNIEnv* env, jclass type, jdoubleArray frequencies) {
+    JNIEnv* env, jclass type, jobject frequencies, jobject response) {
   if (!isEffectorAvailable(preEqualizer, "PreEqualizer")) {
-    return makeEmptyDoubleArray(env);
+    return JNI_FALSE;
   }
-
-  const auto frequencyPoints = toFloatVector(env, frequencies);
-  const auto response = preEqualizer->computeFrequencyResponse(frequencyPoints);
-  return toDoubleArray(env, response);
+  return computeEqualizerResponse(*preEqualizer, env, frequencies, response);
 }
 
 JNIEXPORT jboolean JNICALL
@@ -1279,17 +1704,13 @@ Java_com_gokrack_beatriceapp_beatriceEngine_setPostEqualizerBandAsAllpass(
   return JNI_TRUE;
 }
 
-JNIEXPORT jdoubleArray JNICALL
+JNIEXPORT jboolean JNICALL
 Java_com_gokrack_beatriceapp_beatriceEngine_getPostEqualizerFrequencyResponse(
-    JNIEnv* env, jclass type, jdoubleArray frequencies) {
+    JNIEnv* env, jclass type, jobject frequencies, jobject response) {
   if (!isEffectorAvailable(postEqualizer, "PostEqualizer")) {
-    return makeEmptyDoubleArray(env);
+    return JNI_FALSE;
   }
-
-  const auto frequencyPoints = toFloatVector(env, frequencies);
-  const auto response =
-      postEqualizer->computeFrequencyResponse(frequencyPoints);
-  return toDoubleArray(env, response);
+  return computeEqualizerResponse(*postEqualizer, env, frequencies, response);
 }
 
 JNIEXPORT jboolean JNICALL
@@ -1334,6 +1755,19 @@ Java_com_gokrack_beatriceapp_beatriceEngine_setLimiterRelease(JNIEnv* env,
   return JNI_TRUE;
 }
 
+JNIEXPORT jboolean JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_setLimiterLookAhead(
+    JNIEnv* env, jclass type, jdouble lookAhead) {
+  if (!isEffectorAvailable(limiter, "Limiter")) {
+    return JNI_FALSE;
+  }
+  limiter->setLookAhead(static_cast<float>(lookAhead));
+  // The look-ahead is the limiter's latency, which keeps it out of a
+  // parallel branch.
+  rebuildEffectorPlan();
+  return JNI_TRUE;
+}
+
 JNIEXPORT jboolean JNICALL
 Java_com_gokrack_beatriceapp_beatriceEngine_isLimiterEnabled(JNIEnv* env,
                                                              jclass type) {
@@ -1358,6 +1792,14 @@ Java_com_gokrack_beatriceapp_beatriceEngine_getLimiterAttack(JNIEnv* env,
   });
 }
 
+JNIEXPORT jdouble JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getLimiterLookAhead(JNIEnv* env,
+                                                                jclass type) {
+  return getEffectorDouble(limiter, "Limiter", [](const Limiter& value) {
+    return value.getLookAhead();
+  });
+}
+
 JNIEXPORT jdouble JNICALL
 Java_com_gokrack_beatriceapp_beatriceEngine_getLimiterRelease(JNIEnv* env,
                                                               jclass type) {
@@ -1430,4 +1872,234 @@ Java_com_gokrack_beatriceapp_beatriceEngine_getFramesPerBurst(JNIEnv* env,
   return audioEngine->getFramesPerBurst();
 }
 
+JNIEXPORT jint JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getBlockSize(JNIEnv* env,
+                                                         jclass type) {
+  if (!audioEngine) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return 0;
+  }
+  return audioEngine->getBlockSize();
+}
+
+JNIEXPORT jint JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getBufferCount(JNIEnv* env,
+                                                           jclass type) {
+  if (!audioEngine) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return 0;
+  }
+  return audioEngine->getBufferCount();
+}
+
+JNIEXPORT jint JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getOutputBufferSize(JNIEnv* env,
+                                                                jclass type) {
+  if (!audioEngine) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return 0;
+  }
+  return audioEngine->getOutputBufferSize();
+}
+
+JNIEXPORT jint JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getEffectorLatency(JNIEnv* env,
+                                                               jclass type) {
+  if (!audioEngine) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return 0;
+  }
+  return audioEngine->getEffectorLatency();
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getOverrunCount(JNIEnv* env,
+                                                            jclass type) {
+  if (!audioEngine) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return 0;
+  }
+  return static_cast<jlong>(audioEngine->getOverrunCount());
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getUnderrunCount(JNIEnv* env,
+                                                             jclass type) {
+  if (!audioEngine) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return 0;
+  }
+  return static_cast<jlong>(audioEngine->getUnderrunCount());
+}
+
+JNIEXPORT void JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_setProfilerEnabled(
+    JNIEnv* env, jclass type, jboolean isEnabled) {
+  if (!profiler) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return;
+  }
+  profiler->setEnabled(isEnabled == JNI_TRUE);
+}
+
+JNIEXPORT void JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_resetProfiler(JNIEnv* env,
+                                                          jclass type) {
+  if (!profiler) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return;
+  }
+  profiler->reset();
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getProfilerStageNames(
+    JNIEnv* env, jclass type) {
+  jclass stringClass = env->FindClass("java/lang/String");
+  if (!profiler) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return env->NewObjectArray(0, stringClass, nullptr);
+  }
+  const auto snapshot = profiler->snapshot();
+  jobjectArray names = env->NewObjectArray(
+      static_cast<jsize>(snapshot.stages.size() + 2), stringClass, nullptr);
+  if (!names) {
+    return nullptr;
+  }
+  env->SetObjectArrayElement(names, 0, env->NewStringUTF("callback"));
+  env->SetObjectArrayElement(names, 1, env->NewStringUTF("chain"));
+  for (size_t i = 0; i < snapshot.stages.size(); ++i) {
+    env->SetObjectArrayElement(
+        names, static_cast<jsize>(i + 2),
+        env->NewStringUTF(snapshot.stages[i].name.c_str()));
+  }
+  return names;
+}
+
+// Returns kProfilerStatsStride values per entry, in the order of
+// getProfilerStageNames(): count, mean, p50, p95, p99, max (microseconds) and
+// deadline misses.
+JNIEXPORT jdoubleArray JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getProfilerStats(JNIEnv* env,
+                                                             jclass type) {
+  if (!profiler) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return makeEmptyDoubleArray(env);
+  }
+  const auto snapshot = profiler->snapshot();
+  std::vector<jdouble> values;
+  values.reserve((snapshot.stages.size() + 2) * kProfilerStatsStride);
+  auto append = [&values](const TimingHistogram::Stats& stats) {
+    values.push_back(static_cast<jdouble>(stats.count));
+    values.push_back(static_cast<jdouble>(stats.meanMicros));
+    values.push_back(static_cast<jdouble>(stats.p50Micros));
+    values.push_back(static_cast<jdouble>(stats.p95Micros));
+    values.push_back(static_cast<jdouble>(stats.p99Micros));
+    values.push_back(static_cast<jdouble>(stats.maxMicros));
+    values.push_back(static_cast<jdouble>(stats.deadlineMisses));
+  };
+  append(snapshot.callback);
+  append(snapshot.chain);
+  for (const auto& stage : snapshot.stages) {
+    append(stage.stats);
+  }
+  jdoubleArray outputArray =
+      env->NewDoubleArray(static_cast<jsize>(values.size()));
+  if (outputArray) {
+    env->SetDoubleArrayRegion(outputArray, 0,
+                              static_cast<jsize>(values.size()), values.data());
+  }
+  return outputArray;
+}
+
+// Names are the chain's stage names, as getProfilerStageNames() reports them
+// after "callback" and "chain". "meters" must stay last, which the chain
+// enforces, and "rnnoise" and "dynamics" must run before "beatrice": its
+// voice activity detector reads their state for the block being converted.
+JNIEXPORT jboolean JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_setEffectorOrder(
+    JNIEnv* env, jclass type, jobjectArray names) {
+  if (!effectorChain) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return JNI_FALSE;
+  }
+  std::vector<std::string> order;
+  const jsize count = names ? env->GetArrayLength(names) : 0;
+  for (jsize i = 0; i < count; ++i) {
+    auto name = static_cast<jstring>(env->GetObjectArrayElement(names, i));
+    order.push_back(toStdString(env, name));
+    env->DeleteLocalRef(name);
+  }
+  const auto beatrice = std::find(order.begin(), order.end(), "beatrice");
+  for (const char* source : {"rnnoise", "dynamics"}) {
+    if (std::find(order.begin(), beatrice, source) == beatrice) {
+      LOGW("Effector order must run \"%s\" before \"beatrice\"", source);
+      return JNI_FALSE;
+    }
+  }
+  return effectorChain->setOrder(order) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_getEffectorOrder(JNIEnv* env,
+                                                             jclass type) {
+  jclass stringClass = env->FindClass("java/lang/String");
+  if (!effectorChain) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return env->NewObjectArray(0, stringClass, nullptr);
+  }
+  const auto order = effectorChain->getOrder();
+  jobjectArray names = env->NewObjectArray(static_cast<jsize>(order.size()),
+                                           stringClass, nullptr);
+  if (!names) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < order.size(); ++i) {
+    env->SetObjectArrayElement(names, static_cast<jsize>(i),
+                               env->NewStringUTF(order[i].c_str()));
+  }
+  return names;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_gokrack_beatriceapp_beatriceEngine_setEffectorWetMix(JNIEnv* env,
+                                                              jclass type,
+                                                              jstring name,
+                                                              jdouble wetMix) {
+  if (!effectorChain) {
+    LOGE(
+        "Engine is null, you must call createEngine before calling this "
+        "method");
+    return JNI_FALSE;
+  }
+  return effectorChain->setWetMix(toStdString(env, name),
+                                  static_cast<float>(wetMix))
+             ? JNI_TRUE
+             : JNI_FALSE;
+}
+
 }  // extern "C"
@@ -4,6 +4,9 @@ import android.content.Context
 import android.media.AudioManager
 import android.os.Build
 import android.content.res.AssetManager
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.FloatBuffer
 import kotlin.math.exp
 import kotlin.math.ln
 
@@ -17,7 +20,13 @@ object beatriceEngine {
     }
 
     // Native methods
-    external fun create(assetManager: AssetManager, filesDir: String): Boolean
+    // cacheDir holds the model index, which lists the models under filesDir
+    // with their metadata. Loads selectedModelPath if it is indexed, else the
+    // newest model.
+    external fun create(
+        assetManager: AssetManager, filesDir: String, cacheDir: String,
+        selectedModelPath: String
+    ): Boolean
     external fun isAAudioRecommended(): Boolean
     external fun setAPI(apiType: Int): Boolean
     external fun setEffectOn(isEffectOn: Boolean): Boolean
@@ -25,11 +34,28 @@ object beatriceEngine {
     external fun setPlaybackDeviceId(deviceId: Int)
     external fun setPerformanceMode(performanceMode: Int): Boolean
     external fun setAsyncMode(isAsyncMode: Boolean): Boolean
+    external fun setBlockSize(blockSize: Int): Boolean
+    external fun setBufferCount(bufferCount: Int): Boolean
     external fun setVoiceCommunicationMode(isVoiceCommunicationMode: Boolean): Boolean
+    // Loads a model in the background; call from a worker thread, then
+    // readModel() with the same path on the main thread to switch to it.
+    // readModel() neither loads nor waits, and returns false if the preload
+    // is missing or was made for another sample rate; preload again then.
+    external fun preloadModel(modelPath: String): Boolean
     external fun readModel( modelPath : String ):Boolean
+    external fun getModelPath(): String
     external fun getModelName():String
     external fun getModelDescription():String
     external fun getModelVersion():Int
+    // The model index: models found under filesDir, queried without loading
+    // them. refreshModelIndex() rescans only what changed.
+    external fun refreshModelIndex(): Boolean
+    external fun getIndexedModelCount(): Int
+    external fun getIndexedModelPath(modelIndex: Int): String
+    external fun getIndexedModelName(modelIndex: Int): String
+    external fun getIndexedModelDescription(modelIndex: Int): String
+    external fun getIndexedVoiceName(modelIndex: Int, voiceID: Int): String
+    external fun getIndexedVoiceDescription(modelIndex: Int, voiceID: Int): String
     external fun setVoiceID(voiceID: Int): Boolean
     external fun getVoiceName(voiceID: Int): String
     external fun getVoiceDescription(voiceID: Int): String
@@ -45,6 +71,9 @@ object beatriceEngine {
     external fun setSourcePitchRange(minPitch: Double, maxPitch: Double): Boolean
     external fun setVQNumNeighbors(numNeighbors: Int): Boolean
     external fun setSpeakerMorphingWeights(weights: FloatArray): Boolean
+    // Applies every setting of PresetManager.encodeSettings() at once; false
+    // if the data is invalid.
+    external fun applyPreset(data: ByteArray): Boolean
     external fun setProcessorEnabled(enabled: Boolean): Boolean
     external fun setNoiseGateEnabled(enabled: Boolean): Boolean
     external fun setNoiseGateThreshold(threshold: Double): Boolean
@@ -56,6 +85,8 @@ object beatriceEngine {
     external fun getNoiseGateAttack(): Double
     external fun getNoiseGateRelease(): Double
     external fun getNoiseGateRange(): Double
+    // Direct buffer over the meter block; wrap it in a MeterSnapshot.
+    external fun getMeterBuffer(): ByteBuffer
     external fun getNoiseGateDetectorLevel(): Double
     external fun getNoiseGateGainReduction(): Double
     external fun getNoiseGateInputPeak(): Double
@@ -68,6 +99,11 @@ object beatriceEngine {
     external fun getRNNoiseVadProbability(): Double
     external fun getRNNoiseInputPeak(): Double
     external fun getRNNoiseOutputPeak(): Double
+    external fun setSilenceSkipEnabled(enabled: Boolean): Boolean
+    external fun isSilenceSkipEnabled(): Boolean
+    external fun setSilenceSkipThreshold(threshold: Double): Boolean
+    external fun setSilenceSkipHangover(hangoverMs: Double): Boolean
+    external fun isBeatriceCoreSkipping(): Boolean
     external fun setAmplifierEnabled(enabled: Boolean): Boolean
     external fun setAmplifierGain(gainDb: Double): Boolean
     external fun isAmplifierEnabled(): Boolean
@@ -96,7 +132,9 @@ object beatriceEngine {
     external fun setPreEqualizerBandAsHighShelf(bandIndex: Int, cutoffFrequency: Double, q: Double, gainDb: Double): Boolean
     external fun setPreEqualizerBandAsNotch(bandIndex: Int, centerFrequency: Double, q: Double): Boolean
     external fun setPreEqualizerBandAsAllpass(bandIndex: Int, centerFrequency: Double, q: Double): Boolean
-    external fun getPreEqualizerFrequencyResponse(frequencies: DoubleArray): DoubleArray
+    // Fills response (dB) for frequencies (Hz); both from allocateFloatBuffer()
+    // with the same size.
+    external fun getPreEqualizerFrequencyResponse(frequencies: FloatBuffer, response: FloatBuffer): Boolean
     external fun setPostEqualizerEnabled(enabled: Boolean): Boolean
     external fun setPostEqualizerBandAsPeaking(bandIndex: Int, centerFrequency: Double, q: Double, gainDb: Double): Boolean
     external fun setPostEqualizerBandAsLowpass(bandIndex: Int, cutoffFrequency: Double, q: Double): Boolean
@@ -105,15 +143,17 @@ object beatriceEngine {
     external fun setPostEqualizerBandAsHighShelf(bandIndex: Int, cutoffFrequency: Double, q: Double, gainDb: Double): Boolean
     external fun setPostEqualizerBandAsNotch(bandIndex: Int, centerFrequency: Double, q: Double): Boolean
     external fun setPostEqualizerBandAsAllpass(bandIndex: Int, centerFrequency: Double, q: Double): Boolean
-    external fun getPostEqualizerFrequencyResponse(frequencies: DoubleArray): DoubleArray
+    external fun getPostEqualizerFrequencyResponse(frequencies: FloatBuffer, response: FloatBuffer): Boolean
     external fun setLimiterEnabled(enabled: Boolean): Boolean
     external fun setLimiterThreshold(threshold: Double): Boolean
     external fun setLimiterAttack(attack: Double): Boolean
     external fun setLimiterRelease(release: Double): Boolean
+    external fun setLimiterLookAhead(lookAhead: Double): Boolean
     external fun isLimiterEnabled(): Boolean
     external fun getLimiterThreshold(): Double
     external fun getLimiterAttack(): Double
     external fun getLimiterRelease(): Double
+    external fun getLimiterLookAhead(): Double
     external fun getLimiterDetectorLevel(): Double
     external fun getLimiterGainReduction(): Double
     external fun getLimiterInputPeak(): Double
@@ -124,23 +164,49 @@ object beatriceEngine {
     external fun native_setDefaultStreamValues(defaultSampleRate: Int, defaultFramesPerBurst: Int)
     external fun getSampleRate(): Int
     external fun getFramesPerBurst(): Int
+    external fun getBlockSize(): Int
+    external fun getBufferCount(): Int
+    external fun getOutputBufferSize(): Int
+    external fun getEffectorLatency(): Int
+    external fun getOverrunCount(): Long
+    external fun getUnderrunCount(): Long
+    external fun setProfilerEnabled(isEnabled: Boolean)
+    external fun resetProfiler()
+    external fun getProfilerStageNames(): Array<String>
+    external fun getProfilerStats(): DoubleArray
+    // Stage names as in getProfilerStageNames(), each once, ending with
+    // "meters", with "rnnoise" and "dynamics" before "beatrice"; false leaves
+    // the order unchanged.
+    external fun setEffectorOrder(names: Array<String>): Boolean
+    external fun getEffectorOrder(): Array<String>
+    // Runs a stage as a parallel branch: wetMix of its output, the rest its
+    // input; 1 runs it in series. Stages with latency (rnnoise, limiter,
+    // beatrice) only run in series; false for them below 1.
+    external fun setEffectorWetMix(name: String, wetMix: Double): Boolean
+
+    // A direct FloatBuffer in native byte order, as the native side reads and
+    // writes in place; allocate it once and reuse it.
+    fun allocateFloatBuffer(count: Int): FloatBuffer =
+        ByteBuffer.allocateDirect(count * Float.SIZE_BYTES)
+            .order(ByteOrder.nativeOrder())
+            .asFloatBuffer()
 
     fun generateLogFrequencies(
         pointCount: Int = 256,
         minHz: Double = 20.0,
         maxHz: Double = 20000.0
-    ): DoubleArray {
+    ): FloatBuffer {
         require(pointCount >= 2) { "pointCount must be >= 2" }
         require(minHz > 0.0) { "minHz must be > 0" }
         require(maxHz > minHz) { "maxHz must be greater than minHz" }
 
-        val result = DoubleArray(pointCount)
+        val result = allocateFloatBuffer(pointCount)
         val minLog = ln(minHz)
         val maxLog = ln(maxHz)
         val step = (maxLog - minLog) / (pointCount - 1)
 
         for (i in 0 until pointCount) {
-            result[i] = exp(minLog + step * i)
+            result.put(i, exp(minLog + step * i).toFloat())
         }
 
         return result
@@ -34,6 +34,7 @@ class EffectorFragment : Fragment() {
         private const val MIN_HZ = 20.0
         private const val MAX_HZ = 20000.0
         private const val EQ_LOG_STEPS = 1000f
+        private const val EQ_CURVE_POINTS = 256
         private const val PRE_EQ_BANDS = 3
         private const val POST_EQ_BANDS = 5
 
@@ -42,6 +43,13 @@ class EffectorFragment : Fragment() {
     }
 
     private val handler = Handler(Looper.getMainLooper())
+    private val meters by lazy { MeterSnapshot(beatriceEngine.getMeterBuffer()) }
+    // Allocated once; the engine fills the responses in place on every redraw.
+    private val eqFrequencies by lazy {
+        beatriceEngine.generateLogFrequencies(EQ_CURVE_POINTS, MIN_HZ, MAX_HZ)
+    }
+    private val preEqResponse by lazy { beatriceEngine.allocateFloatBuffer(EQ_CURVE_POINTS) }
+    private val postEqResponse by lazy { beatriceEngine.allocateFloatBuffer(EQ_CURVE_POINTS) }
     private var isMeterUpdating = false
     private var isRestoring = false
 
@@ -80,6 +88,7 @@ class EffectorFragment : Fragment() {
     private lateinit var limiterThreshold: SliderBinding
     private lateinit var limiterAttack: SliderBinding
     private lateinit var limiterRelease: SliderBinding
+    private lateinit var limiterLookAhead: SliderBinding
 
     // Meters
     private lateinit var noiseGateMeters: DynamicMetersBinding
@@ -301,6 +310,13 @@ class EffectorFragment : Fragment() {
             SettingsManager.saveLimiterRelease(value)
             beatriceEngine.setLimiterRelease(value.toDouble())
         }
+        limiterLookAhead = SliderBinding(
+            view, R.id.limiter_look_ahead_slider,
+            getString(R.string.look_ahead), 0f, 5f, 0.1f, "%.1f ms"
+        ) { value ->
+            SettingsManager.saveLimiterLookAhead(value)
+            beatriceEngine.setLimiterLookAhead(value.toDouble())
+        }
     }
 
     private fun setupMeters(view: View) {
@@ -399,10 +415,12 @@ class EffectorFragment : Fragment() {
         limiterThreshold.setValue(SettingsManager.loadLimiterThreshold())
         limiterAttack.setValue(SettingsManager.loadLimiterAttack())
         limiterRelease.setValue(SettingsManager.loadLimiterRelease())
+        limiterLookAhead.setValue(SettingsManager.loadLimiterLookAhead())
         beatriceEngine.setLimiterEnabled(limiterEnabled)
         beatriceEngine.setLimiterThreshold(limiterThreshold.value.toDouble())
         beatriceEngine.setLimiterAttack(limiterAttack.value.toDouble())
         beatriceEngine.setLimiterRelease(limiterRelease.value.toDouble())
+        beatriceEngine.setLimiterLookAhead(limiterLookAhead.value.toDouble())
 
         // EQ
         val preEqEnabled = SettingsManager.loadPreEqualizerEnabled()
@@ -425,22 +443,23 @@ class EffectorFragment : Fragment() {
     }
 
     private fun updateMeters() {
+        meters.update()
         noiseGateMeters.setLevels(
-            beatriceEngine.getNoiseGateInputPeak().toFloat(),
-            beatriceEngine.getNoiseGateOutputPeak().toFloat(),
-            beatriceEngine.getNoiseGateGainReduction().toFloat()
+            meters[MeterSnapshot.NOISE_GATE_INPUT_PEAK],
+            meters[MeterSnapshot.NOISE_GATE_OUTPUT_PEAK],
+            meters[MeterSnapshot.NOISE_GATE_GAIN_REDUCTION]
         )
 
         compressorMeters.setLevels(
-            beatriceEngine.getCompressorInputPeak().toFloat(),
-            beatriceEngine.getCompressorOutputPeak().toFloat(),
-            beatriceEngine.getCompressorGainReduction().toFloat()
+            meters[MeterSnapshot.COMPRESSOR_INPUT_PEAK],
+            meters[MeterSnapshot.COMPRESSOR_OUTPUT_PEAK],
+            meters[MeterSnapshot.COMPRESSOR_GAIN_REDUCTION]
         )
 
         limiterMeters.setLevels(
-            beatriceEngine.getLimiterInputPeak().toFloat(),
-            beatriceEngine.getLimiterOutputPeak().toFloat(),
-            beatriceEngine.getLimiterGainReduction().toFloat()
+            meters[MeterSnapshot.LIMITER_INPUT_PEAK],
+            meters[MeterSnapshot.LIMITER_OUTPUT_PEAK],
+            meters[MeterSnapshot.LIMITER_GAIN_REDUCTION]
         )
 
         val isRnnoiseReady = beatriceEngine.isRNNoiseReady()
@@ -450,12 +469,12 @@ class EffectorFragment : Fragment() {
             getString(R.string.rnnoise_ready_no)
         }
 
-        val vad = beatriceEngine.getRNNoiseVadProbability().toFloat().coerceIn(0f, 1f)
+        val vad = meters[MeterSnapshot.RNNOISE_VAD_PROBABILITY].coerceIn(0f, 1f)
         rnnoiseVadValue.text = String.format("%.2f", vad)
         rnnoiseVadBar.progress = (vad * 1000.0f).roundToInt()
 
-        rnnoiseInputPeakMeter.setLevelDb(beatriceEngine.getRNNoiseInputPeak().toFloat())
-        rnnoiseOutputPeakMeter.setLevelDb(beatriceEngine.getRNNoiseOutputPeak().toFloat())
+        rnnoiseInputPeakMeter.setLevelDb(meters[MeterSnapshot.RNNOISE_INPUT_PEAK])
+        rnnoiseOutputPeakMeter.setLevelDb(meters[MeterSnapshot.RNNOISE_OUTPUT_PEAK])
     }
 
     private fun startMeterUpdate() {
@@ -471,16 +490,14 @@ class EffectorFragment : Fragment() {
     }
 
     private fun updateEqCurve(isPre: Boolean) {
-        val frequencies = beatriceEngine.generateLogFrequencies(256, MIN_HZ, MAX_HZ)
-        val response = if (isPre) {
-            beatriceEngine.getPreEqualizerFrequencyResponse(frequencies)
-        } else {
-            beatriceEngine.getPostEqualizerFrequencyResponse(frequencies)
-        }
         if (isPre) {
-            preEqCurve.setData(frequencies, response)
+            if (beatriceEngine.getPreEqualizerFrequencyResponse(eqFrequencies, preEqResponse)) {
+                preEqCurve.setData(eqFrequencies, preEqResponse)
+            }
         } else {
-            postEqCurve.setData(frequencies, response)
+            if (beatriceEngine.getPostEqualizerFrequencyResponse(eqFrequencies, postEqResponse)) {
+                postEqCurve.setData(eqFrequencies, postEqResponse)
+            }
         }
     }
 
@@ -14,6 +14,8 @@ class EngineStateViewModel : ViewModel() {
     val apiSelection = MutableLiveData(0)                    // 0 = AAudio, 1 = OpenSL ES
     val performanceMode = MutableLiveData(0)                 // 0 = LowLatency, 1 = Normal, 2 = PowerSaving
     val isAsyncMode = MutableLiveData(true)
+    val blockSize = MutableLiveData(0)                       // 0 = Auto, otherwise samples per block
+    val bufferCount = MutableLiveData(0)                     // 0 = Auto, otherwise blocks of buffering
     val isVoiceCommunicationMode = MutableLiveData(false)
     val modelName = MutableLiveData("")
     val voiceNames = MutableLiveData<List<String>>(emptyList())
@@ -44,11 +46,6 @@ class EngineStateViewModel : ViewModel() {
         return weights
     }
 
-    fun reloadMorphingWeightsFromSettingsAndApplyToEngine(): FloatArray {
-        reloadMorphingWeightsFromSettings()
-        return applyCurrentMorphingWeightsToEngine()
-    }
-
     fun ensureMorphingWeightsInitialized(): FloatArray {
         val existing = morphingWeights.value
         if (existing != null) return existing
@@ -85,8 +82,16 @@ class EngineStateViewModel : ViewModel() {
         val wasZero = oldWeight < 0.0001f
         val isNowZero = rounded < 0.0001f
 
+        val candidate = current.copyOf().also { it[index] = rounded }
+        if (!beatriceEngine.setSpeakerMorphingWeights(candidate)) {
+            // Rejected by the model, e.g. too many voices: keep the current weights.
+            return MorphingWeightUpdateResult(
+                changed = false,
+                roundedValue = oldWeight,
+                zeroStateChanged = false
+            )
+        }
         val updated = updateMorphingWeight(index, rounded)
-        beatriceEngine.setSpeakerMorphingWeights(updated)
         SettingsManager.saveMorphingWeights(updated)
 
         val zeroStateChanged = wasZero != isNowZero
@@ -10,6 +10,7 @@ import android.util.Log
 import android.widget.ArrayAdapter
 import android.widget.ImageButton
 import android.widget.Spinner
+import android.widget.Toast
 import androidx.appcompat.app.AppCompatActivity
 import androidx.appcompat.app.AppCompatDelegate
 import androidx.core.app.ActivityCompat
@@ -29,6 +30,8 @@ class MainActivity : AppCompatActivity(), ActivityCompat.OnRequestPermissionsRes
     }
 
     private lateinit var viewModel: EngineStateViewModel
+    // Whether create() succeeded; until then every engine call fails.
+    private var isEngineCreated = false
 
     override fun onCreate(savedInstanceState: Bundle?) {
         AppCompatDelegate.setDefaultNightMode(AppCompatDelegate.MODE_NIGHT_YES)
@@ -101,9 +104,11 @@ class MainActivity : AppCompatActivity(), ActivityCompat.OnRequestPermissionsRes
     }
 
     private fun onStartEngine() {
-        beatriceEngine.create(
+        isEngineCreated = beatriceEngine.create(
             assets,
-            getExternalFilesDir(null)?.absolutePath ?: filesDir.absolutePath
+            getExternalFilesDir(null)?.absolutePath ?: filesDir.absolutePath,
+            cacheDir.absolutePath,
+            SettingsManager.loadModelPath()
         )
         viewModel.isAAudioRecommended.value = beatriceEngine.isAAudioRecommended()
 
@@ -111,6 +116,8 @@ class MainActivity : AppCompatActivity(), ActivityCompat.OnRequestPermissionsRes
         beatriceEngine.setAPI(viewModel.apiSelection.value ?: 0)
         beatriceEngine.setPerformanceMode(viewModel.performanceMode.value ?: 0)
         beatriceEngine.setAsyncMode(viewModel.isAsyncMode.value ?: true)
+        beatriceEngine.setBlockSize(viewModel.blockSize.value ?: 0)
+        beatriceEngine.setBufferCount(viewModel.bufferCount.value ?: 0)
         applyPersistedUserSettingsToEngine()
 
         // Load model info if a model is already present
@@ -166,10 +173,10 @@ class MainActivity : AppCompatActivity(), ActivityCompat.OnRequestPermissionsRes
         saveButton.setOnClickListener {
             val currentIndex = presetSpinner.selectedItemPosition
             PresetManager.savePreset(currentIndex)
-            android.widget.Toast.makeText(
+            Toast.makeText(
                 this,
                 getString(R.string.preset_saved, presetNames[currentIndex]),
-                android.widget.Toast.LENGTH_SHORT
+                Toast.LENGTH_SHORT
             ).show()
         }
 
@@ -194,99 +201,20 @@ class MainActivity : AppCompatActivity(), ActivityCompat.OnRequestPermissionsRes
     }
 
     private fun applyPersistedUserSettingsToEngine() {
-        beatriceEngine.setVoiceID(SettingsManager.loadVoiceId())
-        beatriceEngine.setInputGain(SettingsManager.loadInputGain().toDouble())
-        beatriceEngine.setOutputGain(SettingsManager.loadOutputGain().toDouble())
-        beatriceEngine.setPitchShift(SettingsManager.loadPitchShift().toDouble())
-        beatriceEngine.setFormantShift(SettingsManager.loadFormantShift().toDouble())
-        beatriceEngine.setVQNumNeighbors(SettingsManager.loadVQNeighbors())
-        beatriceEngine.setIntonationIntensity(SettingsManager.loadIntonationIntensity().toDouble())
-        beatriceEngine.setPitchCorrection(SettingsManager.loadPitchCorrection().toDouble())
-        beatriceEngine.setPitchCorrectionMode(SettingsManager.loadPitchCorrectionMode())
-        beatriceEngine.setSourcePitchRange(
-            SettingsManager.loadSourcePitchRangeMin().toDouble(),
-            SettingsManager.loadSourcePitchRangeMax().toDouble()
-        )
-
-        viewModel.reloadMorphingWeightsFromSettingsAndApplyToEngine()
-
-        applyEffectorSettingsToEngine()
-    }
-
-    private fun applyEffectorSettingsToEngine() {
-        beatriceEngine.setAmplifierEnabled(SettingsManager.loadAmplifierEnabled())
-        beatriceEngine.setAmplifierGain(SettingsManager.loadAmplifierGain().toDouble())
-
-        beatriceEngine.setNoiseGateEnabled(SettingsManager.loadNoiseGateEnabled())
-        beatriceEngine.setNoiseGateThreshold(SettingsManager.loadNoiseGateThreshold().toDouble())
-        beatriceEngine.setNoiseGateRange(SettingsManager.loadNoiseGateRange().toDouble())
-        beatriceEngine.setNoiseGateAttack(SettingsManager.loadNoiseGateAttack().toDouble())
-        beatriceEngine.setNoiseGateRelease(SettingsManager.loadNoiseGateRelease().toDouble())
-
-        beatriceEngine.setCompressorEnabled(SettingsManager.loadCompressorEnabled())
-        beatriceEngine.setCompressorThreshold(SettingsManager.loadCompressorThreshold().toDouble())
-        beatriceEngine.setCompressorRatio(SettingsManager.loadCompressorRatio().toDouble())
-        beatriceEngine.setCompressorAttack(SettingsManager.loadCompressorAttack().toDouble())
-        beatriceEngine.setCompressorRelease(SettingsManager.loadCompressorRelease().toDouble())
-        beatriceEngine.setCompressorMakeupGain(SettingsManager.loadCompressorMakeupGain().toDouble())
-
-        beatriceEngine.setLimiterEnabled(SettingsManager.loadLimiterEnabled())
-        beatriceEngine.setLimiterThreshold(SettingsManager.loadLimiterThreshold().toDouble())
-        beatriceEngine.setLimiterAttack(SettingsManager.loadLimiterAttack().toDouble())
-        beatriceEngine.setLimiterRelease(SettingsManager.loadLimiterRelease().toDouble())
-
-        beatriceEngine.setPreEqualizerEnabled(SettingsManager.loadPreEqualizerEnabled())
-        for (i in SettingsManager.DEFAULT_PRE_EQ_FREQUENCIES.indices) {
-            val band = SettingsManager.loadEqualizerBand(true, i)
-            applyEqualizerBandToEngine(true, i, band)
-        }
-
-        beatriceEngine.setPostEqualizerEnabled(SettingsManager.loadPostEqualizerEnabled())
-        for (i in SettingsManager.DEFAULT_POST_EQ_FREQUENCIES.indices) {
-            val band = SettingsManager.loadEqualizerBand(false, i)
-            applyEqualizerBandToEngine(false, i, band)
-        }
-    }
-
-    private fun applyEqualizerBandToEngine(isPre: Boolean, band: Int, settings: SettingsManager.EqualizerBandSettings) {
-        val index = band
-        when (settings.type) {
-            0 -> if (isPre) {
-                beatriceEngine.setPreEqualizerBandAsPeaking(index, settings.frequency.toDouble(), settings.q.toDouble(), settings.gain.toDouble())
-            } else {
-                beatriceEngine.setPostEqualizerBandAsPeaking(index, settings.frequency.toDouble(), settings.q.toDouble(), settings.gain.toDouble())
-            }
-            1 -> if (isPre) {
-                beatriceEngine.setPreEqualizerBandAsLowpass(index, settings.frequency.toDouble(), settings.q.toDouble())
-            } else {
-                beatriceEngine.setPostEqualizerBandAsLowpass(index, settings.frequency.toDouble(), settings.q.toDouble())
-            }
-            2 -> if (isPre) {
-                beatriceEngine.setPreEqualizerBandAsHighpass(index, settings.frequency.toDouble(), settings.q.toDouble())
-            } else {
-                beatriceEngine.setPostEqualizerBandAsHighpass(index, settings.frequency.toDouble(), settings.q.toDouble())
-            }
-            3 -> if (isPre) {
-                beatriceEngine.setPreEqualizerBandAsLowShelf(index, settings.frequency.toDouble(), settings.q.toDouble(), settings.gain.toDouble())
-            } else {
-                beatriceEngine.setPostEqualizerBandAsLowShelf(index, settings.frequency.toDouble(), settings.q.toDouble(), settings.gain.toDouble())
-            }
-            4 -> if (isPre) {
-                beatriceEngine.setPreEqualizerBandAsHighShelf(index, settings.frequency.toDouble(), settings.q.toDouble(), settings.gain.toDouble())
-            } else {
-                beatriceEngine.setPostEqualizerBandAsHighShelf(index, settings.frequency.toDouble(), settings.q.toDouble(), settings.gain.toDouble())
-            }
-            5 -> if (isPre) {
-                beatriceEngine.setPreEqualizerBandAsNotch(index, settings.frequency.toDouble(), settings.q.toDouble())
-            } else {
-                beatriceEngine.setPostEqualizerBandAsNotch(index, settings.frequency.toDouble(), settings.q.toDouble())
-            }
-            6 -> if (isPre) {
-                beatriceEngine.setPreEqualizerBandAsAllpass(index, settings.frequency.toDouble(), settings.q.toDouble())
-            } else {
-                beatriceEngine.setPostEqualizerBandAsAllpass(index, settings.frequency.toDouble(), settings.q.toDouble())
-            }
+        viewModel.reloadMorphingWeightsFromSettings()
+        val morphingWeights = viewModel.ensureMorphingWeightsInitialized()
+        // One call, so the audio thread switches to all settings in the same block.
+        // A single invalid value rejects them all, so say so rather than run on
+        // with the previous settings unnoticed.
+        // Without an engine the call fails whatever the settings, so only ask
+        // one that was created.
+        if (isEngineCreated &&
+            !beatriceEngine.applyPreset(PresetManager.encodeSettings(morphingWeights))
+        ) {
+            Log.e(TAG, "The engine rejected the stored settings")
+            Toast.makeText(this, R.string.settings_rejected, Toast.LENGTH_LONG).show()
         }
+        beatriceEngine.setSilenceSkipEnabled(SettingsManager.loadSilenceSkipEnabled())
     }
 
     override fun onDestroy() {
@@ -315,6 +243,8 @@ class MainActivity : AppCompatActivity(), ActivityCompat.OnRequestPermissionsRes
             beatriceEngine.setAPI(viewModel.apiSelection.value ?: 0)
             beatriceEngine.setPerformanceMode(viewModel.performanceMode.value ?: 0)
             beatriceEngine.setAsyncMode(viewModel.isAsyncMode.value ?: true)
+            beatriceEngine.setBlockSize(viewModel.blockSize.value ?: 0)
+            beatriceEngine.setBufferCount(viewModel.bufferCount.value ?: 0)
             startEffect()
         }
     }
@@ -327,8 +257,13 @@ class MainActivity : AppCompatActivity(), ActivityCompat.OnRequestPermissionsRes
             viewModel.applyCurrentMorphingWeightsToEngine()
             val sampleRate = beatriceEngine.getSampleRate()
             val framesPerBurst = beatriceEngine.getFramesPerBurst()
+            val blockSize = beatriceEngine.getBlockSize()
+            val bufferCount = beatriceEngine.getBufferCount()
+            val effectorLatency = beatriceEngine.getEffectorLatency()
             viewModel.statusText.value = getString(R.string.status_playing) +
-                "\nsampling frequency : ${sampleRate} Hz \t frame size: ${framesPerBurst} samples"
+                "\nsampling frequency : ${sampleRate} Hz \t frame size: ${framesPerBurst} samples" +
+                "\nblock size: ${blockSize} samples \t buffer count: ${bufferCount}" +
+                "\neffector latency: ${effectorLatency} samples"
             viewModel.isEngineRunning.value = true
         } else {
             viewModel.statusText.value = getString(R.string.status_open_failed)
@@ -1,6 +1,7 @@
 package com.gokrack.beatriceapp
 
 import android.app.Activity
+import android.content.ContentResolver
 import android.content.Intent
 import android.net.Uri
 import android.os.Bundle
@@ -25,9 +26,14 @@ import androidx.lifecycle.ViewModelProvider
 import android.graphics.BitmapFactory
 import java.io.File
 import java.io.FileOutputStream
+import java.util.concurrent.FutureTask
 
 class MainFragment : Fragment() {
 
+    companion object {
+        private const val MODEL_LOAD_ATTEMPTS = 3
+    }
+
     private lateinit var viewModel: EngineStateViewModel
     private lateinit var modelPickerLauncher: ActivityResultLauncher<Intent>
     private lateinit var voiceSpinner: Spinner
@@ -36,6 +42,7 @@ class MainFragment : Fragment() {
     private lateinit var voiceDescriptionText: TextView
     private lateinit var voicePortraitDescriptionText: TextView
     private lateinit var voicePortraitImage: ImageView
+    private lateinit var modelSelectButton: Button
 
     override fun onCreate(savedInstanceState: Bundle?) {
         super.onCreate(savedInstanceState)
@@ -84,7 +91,7 @@ class MainFragment : Fragment() {
         voicePortraitDescriptionText = view.findViewById(R.id.voice_portrait_description)
         voicePortraitImage = view.findViewById(R.id.voice_portrait_image)
 
-        val modelSelectButton = view.findViewById<Button>(R.id.button_model_select)
+        modelSelectButton = view.findViewById(R.id.button_model_select)
         modelSelectButton.setOnClickListener {
             val intent = Intent(Intent.ACTION_OPEN_DOCUMENT_TREE).apply {
                 flags = Intent.FLAG_GRANT_READ_URI_PERMISSION or
@@ -99,7 +106,6 @@ class MainFragment : Fragment() {
         }
         viewModel.isEngineRunning.observe(viewLifecycleOwner) { running ->
             toggleButton.setText(if (running) R.string.stop_effect else R.string.start_effect)
-            modelSelectButton.isEnabled = !running
         }
 
         voiceSpinner.onItemSelectedListener = object : AdapterView.OnItemSelectedListener {
@@ -149,12 +155,55 @@ class MainFragment : Fragment() {
         val parentDir = requireNotNull(DocumentFile.fromTreeUri(requireContext(), parentUri))
 
         val destRoot = requireActivity().getExternalFilesDir(null) ?: requireActivity().filesDir
-        deleteDirectoryContents(destRoot)
-        copyFilteredFilesRecursively(parentDir, destRoot, "")
-        beatriceEngine.readModel(
-            tomlFile.name?.let { destRoot.resolve(it).absolutePath } ?: return
-        )
-        updateModelInfo()
+        // Each import gets a directory of its own: the running model may reload
+        // its files at any stream restart, so they stay until the new one is in.
+        val modelDir = File(destRoot, "model_${System.currentTimeMillis()}")
+        val modelPath = tomlFile.name?.let { modelDir.resolve(it).absolutePath } ?: return
+        val activity = requireActivity()
+        val contentResolver = activity.contentResolver
+
+        // Copy and load off the main thread. While the effect is running the
+        // current model keeps playing until readModel() swaps in the new one.
+        modelSelectButton.isEnabled = false
+        Thread {
+            // TOML files last, so that a copy cut short is not taken for a model.
+            copyFilteredFilesRecursively(contentResolver, parentDir, modelDir, "") { !isToml(it) }
+            copyFilteredFilesRecursively(contentResolver, parentDir, modelDir, "") { isToml(it) }
+            // readModel() only switches, on the main thread, and refuses a
+            // preload the streams have been restarted since; preload again then.
+            var loaded = false
+            for (attempt in 0 until MODEL_LOAD_ATTEMPTS) {
+                if (!beatriceEngine.preloadModel(modelPath)) break
+                val commit = FutureTask { beatriceEngine.readModel(modelPath) }
+                activity.runOnUiThread(commit)
+                loaded = commit.get()
+                if (loaded) break
+            }
+            activity.runOnUiThread {
+                if (!loaded) {
+                    Log.e("MainFragment", "Failed to load model $modelPath")
+                    Toast.makeText(activity, R.string.model_load_failed, Toast.LENGTH_SHORT)
+                        .show()
+                } else {
+                    SettingsManager.saveModelPath(modelPath)
+                    if (view != null) {
+                        updateModelInfo()
+                    }
+                }
+            }
+            // Whichever model is no longer in use.
+            if (loaded) {
+                destRoot.listFiles()?.filter { it != modelDir }?.forEach { deleteRecursively(it) }
+            } else {
+                deleteRecursively(modelDir)
+            }
+            activity.runOnUiThread {
+                beatriceEngine.refreshModelIndex()
+                if (view != null) {
+                    modelSelectButton.isEnabled = true
+                }
+            }
+        }.start()
     }
 
     private fun updateModelInfo() {
@@ -210,8 +259,8 @@ class MainFragment : Fragment() {
 
         if (relativePortraitPath.isNotEmpty()) {
             try {
-                val modelRoot = requireActivity().getExternalFilesDir(null) ?: requireActivity().filesDir
-                val absolutePortraitPath = File(modelRoot, relativePortraitPath).absolutePath
+                val modelDir = File(beatriceEngine.getModelPath()).parentFile
+                val absolutePortraitPath = File(modelDir, relativePortraitPath).absolutePath
                 val bitmap = BitmapFactory.decodeFile(absolutePortraitPath)
                 if (bitmap != null) {
                     voicePortraitImage.setImageBitmap(bitmap)
@@ -228,13 +277,6 @@ class MainFragment : Fragment() {
         }
     }
 
-    private fun deleteDirectoryContents(dir: File): Boolean {
-        if (!dir.exists() || !dir.isDirectory) return false
-        var success = true
-        dir.listFiles()?.forEach { file -> success = success && deleteRecursively(file) }
-        return success
-    }
-
     private fun deleteRecursively(file: File): Boolean {
         return if (file.isDirectory) {
             file.listFiles()?.forEach { child -> if (!deleteRecursively(child)) return false }
@@ -245,24 +287,27 @@ class MainFragment : Fragment() {
     }
 
     private fun copyFilteredFilesRecursively(
-        source: DocumentFile, destRoot: File, relativePath: String
+        contentResolver: ContentResolver, source: DocumentFile, destRoot: File,
+        relativePath: String, include: (String) -> Boolean
     ) {
         for (file in source.listFiles()) {
             val newRelPath =
                 if (relativePath.isEmpty()) file.name ?: "" else "$relativePath/${file.name}"
             if (file.isDirectory) {
-                copyFilteredFilesRecursively(file, destRoot, newRelPath)
-            } else if (file.isFile && isTargetExtension(requireNotNull(file.name))) {
+                copyFilteredFilesRecursively(contentResolver, file, destRoot, newRelPath, include)
+            } else if (file.isFile && isTargetExtension(requireNotNull(file.name)) &&
+                include(requireNotNull(file.name))
+            ) {
                 val destFile = File(destRoot, newRelPath)
                 destFile.parentFile?.mkdirs()
-                copyFile(file, destFile)
+                copyFile(contentResolver, file, destFile)
             }
         }
     }
 
-    private fun copyFile(source: DocumentFile, dest: File) {
+    private fun copyFile(contentResolver: ContentResolver, source: DocumentFile, dest: File) {
         try {
-            requireActivity().contentResolver.openInputStream(source.uri)?.use { input ->
+            contentResolver.openInputStream(source.uri)?.use { input ->
                 FileOutputStream(dest).use { output -> input.copyTo(output) }
             }
         } catch (e: Exception) {
@@ -270,8 +315,10 @@ class MainFragment : Fragment() {
         }
     }
 
+    private fun isToml(name: String) = name.endsWith(".toml", ignoreCase = true)
+
     private fun isTargetExtension(name: String) =
-        name.endsWith(".toml", ignoreCase = true) ||
+        isToml(name) ||
         name.endsWith(".bin", ignoreCase = true) ||
         name.endsWith(".png", ignoreCase = true)
 }
@@ -0,0 +1,85 @@
+package com.gokrack.beatriceapp
+
+import android.os.Build
+import java.lang.invoke.VarHandle
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Reads the meter block that the audio thread fills once per block (see
+ * effectors/MeterSnapshot.hpp). All meters come from one shared buffer, so
+ * reading them costs no JNI call however many are shown.
+ *
+ * The block is a seqlock: an odd sequence means a write is in progress, and
+ * a changed sequence means the values read may mix two blocks.
+ */
+class MeterSnapshot(buffer: ByteBuffer) {
+    companion object {
+        // Indices into values; keep in sync with MeterSnapshot::Meter.
+        const val NOISE_GATE_INPUT_PEAK = 0
+        const val NOISE_GATE_OUTPUT_PEAK = 1
+        const val NOISE_GATE_GAIN_REDUCTION = 2
+        const val NOISE_GATE_DETECTOR_LEVEL = 3
+        const val COMPRESSOR_INPUT_PEAK = 4
+        const val COMPRESSOR_OUTPUT_PEAK = 5
+        const val COMPRESSOR_GAIN_REDUCTION = 6
+        const val COMPRESSOR_DETECTOR_LEVEL = 7
+        const val LIMITER_INPUT_PEAK = 8
+        const val LIMITER_OUTPUT_PEAK = 9
+        const val LIMITER_GAIN_REDUCTION = 10
+        const val LIMITER_DETECTOR_LEVEL = 11
+        const val RNNOISE_INPUT_PEAK = 12
+        const val RNNOISE_OUTPUT_PEAK = 13
+        const val RNNOISE_VAD_PROBABILITY = 14
+        const val METER_COUNT = 15
+
+        private const val SEQUENCE_OFFSET = 0
+        private const val METER_COUNT_OFFSET = 4
+        private const val VALUES_OFFSET = 8
+        private const val MAX_ATTEMPTS = 16
+    }
+
+    private val buffer: ByteBuffer = buffer.order(ByteOrder.nativeOrder())
+
+    /** The last consistent snapshot. */
+    val values = FloatArray(METER_COUNT)
+
+    // Read into first, so that a torn read never reaches values.
+    private val scratch = FloatArray(METER_COUNT)
+
+    /** False if the native library has a different meter layout. */
+    val isCompatible = this.buffer.getInt(METER_COUNT_OFFSET) == METER_COUNT
+
+    /**
+     * Copies a consistent snapshot into [values]. Returns false, leaving the
+     * previous snapshot, if the audio thread kept writing meanwhile.
+     */
+    fun update(): Boolean {
+        if (!isCompatible) return false
+        repeat(MAX_ATTEMPTS) {
+            val before = buffer.getInt(SEQUENCE_OFFSET)
+            if ((before and 1) != 0) return@repeat
+            acquireFence()
+            for (i in 0 until METER_COUNT) {
+                scratch[i] = buffer.getFloat(VALUES_OFFSET + 4 * i)
+            }
+            acquireFence()
+            if (buffer.getInt(SEQUENCE_OFFSET) == before) {
+                scratch.copyInto(values)
+                return true
+            }
+        }
+        return false
+    }
+
+    operator fun get(meter: Int): Float = values[meter]
+
+    // Keeps the value reads between the two sequence reads. Without it, on
+    // older releases, a snapshot may rarely mix two blocks, which meters
+    // tolerate.
+    private fun acquireFence() {
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU) {
+            VarHandle.acquireFence()
+        }
+    }
+}
@@ -2,6 +2,8 @@ package com.gokrack.beatriceapp
 
 import android.content.Context
 import android.content.SharedPreferences
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 import java.util.Locale
 
 /**
@@ -13,6 +15,18 @@ object PresetManager {
     private const val CURRENT_PRESET_INDEX = "current_preset_index"
     private const val PRESET_COUNT = 8
 
+    // Binary preset format; must match beatricePreset.h.
+    private const val PRESET_MAGIC = 0x54535042  // "BPST" in little-endian order
+    private const val PRESET_VERSION = 1
+    private const val PRESET_FIXED_FIELDS = 31
+    private const val FLAG_AMPLIFIER = 1 shl 0
+    private const val FLAG_RNNOISE = 1 shl 1
+    private const val FLAG_NOISE_GATE = 1 shl 2
+    private const val FLAG_COMPRESSOR = 1 shl 3
+    private const val FLAG_LIMITER = 1 shl 4
+    private const val FLAG_PRE_EQUALIZER = 1 shl 5
+    private const val FLAG_POST_EQUALIZER = 1 shl 6
+
     private lateinit var prefs: SharedPreferences
 
     fun init(context: Context) {
@@ -84,6 +98,7 @@ object PresetManager {
         editor.putFloat(prefix + "limiter_threshold", SettingsManager.loadLimiterThreshold())
         editor.putFloat(prefix + "limiter_attack", SettingsManager.loadLimiterAttack())
         editor.putFloat(prefix + "limiter_release", SettingsManager.loadLimiterRelease())
+        editor.putFloat(prefix + "limiter_look_ahead", SettingsManager.loadLimiterLookAhead())
 
         // RNNoise
         editor.putBoolean(prefix + "rnnoise_enabled", SettingsManager.loadRnnoiseEnabled())
@@ -114,6 +129,76 @@ object PresetManager {
         editor.apply()
     }
 
+    /**
+     * Encode the current SettingsManager state for beatriceEngine.applyPreset(),
+     * which applies all of it in one step.
+     */
+    fun encodeSettings(morphingWeights: FloatArray): ByteArray {
+        val preBands = SettingsManager.DEFAULT_PRE_EQ_FREQUENCIES.indices.map {
+            SettingsManager.loadEqualizerBand(true, it)
+        }
+        val postBands = SettingsManager.DEFAULT_POST_EQ_FREQUENCIES.indices.map {
+            SettingsManager.loadEqualizerBand(false, it)
+        }
+        val fieldCount = PRESET_FIXED_FIELDS + morphingWeights.size + 4 * (preBands.size + postBands.size)
+        val buffer = ByteBuffer.allocate(4 * fieldCount).order(ByteOrder.LITTLE_ENDIAN)
+
+        buffer.putInt(PRESET_MAGIC)
+        buffer.putInt(PRESET_VERSION)
+
+        // Voice and main parameters
+        buffer.putInt(SettingsManager.loadVoiceId())
+        buffer.putFloat(SettingsManager.loadInputGain())
+        buffer.putFloat(SettingsManager.loadOutputGain())
+        buffer.putFloat(SettingsManager.loadPitchShift())
+        buffer.putFloat(SettingsManager.loadFormantShift())
+        buffer.putInt(SettingsManager.loadVQNeighbors())
+        buffer.putFloat(SettingsManager.loadIntonationIntensity())
+        buffer.putFloat(SettingsManager.loadPitchCorrection())
+        buffer.putInt(SettingsManager.loadPitchCorrectionMode())
+        buffer.putFloat(SettingsManager.loadSourcePitchRangeMin())
+        buffer.putFloat(SettingsManager.loadSourcePitchRangeMax())
+        buffer.putInt(morphingWeights.size)
+        morphingWeights.forEach { buffer.putFloat(it) }
+
+        // Effectors
+        var flags = 0
+        if (SettingsManager.loadAmplifierEnabled()) flags = flags or FLAG_AMPLIFIER
+        if (SettingsManager.loadRnnoiseEnabled()) flags = flags or FLAG_RNNOISE
+        if (SettingsManager.loadNoiseGateEnabled()) flags = flags or FLAG_NOISE_GATE
+        if (SettingsManager.loadCompressorEnabled()) flags = flags or FLAG_COMPRESSOR
+        if (SettingsManager.loadLimiterEnabled()) flags = flags or FLAG_LIMITER
+        if (SettingsManager.loadPreEqualizerEnabled()) flags = flags or FLAG_PRE_EQUALIZER
+        if (SettingsManager.loadPostEqualizerEnabled()) flags = flags or FLAG_POST_EQUALIZER
+        buffer.putInt(flags)
+        buffer.putFloat(SettingsManager.loadAmplifierGain())
+        buffer.putFloat(SettingsManager.loadNoiseGateThreshold())
+        buffer.putFloat(SettingsManager.loadNoiseGateRange())
+        buffer.putFloat(SettingsManager.loadNoiseGateAttack())
+        buffer.putFloat(SettingsManager.loadNoiseGateRelease())
+        buffer.putFloat(SettingsManager.loadCompressorThreshold())
+        buffer.putFloat(SettingsManager.loadCompressorRatio())
+        buffer.putFloat(SettingsManager.loadCompressorAttack())
+        buffer.putFloat(SettingsManager.loadCompressorRelease())
+        buffer.putFloat(SettingsManager.loadCompressorMakeupGain())
+        buffer.putFloat(SettingsManager.loadLimiterThreshold())
+        buffer.putFloat(SettingsManager.loadLimiterAttack())
+        buffer.putFloat(SettingsManager.loadLimiterRelease())
+        buffer.putFloat(SettingsManager.loadLimiterLookAhead())
+
+        // Equalizers
+        for (bands in listOf(preBands, postBands)) {
+            buffer.putInt(bands.size)
+            for (band in bands) {
+                buffer.putInt(band.type)
+                buffer.putFloat(band.frequency)
+                buffer.putFloat(band.q)
+                buffer.putFloat(band.gain)
+            }
+        }
+        return buffer.array()
+    }
+
     /**
      * Load preset from the specified slot into SettingsManager
      */
@@ -175,6 +260,7 @@ object PresetManager {
         SettingsManager.saveLimiterThreshold(prefs.getFloat(prefix + "limiter_threshold", SettingsManager.DEFAULT_LIMITER_THRESHOLD))
         SettingsManager.saveLimiterAttack(prefs.getFloat(prefix + "limiter_attack", SettingsManager.DEFAULT_LIMITER_ATTACK))
         SettingsManager.saveLimiterRelease(prefs.getFloat(prefix + "limiter_release", SettingsManager.DEFAULT_LIMITER_RELEASE))
+        SettingsManager.saveLimiterLookAhead(prefs.getFloat(prefix + "limiter_look_ahead", SettingsManager.DEFAULT_LIMITER_LOOK_AHEAD))
 
         // RNNoise
         SettingsManager.saveRnnoiseEnabled(prefs.getBoolean(prefix + "rnnoise_enabled", SettingsManager.DEFAULT_RNNOISE_ENABLED))
@@ -21,6 +21,8 @@ object SettingsManager {
     private const val KEY_SOURCE_PITCH_RANGE_MAX = "source_pitch_range_max"
     private const val KEY_MORPHING_WEIGHTS = "morphing_weights"
     private const val KEY_VOICE_ID = "voice_id"
+    private const val KEY_MODEL_PATH = "model_path"
+    private const val KEY_SILENCE_SKIP_ENABLED = "silence_skip_enabled"
 
     // Effector settings
     private const val KEY_AMPLIFIER_ENABLED = "amplifier_enabled"
@@ -41,6 +43,7 @@ object SettingsManager {
     private const val KEY_LIMITER_THRESHOLD = "limiter_threshold"
     private const val KEY_LIMITER_ATTACK = "limiter_attack"
     private const val KEY_LIMITER_RELEASE = "limiter_release"
+    private const val KEY_LIMITER_LOOK_AHEAD = "limiter_look_ahead"
     private const val KEY_PRE_EQUALIZER_ENABLED = "pre_equalizer_enabled"
     private const val KEY_POST_EQUALIZER_ENABLED = "post_equalizer_enabled"
 
@@ -55,6 +58,7 @@ object SettingsManager {
     const val DEFAULT_SOURCE_PITCH_MIN = 33.125f
     const val DEFAULT_SOURCE_PITCH_MAX = 80.875f
     const val DEFAULT_VOICE_ID = 0
+    const val DEFAULT_SILENCE_SKIP_ENABLED = false
 
     // Effector defaults
     const val DEFAULT_AMPLIFIER_ENABLED = true
@@ -75,6 +79,7 @@ object SettingsManager {
     const val DEFAULT_LIMITER_THRESHOLD = -3.0f
     const val DEFAULT_LIMITER_ATTACK = 5.0f
     const val DEFAULT_LIMITER_RELEASE = 50.0f
+    const val DEFAULT_LIMITER_LOOK_AHEAD = 0.0f
     const val DEFAULT_PRE_EQUALIZER_ENABLED = false
     const val DEFAULT_POST_EQUALIZER_ENABLED = false
     const val DEFAULT_EQ_GAIN = 0.0f
@@ -158,6 +163,13 @@ object SettingsManager {
 
     fun loadVoiceId(): Int = prefs.getInt(KEY_VOICE_ID, DEFAULT_VOICE_ID)
 
+    // The TOML of the model last switched to; not a setting, so a reset keeps it.
+    fun saveModelPath(path: String) {
+        prefs.edit().putString(KEY_MODEL_PATH, path).apply()
+    }
+
+    fun loadModelPath(): String = prefs.getString(KEY_MODEL_PATH, null) ?: ""
+
     fun saveMorphingWeights(weights: FloatArray) {
         val serialized = weights.joinToString(";") { String.format(Locale.US, "%.6f", it) }
         prefs.edit().putString(KEY_MORPHING_WEIGHTS, serialized).apply()
@@ -238,6 +250,9 @@ object SettingsManager {
     fun saveCompressorMakeupGain(value: Float) = prefs.edit().putFloat(KEY_COMPRESSOR_MAKEUP_GAIN, value).apply()
     fun loadCompressorMakeupGain(): Float = prefs.getFloat(KEY_COMPRESSOR_MAKEUP_GAIN, DEFAULT_COMPRESSOR_MAKEUP_GAIN)
 
+    fun saveSilenceSkipEnabled(enabled: Boolean) = prefs.edit().putBoolean(KEY_SILENCE_SKIP_ENABLED, enabled).apply()
+    fun loadSilenceSkipEnabled(): Boolean = prefs.getBoolean(KEY_SILENCE_SKIP_ENABLED, DEFAULT_SILENCE_SKIP_ENABLED)
+
     fun saveLimiterEnabled(enabled: Boolean) = prefs.edit().putBoolean(KEY_LIMITER_ENABLED, enabled).apply()
     fun loadLimiterEnabled(): Boolean = prefs.getBoolean(KEY_LIMITER_ENABLED, DEFAULT_LIMITER_ENABLED)
     fun saveLimiterThreshold(value: Float) = prefs.edit().putFloat(KEY_LIMITER_THRESHOLD, value).apply()
@@ -246,6 +261,8 @@ object SettingsManager {
     fun loadLimiterAttack(): Float = prefs.getFloat(KEY_LIMITER_ATTACK, DEFAULT_LIMITER_ATTACK)
     fun saveLimiterRelease(value: Float) = prefs.edit().putFloat(KEY_LIMITER_RELEASE, value).apply()
     fun loadLimiterRelease(): Float = prefs.getFloat(KEY_LIMITER_RELEASE, DEFAULT_LIMITER_RELEASE)
+    fun saveLimiterLookAhead(value: Float) = prefs.edit().putFloat(KEY_LIMITER_LOOK_AHEAD, value).apply()
+    fun loadLimiterLookAhead(): Float = prefs.getFloat(KEY_LIMITER_LOOK_AHEAD, DEFAULT_LIMITER_LOOK_AHEAD)
 
     fun savePreEqualizerEnabled(enabled: Boolean) = prefs.edit().putBoolean(KEY_PRE_EQUALIZER_ENABLED, enabled).apply()
     fun loadPreEqualizerEnabled(): Boolean = prefs.getBoolean(KEY_PRE_EQUALIZER_ENABLED, DEFAULT_PRE_EQUALIZER_ENABLED)
@@ -253,7 +270,9 @@ object SettingsManager {
     fun loadPostEqualizerEnabled(): Boolean = prefs.getBoolean(KEY_POST_EQUALIZER_ENABLED, DEFAULT_POST_EQUALIZER_ENABLED)
 
     fun resetAllToDefaults() {
+        val modelPath = loadModelPath()
         val editor = prefs.edit().clear()
+        editor.putString(KEY_MODEL_PATH, modelPath)
         editor.putFloat(KEY_INPUT_GAIN, DEFAULT_INPUT_GAIN)
         editor.putFloat(KEY_OUTPUT_GAIN, DEFAULT_OUTPUT_GAIN)
         editor.putFloat(KEY_PITCH_SHIFT, DEFAULT_PITCH_SHIFT)
@@ -265,6 +284,7 @@ object SettingsManager {
         editor.putFloat(KEY_SOURCE_PITCH_RANGE_MIN, DEFAULT_SOURCE_PITCH_MIN)
         editor.putFloat(KEY_SOURCE_PITCH_RANGE_MAX, DEFAULT_SOURCE_PITCH_MAX)
         editor.putInt(KEY_VOICE_ID, DEFAULT_VOICE_ID)
+        editor.putBoolean(KEY_SILENCE_SKIP_ENABLED, DEFAULT_SILENCE_SKIP_ENABLED)
         editor.putString(KEY_MORPHING_WEIGHTS, DEFAULT_MORPHING_WEIGHTS.joinToString(";") { it.toString() })
 
         editor.putBoolean(KEY_AMPLIFIER_ENABLED, DEFAULT_AMPLIFIER_ENABLED)
@@ -285,6 +305,7 @@ object SettingsManager {
         editor.putFloat(KEY_LIMITER_THRESHOLD, DEFAULT_LIMITER_THRESHOLD)
         editor.putFloat(KEY_LIMITER_ATTACK, DEFAULT_LIMITER_ATTACK)
         editor.putFloat(KEY_LIMITER_RELEASE, DEFAULT_LIMITER_RELEASE)
+        editor.putFloat(KEY_LIMITER_LOOK_AHEAD, DEFAULT_LIMITER_LOOK_AHEAD)
         editor.putBoolean(KEY_PRE_EQUALIZER_ENABLED, DEFAULT_PRE_EQUALIZER_ENABLED)
         editor.putBoolean(KEY_POST_EQUALIZER_ENABLED, DEFAULT_POST_EQUALIZER_ENABLED)
 
@@ -18,6 +18,23 @@ import com.google.oboe.samples.audio_device.AudioDeviceSpinner
 
 class SystemFragment : Fragment() {
 
+    companion object {
+        private val BLOCK_SIZE_BUTTONS = mapOf(
+            R.id.blockSizeAutoButton to 0,
+            R.id.blockSize160Button to 160,
+            R.id.blockSize240Button to 240,
+            R.id.blockSize480Button to 480,
+            R.id.blockSize960Button to 960
+        )
+        private val BUFFER_COUNT_BUTTONS = mapOf(
+            R.id.bufferCountAutoButton to 0,
+            R.id.bufferCount2Button to 2,
+            R.id.bufferCount3Button to 3,
+            R.id.bufferCount4Button to 4,
+            R.id.bufferCount8Button to 8
+        )
+    }
+
     private lateinit var viewModel: EngineStateViewModel
     private lateinit var recordingDeviceSpinner: AudioDeviceSpinner
     private lateinit var playbackDeviceSpinner: AudioDeviceSpinner
@@ -100,6 +117,26 @@ class SystemFragment : Fragment() {
             viewModel.performanceMode.value = 2
         }
 
+        // Processing block size
+        val blockSizeGroup = view.findViewById<RadioGroup>(R.id.blockSizeSelectionGroup)
+        blockSizeGroup.check(
+            BLOCK_SIZE_BUTTONS.entries.firstOrNull { it.value == (viewModel.blockSize.value ?: 0) }?.key
+                ?: R.id.blockSizeAutoButton
+        )
+        blockSizeGroup.setOnCheckedChangeListener { _, checkedId ->
+            viewModel.blockSize.value = BLOCK_SIZE_BUTTONS[checkedId] ?: 0
+        }
+
+        // Buffering depth; the engine raises it to the minimum the mode needs
+        val bufferCountGroup = view.findViewById<RadioGroup>(R.id.bufferCountSelectionGroup)
+        bufferCountGroup.check(
+            BUFFER_COUNT_BUTTONS.entries.firstOrNull { it.value == (viewModel.bufferCount.value ?: 0) }?.key
+                ?: R.id.bufferCountAutoButton
+        )
+        bufferCountGroup.setOnCheckedChangeListener { _, checkedId ->
+            viewModel.bufferCount.value = BUFFER_COUNT_BUTTONS[checkedId] ?: 0
+        }
+
         // Async processing
         val asyncCheckbox = view.findViewById<CheckBox>(R.id.asyncProcessingCheckbox)
         asyncCheckbox.isChecked = viewModel.isAsyncMode.value ?: true
@@ -122,6 +159,14 @@ class SystemFragment : Fragment() {
             beatriceEngine.setVoiceCommunicationMode(isChecked)
         }
 
+        // Silence skip; takes effect immediately, also while running
+        val silenceSkipCheckbox = view.findViewById<CheckBox>(R.id.silenceSkipCheckbox)
+        silenceSkipCheckbox.isChecked = SettingsManager.loadSilenceSkipEnabled()
+        silenceSkipCheckbox.setOnCheckedChangeListener { _, isChecked ->
+            SettingsManager.saveSilenceSkipEnabled(isChecked)
+            beatriceEngine.setSilenceSkipEnabled(isChecked)
+        }
+
         // Observe running state — disable settings while engine is active
         viewModel.isEngineRunning.observe(viewLifecycleOwner) { running ->
             setAllSettingsEnabled(!running)
@@ -151,6 +196,9 @@ class SystemFragment : Fragment() {
         )
 
         view.findViewById<CheckBox>(R.id.voiceCommunicationCheckbox).isEnabled = enabled
+        for (buttonId in BLOCK_SIZE_BUTTONS.keys + BUFFER_COUNT_BUTTONS.keys) {
+            view.findViewById<RadioButton>(buttonId).isEnabled = enabled
+        }
 
         updateLatencyAndAsync(
             enabled = enabled && isAAudio,
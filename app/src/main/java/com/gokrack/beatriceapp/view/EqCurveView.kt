@@ -8,6 +8,7 @@ import android.util.AttributeSet
 import android.view.View
 import androidx.core.content.ContextCompat
 import com.gokrack.beatriceapp.R
+import java.nio.FloatBuffer
 import kotlin.math.log10
 import kotlin.math.max
 import kotlin.math.min
@@ -51,13 +52,15 @@ class EqCurveView @JvmOverloads constructor(
         style = Paint.Style.FILL
     }
 
-    private var frequencies: DoubleArray = doubleArrayOf()
-    private var magnitudes: DoubleArray = doubleArrayOf()
+    private var frequencies: FloatBuffer = FloatBuffer.allocate(0)
+    private var magnitudes: FloatBuffer = FloatBuffer.allocate(0)
     private val path = Path()
     private val fillPath = Path()
 
-    fun setData(frequencies: DoubleArray, magnitudes: DoubleArray) {
-        if (frequencies.size == magnitudes.size) {
+    // The buffers are kept and read on every draw; call again after refilling
+    // them to redraw.
+    fun setData(frequencies: FloatBuffer, magnitudes: FloatBuffer) {
+        if (frequencies.capacity() == magnitudes.capacity()) {
             this.frequencies = frequencies
             this.magnitudes = magnitudes
             invalidate()
@@ -98,7 +101,7 @@ class EqCurveView @JvmOverloads constructor(
             db += 6f
         }
 
-        if (frequencies.isEmpty() || magnitudes.isEmpty()) {
+        if (frequencies.capacity() == 0) {
             return
         }
 
@@ -108,9 +111,9 @@ class EqCurveView @JvmOverloads constructor(
         var first = true
         val zeroY = chartBottom - chartHeight * ((0.0 - MIN_DB) / (MAX_DB - MIN_DB)).toFloat()
 
-        for (i in frequencies.indices) {
-            val freq = frequencies[i]
-            val db = magnitudes[i]
+        for (i in 0 until frequencies.capacity()) {
+            val freq = frequencies.get(i).toDouble()
+            val db = magnitudes.get(i).toDouble()
             if (freq <= 0) continue
             val x = chartLeft + chartWidth * ((log10(freq) - log10(MIN_HZ)) / (log10(MAX_HZ) - log10(MIN_HZ))).toFloat()
             val clampedDb = max(MIN_DB, min(MAX_DB, db))